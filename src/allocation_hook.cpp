@@ -0,0 +1,55 @@
+/** ALLOCATION_HOOK.cpp
+ * Global operator new and delete over malloc and free, with optional counters
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <atomic>   // atomic
+#include <cstdlib>  // malloc, free
+#include <new>      // bad_alloc, nothrow_t
+
+// Dependencies from this package
+#include "allocation_hook.h"  // Allocation Hook headers
+
+
+static std::atomic<bool> counting(false);
+static std::atomic<long long> num_allocations(0), num_allocated_bytes(0);
+
+void allocation_counting(const bool enabled) {counting.store(enabled, std::memory_order_relaxed);}
+
+AllocationCounts allocation_counts() {
+    return {num_allocations.load(std::memory_order_relaxed), num_allocated_bytes.load(std::memory_order_relaxed)};
+}
+
+
+/* ALLOCATION
+ * Every form allocates here, so each pointer is released by the free of the matching delete
+ */
+static void *allocate(const size_t size) noexcept {
+    if (counting.load(std::memory_order_relaxed)) {
+        num_allocations.fetch_add(1, std::memory_order_relaxed);
+        num_allocated_bytes.fetch_add((long long)size, std::memory_order_relaxed);
+    }
+    return std::malloc((size > 0) ? size : 1);
+}
+
+void *operator new(size_t size) {
+    void *pointer = allocate(size);
+    if (pointer == nullptr) {throw std::bad_alloc();}
+    return pointer;
+}
+void *operator new[](size_t size) {
+    void *pointer = allocate(size);
+    if (pointer == nullptr) {throw std::bad_alloc();}
+    return pointer;
+}
+void *operator new(size_t size, const std::nothrow_t &) noexcept {return allocate(size);}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {return allocate(size);}
+
+void operator delete(void *pointer) noexcept {std::free(pointer);}
+void operator delete[](void *pointer) noexcept {std::free(pointer);}
+void operator delete(void *pointer, size_t) noexcept {std::free(pointer);}
+void operator delete[](void *pointer, size_t) noexcept {std::free(pointer);}
+void operator delete(void *pointer, const std::nothrow_t &) noexcept {std::free(pointer);}
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept {std::free(pointer);}
@@ -0,0 +1,23 @@
+/** ALLOCATION_HOOK.h
+ * Replacement of the global operator new and delete that counts the allocations of the process
+ * Jose F. R. Fonseca
+ */
+
+
+#ifndef ALLOCATION_HOOK_H
+#define ALLOCATION_HOOK_H
+
+
+/* ALLOCATION HOOK
+ * Linked ONLY into the binaries that report allocations (listed among their sources, not in the KCMC_Module), as it
+ *   replaces the operator new and delete family of the whole process (arrays and nothrow forms included).
+ * Counting is off until enabled: meanwhile, each allocation only adds a relaxed load of the flag to malloc
+ */
+struct AllocationCounts {
+    long long allocations, bytes;
+};
+
+void allocation_counting(bool enabled);
+AllocationCounts allocation_counts();
+
+#endif
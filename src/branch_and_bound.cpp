@@ -0,0 +1,281 @@
+/** BRANCH_AND_BOUND.cpp
+ * Exact solver of the KCMC problem: minimal set of sensors with K-coverage and M-connectivity
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <deque>      // deque
+#include <thread>     // thread, yield
+#include <chrono>     // steady_clock
+#include <algorithm>  // sort, find
+
+// Dependencies from this package
+#include "branch_and_bound.h"  // KCMC Branch-and-Bound headers
+#include "presolve.h"          // KCMC Presolve
+#include "genetic_algorithm_operators.h"  // exit_requested
+
+
+/** BRANCH-AND-BOUND CONSTRUCTOR
+ * Prepares the CSR graph, the lower bounds of the instance and the POIs covered by each sensor.
+ * The presolve fixes the root state: useless sensors are excluded, forced ones installed.
+ */
+KCMC_BranchAndBound::KCMC_BranchAndBound(KCMC_Instance *instance, const int k, const int m) : best(instance->num_sensors+1) {
+    this->instance = instance;
+    this->graph = new KCMC_Graph(instance);
+    this->k = k;
+    this->m = m;
+    lower_bounds(this->graph, k, m, &(this->bounds));
+    this->root_bound = 0;
+    this->num_nodes = 0;
+    this->optimal = false;
+    this->infeasible = false;
+    this->incumbent.assign((size_t)instance->num_sensors, 1);
+    this->incumbent_source = "none";
+
+    this->covered.resize((size_t)instance->num_sensors);
+    for (int a_poi=0; a_poi<instance->num_pois; a_poi++) {
+        for (int i=this->graph->poi_sensor.offsets[a_poi]; i<this->graph->poi_sensor.offsets[a_poi+1]; i++) {
+            this->covered[this->graph->poi_sensor.targets[i]].push_back(a_poi);
+        }
+    }
+
+    KCMC_Presolve presolve(instance, k, m, false);
+    this->fixed.assign((size_t)instance->num_sensors, UNDECIDED);
+    for (const int &a_sensor : presolve.removed_sensors) {this->fixed[a_sensor] = EXCLUDED;}
+    for (const int &a_sensor : presolve.forced_sensors) {this->fixed[a_sensor] = INSTALLED;}
+}
+
+KCMC_BranchAndBound::~KCMC_BranchAndBound() {delete this->graph;}
+
+
+/* #####################################################################################################################
+ * INCUMBENTS AND VALIDATION
+ */
+
+
+bool KCMC_BranchAndBound::feasible(const std::vector<char> &installed) const {
+    std::vector<std::vector<int>> paths;
+    for (int a_poi=0; a_poi<this->graph->num_pois; a_poi++) {
+        if (this->graph->coverage(a_poi, installed) < this->k) {return false;}
+        paths.clear();
+        if (this->graph->disjoint_paths(a_poi, this->m, installed, &paths) < this->m) {return false;}
+    }
+    return true;
+}
+
+int KCMC_BranchAndBound::incumbent_size() const {return this->best.load();}
+
+
+bool KCMC_BranchAndBound::add_incumbent(std::unordered_set<int> &solution, const std::string &source) {
+    std::vector<char> installed((size_t)this->graph->num_sensors, 0);
+    for (const int &a_sensor : solution) {installed[a_sensor] = 1;}
+    if ((not this->feasible(installed)) or ((int)(solution.size()) >= this->best.load())) {return false;}
+
+    std::lock_guard<std::mutex> guard(this->incumbent_lock);
+    this->best = (int)(solution.size());
+    this->incumbent = installed;
+    this->incumbent_source = source;
+    return true;
+}
+
+
+void KCMC_BranchAndBound::update(const std::vector<char> &state, const int size) {
+    std::lock_guard<std::mutex> guard(this->incumbent_lock);
+    if (size >= this->best.load()) {return;}
+    this->best = size;
+    for (size_t i=0; i<state.size(); i++) {this->incumbent[i] = (char)(state[i] == INSTALLED);}
+    this->incumbent_source = "bnb";
+}
+
+
+/* #####################################################################################################################
+ * NODES
+ */
+
+
+/** ROOT NODE
+ * The presolved state, with the paths of each POI among every non-excluded sensor. False if the instance is infeasible
+ */
+bool KCMC_BranchAndBound::root(BnBNode *node) {
+    node->state = this->fixed;
+    node->num_installed = (int)std::count(node->state.begin(), node->state.end(), INSTALLED);
+    node->paths.assign((size_t)this->graph->num_pois, std::vector<std::vector<int>>());
+    std::vector<char> allowed(node->state.size());
+    for (size_t i=0; i<allowed.size(); i++) {allowed[i] = (char)(node->state[i] != EXCLUDED);}
+    for (int a_poi=0; a_poi<this->graph->num_pois; a_poi++) {
+        if (this->graph->coverage(a_poi, allowed) < this->k) {return false;}
+        if (this->graph->disjoint_paths(a_poi, this->m, allowed, &(node->paths[a_poi])) < this->m) {return false;}
+    }
+    return true;
+}
+
+
+/** BRANCHING SENSOR
+ * The undecided sensor in the most paths of the node, or covering the most POIs lacking coverage. -1 if none
+ */
+int KCMC_BranchAndBound::branching_sensor(const BnBNode &node) const {
+    const KCMC_Graph *g = this->graph;
+    std::vector<int> score(node.state.size(), 0);
+    int a_poi, i, installed;
+
+    for (a_poi=0; a_poi<g->num_pois; a_poi++) {
+        for (const auto &path : node.paths[a_poi]) {
+            for (const int &a_sensor : path) {if (node.state[a_sensor] == UNDECIDED) {score[a_sensor]++;}}
+        }
+        installed = 0;
+        for (i=g->poi_sensor.offsets[a_poi]; i<g->poi_sensor.offsets[a_poi+1]; i++) {
+            if (node.state[g->poi_sensor.targets[i]] == INSTALLED) {installed++;}
+        }
+        if (installed >= this->k) {continue;}
+        for (i=g->poi_sensor.offsets[a_poi]; i<g->poi_sensor.offsets[a_poi+1]; i++) {
+            if (node.state[g->poi_sensor.targets[i]] == UNDECIDED) {score[g->poi_sensor.targets[i]]++;}
+        }
+    }
+
+    int chosen = -1;
+    for (i=0; i<(int)(score.size()); i++) {
+        if ((score[i] > 0) and ((chosen == -1) or (score[i] > score[chosen]))) {chosen = i;}
+    }
+    return chosen;
+}
+
+
+/** EXCLUSION (INCREMENTAL VALIDATION)
+ * Excludes the sensor. Only POIs covered by it may lose coverage, and only POIs with it in a path are repaired.
+ * False if the node has no feasible completion anymore
+ */
+bool KCMC_BranchAndBound::exclude(BnBNode *node, const int sensor) const {
+    node->state[sensor] = EXCLUDED;
+    std::vector<char> allowed(node->state.size());
+    for (size_t i=0; i<allowed.size(); i++) {allowed[i] = (char)(node->state[i] != EXCLUDED);}
+
+    for (const int &a_poi : this->covered[sensor]) {
+        if (this->graph->coverage(a_poi, allowed) < this->k) {return false;}
+    }
+    for (int a_poi=0; a_poi<this->graph->num_pois; a_poi++) {
+        auto &paths = node->paths[a_poi];
+        size_t before = paths.size();
+        paths.erase(std::remove_if(paths.begin(), paths.end(), [sensor](const std::vector<int> &path) {
+            return std::find(path.begin(), path.end(), sensor) != path.end();
+        }), paths.end());
+        if (paths.size() == before) {continue;}
+        if (this->graph->disjoint_paths(a_poi, this->m, allowed, &paths) < this->m) {return false;}
+    }
+    return true;
+}
+
+
+/** NODE PROCESSING
+ * Prunes by bound, takes the installed sensors as incumbent if they are feasible, or branches (excluded, installed)
+ */
+void KCMC_BranchAndBound::process(BnBNode &node, std::vector<BnBNode> *children) {
+    children->clear();
+    if (node.num_installed + packing_bound(this->graph, this->k, this->m, node.state) >= this->best.load()) {return;}
+
+    // Are the installed sensors already a solution?
+    std::vector<char> installed(node.state.size());
+    for (size_t i=0; i<installed.size(); i++) {installed[i] = (char)(node.state[i] == INSTALLED);}
+    bool solution = true;
+    std::vector<std::vector<int>> paths;
+    for (int a_poi=0; (a_poi<this->graph->num_pois) and solution; a_poi++) {
+        if (this->graph->coverage(a_poi, installed) < this->k) {solution = false; break;}
+        paths.clear();
+        for (const auto &path : node.paths[a_poi]) {
+            bool all_installed = true;
+            for (const int &a_sensor : path) {if (not installed[a_sensor]) {all_installed = false; break;}}
+            if (all_installed) {paths.push_back(path);}
+        }
+        solution = (this->graph->disjoint_paths(a_poi, this->m, installed, &paths) >= this->m);
+    }
+    if (solution) {this->update(node.state, node.num_installed); return;}
+
+    int sensor = this->branching_sensor(node);
+    if (sensor == -1) {return;}
+
+    // Excluded child first, so the installed child is the next in the depth-first search
+    children->push_back(node);
+    if (not this->exclude(&(children->back()), sensor)) {children->pop_back();}
+    node.state[sensor] = INSTALLED;
+    node.num_installed++;
+    children->push_back(std::move(node));
+}
+
+
+/* #####################################################################################################################
+ * PARALLEL SEARCH
+ */
+
+
+bool KCMC_BranchAndBound::solve(const double time_limit, int num_threads) {
+    BnBNode root_node;
+    if (not this->root(&root_node)) {
+        this->infeasible = true;
+        this->optimal = true;
+        return true;
+    }
+    this->root_bound = root_node.num_installed + packing_bound(this->graph, this->k, this->m, root_node.state);
+    if (this->bounds.best > this->root_bound) {this->root_bound = this->bounds.best;}
+    if (this->best.load() <= this->root_bound) {this->optimal = true; return true;}
+
+    // Work-stealing deques
+    if (num_threads < 1) {num_threads = (int)(std::thread::hardware_concurrency());}
+    if (num_threads < 1) {num_threads = 1;}
+    std::vector<std::deque<BnBNode>> deques((size_t)num_threads);
+    std::vector<std::mutex> locks((size_t)num_threads);
+    std::atomic<int> busy(0);
+    std::atomic<bool> stop(false);
+    std::atomic<long long> nodes(0);
+    deques[0].push_back(std::move(root_node));
+    auto start = std::chrono::steady_clock::now();
+
+    auto worker = [&](const int id) {
+        BnBNode node;
+        std::vector<BnBNode> children;
+        while (not stop.load()) {
+            // Take the deepest node of the own deque, or steal the shallowest of another
+            bool got = false;
+            for (int offset=0; (offset<num_threads) and (not got); offset++) {
+                const int other = (id + offset) % num_threads;
+                std::lock_guard<std::mutex> guard(locks[other]);
+                if (deques[other].empty()) {continue;}
+                busy++;
+                if (offset == 0) {node = std::move(deques[other].back()); deques[other].pop_back();}
+                else {node = std::move(deques[other].front()); deques[other].pop_front();}
+                got = true;
+            }
+            if (not got) {
+                if (busy.load() > 0) {std::this_thread::yield(); continue;}
+                bool empty = true;
+                for (int other=0; (other<num_threads) and empty; other++) {
+                    std::lock_guard<std::mutex> guard(locks[other]);
+                    empty = deques[other].empty();
+                }
+                if (empty) {return;}
+                continue;
+            }
+
+            this->process(node, &children);
+            nodes++;
+            {
+                std::lock_guard<std::mutex> guard(locks[id]);
+                for (auto &child : children) {deques[id].push_back(std::move(child));}
+            }
+            busy--;
+
+            if ((nodes.load() % 64) == 0) {
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                if (((time_limit > 0) and (elapsed.count() > time_limit)) or exit_requested()) {stop = true;}
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int id=1; id<num_threads; id++) {threads.emplace_back(worker, id);}
+    worker(0);
+    for (auto &a_thread : threads) {a_thread.join();}
+
+    this->num_nodes = nodes.load();
+    this->optimal = not stop.load();
+    return this->optimal;
+}
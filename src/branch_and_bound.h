@@ -0,0 +1,85 @@
+/** BRANCH_AND_BOUND.h
+ * Exact solver of the KCMC problem: minimal set of sensors with K-coverage and M-connectivity
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <mutex>    // mutex
+#include <atomic>   // atomic
+#include <vector>   // vector
+#include <string>   // string
+
+// Dependencies from this package
+#include "kcmc_instance.h"  // KCMC Instance class headers
+#include "kcmc_graph.h"     // KCMC Graph (CSR) headers
+#include "lower_bounds.h"   // KCMC Lower Bounds (and states of the sensors)
+
+
+#ifndef BRANCH_AND_BOUND_H
+#define BRANCH_AND_BOUND_H
+
+/* BRANCH-AND-BOUND NODE
+ * State of each sensor (UNDECIDED, INSTALLED or EXCLUDED), and M disjoint paths of each POI among the non-excluded
+ *   sensors. Those paths prove the node has a feasible completion, and are repaired when a sensor is excluded.
+ */
+struct BnBNode {
+    std::vector<char> state;
+    std::vector<std::vector<std::vector<int>>> paths;
+    int num_installed;
+};
+
+
+/** KCMC Branch-and-Bound Object
+ * Binary branching on the sensors (installed first, diving towards solutions), with:
+ * - Incumbents from the heuristics (add_incumbent) and from the nodes whose installed sensors are already feasible
+ * - Presolve fixing at the root (useless sensors excluded, forced sensors installed)
+ * - Hitting-set (packing) lower bound at each node, and the bounds of lower_bounds at the root
+ * - Incremental validation: excluding a sensor only repairs the paths of the POIs that used it
+ * - Parallel depth-first search: each thread works on its own deque of nodes, and steals the shallowest nodes of
+ *     the others when its deque is empty
+ * Connectivity is EXACT (maximum flow), so solutions may be valid even if the greedy validator of KCMC_Instance
+ *   fails to find all their paths.
+ */
+class KCMC_BranchAndBound {
+
+    public:
+        int k, m, root_bound;
+        long long num_nodes;
+        bool optimal, infeasible;
+        std::vector<char> incumbent;  // 1 for the installed sensors of the best solution
+        std::string incumbent_source;
+
+        KCMC_BranchAndBound(KCMC_Instance *instance, int k, int m);
+        ~KCMC_BranchAndBound();
+
+        /* Incumbents and validation
+         * Add a solution (installed sensors) as the incumbent, if valid and better. Returns if it was added
+         * Validate a set of installed sensors with exact connectivity
+         */
+        bool add_incumbent(std::unordered_set<int> &solution, const std::string &source);
+        bool feasible(const std::vector<char> &installed) const;
+        int incumbent_size() const;
+
+        /* Search
+         * Returns if the optimum was proven, within the time limit in seconds (0 for none)
+         */
+        bool solve(double time_limit, int num_threads);
+
+    private:
+        KCMC_Instance *instance;
+        KCMC_Graph *graph;
+        KCMC_Bounds bounds;  // Lower bounds of the whole instance
+        std::vector<std::vector<int>> covered;  // POIs covered by each sensor
+        std::vector<char> fixed;  // Root state, from the presolve
+        std::atomic<int> best;
+        std::mutex incumbent_lock;
+
+        bool root(BnBNode *node);
+        int branching_sensor(const BnBNode &node) const;
+        bool exclude(BnBNode *node, int sensor) const;
+        void process(BnBNode &node, std::vector<BnBNode> *children);
+        void update(const std::vector<char> &state, int size);
+};
+
+#endif
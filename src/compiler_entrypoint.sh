@@ -7,6 +7,9 @@ cmake --build .
 # COPY THE OUTPUT EXECUTABLES TO THE BUILDS DIRECTORY
 cp instance_generator /app/builds
 cp instance_evaluator /app/builds
+cp ilp_exporter /app/builds
+cp optimizer_bnb /app/builds
 cp placements_visualizer /app/builds
 cp optimizer* /app/builds
+cp libkcmc.so /app/builds
 chmod +x /app/builds/*
\ No newline at end of file
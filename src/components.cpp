@@ -0,0 +1,178 @@
+/** COMPONENTS.cpp
+ * Union-find of the sensors, stranded POIs and the parallel solution of the independent groups
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <algorithm>      // sort, unique
+#include <numeric>        // iota
+#include <sstream>        // ostringstream
+#include <stdexcept>      // runtime_error
+#include <unordered_map>  // unordered_map
+
+// Dependencies from this package
+#include "components.h"  // KCMC Components headers
+
+
+/* UNION-FIND
+ * Roots by path halving. The smallest index is the root of a union
+ */
+static int find_root(std::vector<int> &parent, int item) {
+    while (parent[item] != item) {
+        parent[item] = parent[parent[item]];
+        item = parent[item];
+    }
+    return item;
+}
+
+static void join(std::vector<int> &parent, const int a, const int b) {
+    const int root_a = find_root(parent, a), root_b = find_root(parent, b);
+    if (root_a < root_b) {parent[root_b] = root_a;}
+    else if (root_b < root_a) {parent[root_a] = root_b;}
+}
+
+
+/** COMPONENTS CONSTRUCTOR
+ * Items of the union-find are the sensors, then the sinks, then the POIs. Sub-instances are built in parallel, and only
+ *   their live sensors (the first ones) keep their sensor-sensor and sensor-sink edges
+ */
+KCMC_Components::KCMC_Components(KCMC_Instance *instance, KCMC_Graph *graph) {
+    this->graph = graph;
+    const KCMC_Graph &g = *graph;
+    const int first_sink = g.num_sensors, first_poi = g.num_sensors + g.num_sinks;
+    std::vector<int> parent((size_t)(first_poi + g.num_pois));
+    std::iota(parent.begin(), parent.end(), 0);
+
+    // Components of the sensors and sinks, their sizes, and the dead sensors
+    for (int a_sensor=0; a_sensor<g.num_sensors; a_sensor++) {
+        for (int i=g.sensor_sensor.offsets[a_sensor]; i<g.sensor_sensor.offsets[a_sensor+1]; i++) {
+            join(parent, a_sensor, g.sensor_sensor.targets[i]);
+        }
+        for (int i=g.sensor_sink.offsets[a_sensor]; i<g.sensor_sink.offsets[a_sensor+1]; i++) {
+            join(parent, a_sensor, first_sink + g.sensor_sink.targets[i]);
+        }
+    }
+    std::vector<char> has_sink(parent.size(), 0);
+    std::vector<int> size(parent.size(), 0);
+    for (int a_sink=0; a_sink<g.num_sinks; a_sink++) {has_sink[find_root(parent, first_sink + a_sink)] = 1;}
+    for (int a_sensor=0; a_sensor<g.num_sensors; a_sensor++) {size[find_root(parent, a_sensor)]++;}
+
+    this->num_dead_components = 0;
+    this->component_size.resize((size_t)g.num_sensors);
+    std::vector<char> live((size_t)g.num_sensors, 0);
+    for (int a_sensor=0; a_sensor<g.num_sensors; a_sensor++) {
+        const int root = find_root(parent, a_sensor);
+        this->component_size[a_sensor] = size[root];
+        live[a_sensor] = has_sink[root];
+        if (not live[a_sensor]) {this->dead_sensors.insert(a_sensor);}
+        if ((root == a_sensor) and (not has_sink[root])) {this->num_dead_components++;}
+    }
+
+    // Groups: live components joined by the POIs they cover
+    for (int poi=0; poi<g.num_pois; poi++) {
+        bool stranded = true;
+        for (int i=g.poi_sensor.offsets[poi]; i<g.poi_sensor.offsets[poi+1]; i++) {
+            if (live[g.poi_sensor.targets[i]]) {join(parent, first_poi + poi, g.poi_sensor.targets[i]); stranded = false;}
+        }
+        if (stranded) {this->stranded_pois.push_back(poi);}
+    }
+    std::unordered_map<int, int> group_of_root;
+    this->group.assign((size_t)g.num_sensors, -1);
+    for (int a_sensor=0; a_sensor<g.num_sensors; a_sensor++) {
+        if (not live[a_sensor]) {continue;}
+        auto inserted = group_of_root.emplace(find_root(parent, a_sensor), (int)(group_of_root.size()));
+        this->group[a_sensor] = inserted.first->second;
+    }
+    this->num_groups = (int)(group_of_root.size());
+
+    // POIs, sensors (live, then the dead covering its POIs) and sinks of each group
+    std::vector<std::vector<int>> group_pois((size_t)this->num_groups), group_sinks((size_t)this->num_groups);
+    this->sensor_maps.assign((size_t)this->num_groups, std::vector<int>());
+    for (int a_sensor=0; a_sensor<g.num_sensors; a_sensor++) {
+        if (live[a_sensor]) {this->sensor_maps[this->group[a_sensor]].push_back(a_sensor);}
+    }
+    for (int a_sink=0; a_sink<g.num_sinks; a_sink++) {
+        auto found = group_of_root.find(find_root(parent, first_sink + a_sink));
+        if (found != group_of_root.end()) {group_sinks[found->second].push_back(a_sink);}
+    }
+    std::vector<std::vector<int>> dead_members((size_t)this->num_groups);
+    for (int poi=0; poi<g.num_pois; poi++) {
+        auto found = group_of_root.find(find_root(parent, first_poi + poi));
+        if (found == group_of_root.end()) {continue;}  // Stranded
+        group_pois[found->second].push_back(poi);
+        for (int i=g.poi_sensor.offsets[poi]; i<g.poi_sensor.offsets[poi+1]; i++) {
+            if (not live[g.poi_sensor.targets[i]]) {dead_members[found->second].push_back(g.poi_sensor.targets[i]);}
+        }
+    }
+    std::vector<int> num_live((size_t)this->num_groups);
+    for (int a_group=0; a_group<this->num_groups; a_group++) {
+        num_live[a_group] = (int)(this->sensor_maps[a_group].size());
+        auto &dead = dead_members[a_group];
+        std::sort(dead.begin(), dead.end());
+        dead.erase(std::unique(dead.begin(), dead.end()), dead.end());
+        this->sensor_maps[a_group].insert(this->sensor_maps[a_group].end(), dead.begin(), dead.end());
+    }
+
+    // A single group without dead sensors is the instance itself
+    this->groups.assign((size_t)this->num_groups, nullptr);
+    this->owns_groups = not ((this->num_groups == 1) and this->dead_sensors.empty() and this->stranded_pois.empty()
+                             and (group_sinks[0].size() == (size_t)g.num_sinks));
+    if (not this->owns_groups) {this->groups[0] = instance; return;}
+    parallel_chunks(this->num_groups, [&](const int begin, const int end) {
+        for (int a_group=begin; a_group<end; a_group++) {
+            this->groups[a_group] = instance->subinstance(group_pois[a_group], this->sensor_maps[a_group],
+                                                          group_sinks[a_group], num_live[a_group], {});
+        }
+    });
+}
+
+KCMC_Components::~KCMC_Components() {
+    if (not this->owns_groups) {return;}
+    for (KCMC_Instance *a_group : this->groups) {delete a_group;}
+}
+
+
+/** REPORT
+ * Formats the stranded POIs as a line for each one, with the size of the component of each covering sensor
+ */
+std::string KCMC_Components::report() const {
+    std::ostringstream out;
+    for (const int &poi : this->stranded_pois) {
+        out << "POI " << poi << " STRANDED,";
+        if (this->graph->poi_sensor.offsets[poi] == this->graph->poi_sensor.offsets[poi+1]) {out << " COVERED BY NO SENSOR";}
+        for (int i=this->graph->poi_sensor.offsets[poi]; i<this->graph->poi_sensor.offsets[poi+1]; i++) {
+            const int a_sensor = this->graph->poi_sensor.targets[i];
+            out << " SENSOR " << a_sensor << " (COMPONENT OF " << this->component_size[a_sensor] << " SENSORS, NO SINK)";
+        }
+        out << std::endl;
+    }
+    if (not this->stranded_pois.empty()) {out << "STRANDED POIS " << this->stranded_pois.size() << " OF " << this->graph->num_pois;}
+    return out.str();
+}
+
+
+/** HEURISTIC
+ * Each group runs in a single thread, and only writes its own solution
+ */
+int KCMC_Components::heuristic(const std::string &name, const int k, const int m, std::unordered_set<int> *used_sensors) {
+    if (not this->stranded_pois.empty()) {throw std::runtime_error("INVALID INSTANCE! (STRANDED POIS)");}
+    std::vector<std::unordered_set<int>> solutions(this->groups.size());
+    std::vector<int> results(this->groups.size(), 0);
+    parallel_chunks((int)(this->groups.size()), [&](const int begin, const int end) {
+        std::unordered_set<int> emptyset;
+        for (int a_group=begin; a_group<end; a_group++) {
+            KCMC_TRACE("component", "group", a_group);
+            try {results[a_group] = this->groups[a_group]->heuristic(name, k, m, emptyset, &solutions[a_group]);}
+            catch (const std::exception &exc) {solutions[a_group].clear();}
+        }
+    });
+
+    int result = 0;
+    used_sensors->clear();
+    for (size_t a_group=0; a_group<this->groups.size(); a_group++) {
+        result += results[a_group];
+        for (const int &a_sensor : solutions[a_group]) {used_sensors->insert(this->sensor_maps[a_group][a_sensor]);}
+    }
+    return result;
+}
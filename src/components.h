@@ -0,0 +1,63 @@
+/** COMPONENTS.h
+ * Connected components of the sensors of a KCMC instance, and the independent sub-instances they split it in
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <string>         // string
+#include <vector>         // vector object
+#include <unordered_set>  // unordered_set object
+
+// Dependencies from this package
+#include "kcmc_instance.h"  // KCMC Instance class headers
+#include "kcmc_graph.h"     // Adjacencies of the union-find
+
+
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+
+/** KCMC Components Object
+ * Union-find over the sensor-sensor and sensor-sink edges. Sensors in a component without a sink (DEAD sensors) lie
+ *   on no path, and a POI covered only by dead sensors (STRANDED) has no path at all: the instance is infeasible.
+ * Components with sinks are then joined by the POIs their sensors cover. Each resulting GROUP is independent of the
+ *   others (no shared POI, sensor or sink), and is solved as its own sub-instance: its POIs, sinks and live sensors,
+ *   and the dead sensors covering its POIs, without any edge but coverage (they count for K, and path searches stop
+ *   at them). Dead sensors covering no POI of a group are dropped.
+ */
+class KCMC_Components {
+
+    public:
+        /* Components
+         * Number of groups, and group of each sensor (-1 for dead sensors)
+         * Number of components without sinks, their dead sensors, and the stranded POIs
+         */
+        int num_groups, num_dead_components;
+        std::vector<int> group;
+        std::unordered_set<int> dead_sensors;
+        std::vector<int> stranded_pois;
+
+        KCMC_Components(KCMC_Instance *instance, KCMC_Graph *graph);
+        ~KCMC_Components();
+
+        /* Report
+         * One line per stranded POI: its covering sensors and the sizes of their components. Empty if there are none
+         */
+        std::string report() const;
+
+        /* Heuristic
+         * Runs the heuristic (by its name, as in KCMC_Instance) on every group in parallel, and returns the sum of their
+         *   results. Groups where the heuristic fails contribute no sensors. Throws if there are stranded POIs
+         */
+        int heuristic(const std::string &name, int k, int m, std::unordered_set<int> *used_sensors);
+
+    private:
+        KCMC_Graph *graph;
+        bool owns_groups;                           // False if the only group is the instance
+        std::vector<int> component_size;            // Sensors of the component of each sensor
+        std::vector<KCMC_Instance*> groups;          // Sub-instance of each group
+        std::vector<std::vector<int>> sensor_maps;  // Sensor i of group g is sensor sensor_maps[g][i] of the instance
+};
+
+#endif
@@ -0,0 +1,141 @@
+/** DEFICIENCY_REPORT.cpp
+ * Full-failure diagnostics of KCMC instances: every POI lacking K-coverage or M-connectivity, in a single pass
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <sstream>    // ostringstream
+#include <mutex>      // mutex, lock_guard
+#include <algorithm>  // fill, sort
+
+// Dependencies from this package
+#include "kcmc_instance.h"  // KCMC Instance class headers
+
+
+/** DEFICIENCY REPORT
+ * Differently from the validators, that return at the first failure, evaluates each and every POI.
+ * For each POI, counts the active covering sensors and the disjoint paths to a sink (stopping at M, using the same
+ *   Dinic-like search of the M-connectivity validator). POIs with coverage < K or connectivity < M are reported.
+ * The level graph is computed once, then the POIs are evaluated in parallel, each thread with its own buffers.
+ * Returns the number of deficient POIs. The report is sorted by POI.
+ */
+int KCMC_Instance::deficiency_report(const int k, const int m, std::unordered_set<int> &inactive_sensors,
+                                     std::vector<POIDeficit> *report) {
+    report->clear();
+
+    // Create the level graph, shared (read-only) by all threads
+    std::vector<int> level_graph((size_t)this->num_sensors, 0);
+    if (m > 0) {this->level_graph(level_graph.data(), inactive_sensors);}
+
+    // Evaluate each chunk of POIs in a thread
+    std::mutex report_lock;
+    parallel_chunks(this->num_pois, [&](const int begin, const int end) {
+
+        // Thread-local buffers
+        int a_poi, coverage, paths_found, path_end;
+        std::vector<int> predecessors((size_t)this->num_sensors);
+        std::unordered_set<int> used_sensors;
+        std::vector<POIDeficit> local_report;
+
+        for (a_poi=begin; a_poi<end; a_poi++) {
+
+            // Coverage: active sensors covering the POI
+            coverage = 0;
+            for (const int &a_sensor : this->poi_sensor.at(a_poi)) {
+                if (not isin(inactive_sensors, a_sensor)) {coverage++;}
+            }
+
+            // Connectivity: disjoint paths from the POI to any sink, up to M
+            paths_found = 0;
+            used_sensors = inactive_sensors;
+            while (paths_found < m) {
+                std::fill(predecessors.begin(), predecessors.end(), -2);
+                path_end = this->find_path(a_poi, used_sensors, level_graph.data(), predecessors.data());
+                if (path_end == -1) {break;}
+                paths_found += 1;
+                while (path_end != -1) {
+                    used_sensors.insert(path_end);
+                    path_end = predecessors[path_end];
+                    if (path_end == -2) {throw std::runtime_error("FORBIDDEN ADDRESS!");}
+                }
+            }
+
+            // Note the POI if it has any deficit
+            if ((coverage < k) or (paths_found < m)) {local_report.push_back({a_poi, coverage, paths_found});}
+        }
+
+        // Merge the local report into the shared one
+        std::lock_guard<std::mutex> guard(report_lock);
+        report->insert(report->end(), local_report.begin(), local_report.end());
+    });
+
+    // Chunks finish in any order
+    std::sort(report->begin(), report->end(),
+              [](const POIDeficit &a, const POIDeficit &b) {return a.poi < b.poi;});
+    return (int)(report->size());
+}
+
+
+/** DEFICIENCY REPORT WRAPPER
+ * Formats the report as a line for each deficient POI, with its coverage and connectivity. SUCCESS if none.
+ */
+std::string KCMC_Instance::report(const int k, const int m, std::unordered_set<int> &inactive_sensors) {
+    std::vector<POIDeficit> deficits;
+    if (this->deficiency_report(k, m, inactive_sensors, &deficits) == 0) {return "SUCCESS";}
+
+    std::ostringstream out;
+    for (const POIDeficit &deficit : deficits) {
+        out << "POI " << deficit.poi
+            << " COVERAGE " << deficit.coverage << (deficit.coverage < k ? "*" : "")
+            << " CONNECTIVITY " << deficit.connectivity << (deficit.connectivity < m ? "*" : "")
+            << std::endl;
+    }
+    out << "DEFICIENT POIS " << deficits.size() << " OF " << this->num_pois;
+    return out.str();
+}
+
+
+/** DEFICIT REPAIR
+ * The validators search paths in the level graph of the active sensors, so a POI may fail them even with M disjoint
+ *   paths among the active sensors. Its paths are then searched in the level graph of every sensor, and activated.
+ *   Activating sensors changes the level graph, so the report is run again (for at most REPAIR_ROUNDS rounds)
+ */
+int KCMC_Instance::repair_deficits(const int k, const int m, std::vector<char> *active) {
+    const int REPAIR_ROUNDS = 3;
+    int added = 0, path_end;
+    std::unordered_set<int> emptyset, inactive_sensors, used_sensors;
+    std::vector<POIDeficit> deficits;
+    std::vector<int> level_graph((size_t)this->num_sensors, 0), predecessors((size_t)this->num_sensors);
+    if (m > 0) {this->level_graph(level_graph.data(), emptyset);}
+
+    for (int round=0; round<REPAIR_ROUNDS; round++) {
+        inactive_sensors.clear();
+        for (int a_sensor=0; a_sensor<this->num_sensors; a_sensor++) {
+            if (not (*active)[a_sensor]) {inactive_sensors.insert(a_sensor);}
+        }
+        if (this->deficiency_report(k, m, inactive_sensors, &deficits) == 0) {break;}
+
+        for (const POIDeficit &deficit : deficits) {
+            // Missing covering sensors
+            int missing = k - deficit.coverage;
+            for (const int &a_sensor : this->poi_sensor.at(deficit.poi)) {
+                if (missing <= 0) {break;}
+                if (not (*active)[a_sensor]) {(*active)[a_sensor] = 1; added++; missing--;}
+            }
+
+            // Paths among every sensor
+            used_sensors.clear();
+            for (int paths_found=0; paths_found<m; paths_found++) {
+                std::fill(predecessors.begin(), predecessors.end(), -2);
+                path_end = this->find_path(deficit.poi, used_sensors, level_graph.data(), predecessors.data());
+                if (path_end == -1) {break;}
+                for (; path_end != -1; path_end = predecessors[path_end]) {
+                    used_sensors.insert(path_end);
+                    if (not (*active)[path_end]) {(*active)[path_end] = 1; added++;}
+                }
+            }
+        }
+    }
+    return added;
+}
@@ -5,53 +5,90 @@
  */
 
 
+#include <atomic>     // atomic
 #include <cmath>      // log2
+#include <csignal>    // sig_atomic_t
 #include <chrono>     // time functions
-#include <iomanip>    // setfill, setw
 #include <iostream>   // cout, endl
-#include <sstream>    // ostringstream
 #include <cstdlib>    // rand
 #include <numeric>    // accumulate
 #include <algorithm>  // copy, fill
+#include <random>     // mt19937
+#include <unordered_map>  // unordered_map
+#include <utility>    // pair
+#include <unistd.h>   // _exit
 
 // Dependencies from this package
 #include "kcmc_instance.h"
 #include "genetic_algorithm_operators.h"
+#include "presolve.h"
+#include "kcmc_metrics.h"
+#include "result_sink.h"
 
 
+/* EXIT SIGNALS
+ * The handler only records the signal (exiting from it could leave the results half-pushed, and their writer waiting
+ *   forever at exit). A second signal, if the first was not acted on yet, ends the process at once
+ */
+static volatile sig_atomic_t exit_signal = 0;
+
 void exit_signal_handler(int signal) {
-   std::cerr << "Interrupt signal (" << signal << ") received. Exiting gracefully..." << std::endl;
-   exit(0);
+    if (exit_signal != 0) {_exit(128 + signal);}
+    exit_signal = signal;
 }
 
+bool exit_requested() {
+    static std::atomic<bool> reported(false);
+    if (exit_signal == 0) {return false;}
+    if (not reported.exchange(true)) {
+        std::cerr << "Interrupt signal (" << exit_signal << ") received. Exiting gracefully..." << std::endl;
+    }
+    return true;
+}
 
-void printout(int num_generation, double pop_entropy, int chromo_size, int *individual, double fitness) {
-
-    // Get the number of USED sensors in the individual
-    int num_used = std::accumulate(individual, individual+chromo_size, 0);
 
-    // Prepare the output buffer
-    std::ostringstream out;
+void printout(int num_generation, double pop_entropy, int chromo_size, int *individual, double fitness) {
 
     // Print header in the first generation
-    if (num_generation == 0) {out << "GEN_IT\tTIMESTAMP_MS\tENTROPY\tACTIVE\tFITNESS\tCHROMOSSOME" << std::endl;}
+    if (num_generation == 0) {results().header("GEN_IT\tTIMESTAMP_MS\tENTROPY\tACTIVE\tFITNESS\tCHROMOSSOME");}
 
-    // Print a line with:
+    // Write a record with:
     // - The number of the current generation
     // - The current timestamp
+    // - The population entropy
     // - The number of used sensors in the individual
-    // - The percentage of UNused sensors in the individual
     // - The given fitness value
     // - The individual itself
-    out << std::setfill('0') << std::setw(5) << num_generation
-        << "\t" << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count()
-        << "\t" << std::fixed << std::setprecision(5) << pop_entropy
-        << "\t" << std::setfill(' ') << std::setw(5) << num_used
-        << "\t" << std::setfill(' ') << std::setw(7) << std::fixed << std::setprecision(1) << fitness
-        << "\t";
-    for (int i=0; i<chromo_size; i++) {out << individual[i];}
-    // Flush
-    std::cout << out.str() << std::endl;
+    KCMC_Record record;
+    record.integer("generation", num_generation, 5, '0')
+          .integer("timestamp_ms", std::chrono::duration_cast<std::chrono::milliseconds>(
+                                       std::chrono::system_clock::now().time_since_epoch()).count())
+          .real("entropy", pop_entropy, 5)
+          .integer("active", std::accumulate(individual, individual+chromo_size, 0), 5)
+          .real("fitness", fitness, 1, 7)
+          .bits("chromosome", individual, chromo_size);
+    results().write(std::move(record));
+}
+
+
+/* #####################################################################################################################
+ * RANDOM NUMBERS
+ * Each thread draws from the global rand() unless it was seeded with ga_seed, so single-threaded runs keep the
+ *   sequences of srand() and concurrent runs are independent and repeatable
+ * */
+
+
+static thread_local bool ga_seeded = false;
+static thread_local std::mt19937 ga_generator;
+
+void ga_seed(unsigned int seed) {
+    ga_generator.seed(seed);
+    ga_seeded = true;
+}
+
+int ga_rand() {
+    if (not ga_seeded) {return rand();}
+    return (int)(ga_generator() % ((unsigned int)RAND_MAX + 1u));
 }
 
 
@@ -63,7 +100,7 @@ void printout(int num_generation, double pop_entropy, int chromo_size, int *indi
 int individual_creation(float one_bias, int size, int chromo[]) {
     int num_ones = 0;
     for (int i=0; i<size; i++) {
-        chromo[i] = ((double) rand() / (RAND_MAX))< one_bias ? 1 : 0;
+        chromo[i] = ((double) ga_rand() / (RAND_MAX))< one_bias ? 1 : 0;
         num_ones += chromo[i];
     }
     return num_ones;
@@ -107,7 +144,7 @@ int selection_roulette(int sel_size, std::vector<int> *selection, int pop_size,
     double total_fitness = std::accumulate(fitness, fitness+pop_size, 0.0);
 
     // Generate a random value between 0 and the total fitness
-    double random_value = ((double)rand() / (RAND_MAX)) * total_fitness;
+    double random_value = ((double)ga_rand() / (RAND_MAX)) * total_fitness;
 
     // While we still have not selected all values
     int pos = -1, iterations = 0;
@@ -133,7 +170,7 @@ int selection_roulette(int sel_size, std::vector<int> *selection, int pop_size,
 
         // Reset the position and the random value
         pos = -1;
-        random_value = ((double) rand() / (RAND_MAX)) * total_fitness;
+        random_value = ((double) ga_rand() / (RAND_MAX)) * total_fitness;
     }
 
     // Return the number of iterations
@@ -141,9 +178,9 @@ int selection_roulette(int sel_size, std::vector<int> *selection, int pop_size,
 }
 
 int selection_get_one(int sel_size, std::vector<int> selection, int avoid) {
-    int pos = rand() % sel_size;
+    int pos = ga_rand() % sel_size;
     while (selection[pos] == avoid) {
-        pos = rand() % sel_size;
+        pos = ga_rand() % sel_size;
     }
     return selection[pos];
 }
@@ -157,7 +194,7 @@ int selection_get_one(int sel_size, std::vector<int> selection, int avoid) {
 int crossover_single_point(int size, int *chromo_a, int *chromo_b, int output[]) {
     // USED BY GUPTA
 
-    int pos = rand() % size;  // Random bit
+    int pos = ga_rand() % size;  // Random bit
 
     // Copy the prefix of A into the output
     std::copy(chromo_a, chromo_a+pos, output);
@@ -178,7 +215,7 @@ int crossover_single_point(int size, int *chromo_a, int *chromo_b, int output[])
 int mutation_random_bit_flip(int size, int chromo[]) {
     // USED BY GUPTA
 
-    int pos = rand() % size;  // Random bit
+    int pos = ga_rand() % size;  // Random bit
     chromo[pos] = (chromo[pos] == 1) ? 0 : 1 ;  // Bit flip
 
     // Return the position of the flipped bit
@@ -190,7 +227,7 @@ int mutation_random_set(int size, int chromo[]) {
     // Randomly set a zero to a one, with at most 2*size attempts
 
     int pos, limit = 0;
-    do {pos = rand() % size; limit++;} while (chromo[pos] == 1 and (limit < (size*2))); // random bit that is a one
+    do {pos = ga_rand() % size; limit++;} while (chromo[pos] == 1 and (limit < (size*2))); // random bit that is a one
     chromo[pos] = 1 ;  // Set bit
 
     // Return the position of the set bit
@@ -202,7 +239,7 @@ int mutation_random_reset(int size, int chromo[]) {
     // Randomly set a one to a zero, with at most 2*size attempts
 
     int pos, limit = 0;
-    do {pos = rand() % size; limit++;} while (chromo[pos] == 0 and (limit < (size*2))); // random bit that is a one
+    do {pos = ga_rand() % size; limit++;} while (chromo[pos] == 0 and (limit < (size*2))); // random bit that is a one
     chromo[pos] = 0 ;  // Reset bit
 
     // Return the position of the reset bit
@@ -228,3 +265,279 @@ double population_entropy(double *target, int pop_size, int chromo_size, int **p
     // Return the average entropy of the entire population
     return std::accumulate(target, target+pop_size, 0.0) / (double)chromo_size;
 }
+
+
+/** Fitness Function (MIN)
+ * The best possible fitness has the minimal number of active sensors for the instance to have K-Coverage and
+ * M-Connectivity at the same time.
+ * Valid instances have fitness <= number of sensors.
+ * Invalid instances have fitness that is the number of sensors used summed with a penalty value for each violation
+ * A violation is a POI that has less than K-Coverage of M-Connectivity. The same POI might incur in several violations.
+ * The penalty value in each violation is the product by its severity (i.e. a POI that has 1-Coverage when K=4 has a
+ * violation of severity 3), the total number of sensors in the instance, and the weight of the type of violation (
+ * coverage or connectivity).
+ * Thus, the worst theorical maximal fitness is NUM_SENSORS + (((K*w_k*NUM_SENSORS) + (M*w_m*NUM_SENSORS)) * NUM_POIS)
+ * @param wsn
+ * @param K
+ * @param M
+ * @param weight_k
+ * @param weight_m
+ * @param chromo
+ * @return
+ */
+double fitness_binary(KCMC_Instance *wsn, int K, int M, double weight_k, double weight_m, int *chromo) {
+    KCMC_Trace_Summary summary;  // No per-POI events for each evaluation
+
+    // Define reused buffers
+    int i, severity;
+    double fitness;
+
+    // Get the set of inactive sensors, the coverage and connectivity array at each POI
+    std::unordered_set<int> inactive_sensors;
+    setify(inactive_sensors, wsn->num_sensors, chromo, 0);
+
+    // Compute the starting fitness as the number of active sensors
+    fitness = (double)(wsn->num_pois - inactive_sensors.size());
+
+    // Get the coverage and connectivity at each POI
+    int coverage[wsn->num_pois], connectivity[wsn->num_pois];
+    wsn->get_coverage(coverage, inactive_sensors);
+    wsn->get_connectivity(connectivity, inactive_sensors, M);
+
+    // Compute the penalties on validity violations and return the total fitness
+    for (i=0; i<wsn->num_pois; i++) {
+        severity = K-coverage[i];  // Get the severity of the Coverage violation. 0 or less do not incur in penalties
+        if (severity > 0) {fitness += (severity*weight_k*wsn->num_sensors);}
+        severity = M-connectivity[i];  // Get the severity of the Connectivity violation. 0 or less do not incur in penalties
+        if (severity > 0) {fitness += (severity*weight_m*wsn->num_sensors);}
+    }
+    return fitness;
+}
+
+
+/* #####################################################################################################################
+ * GENETIC ALGORITHM
+ * */
+
+/* FITNESS CACHE
+ * Crossover between similar parents and the untouched elites re-create many individuals already evaluated. As the
+ * fitness is deterministic, it is memoized by chromosome. Each run has its own cache, cleared when its next entry would
+ *   take it past the budget (ga_fitness_cache, set before the runs start). A budget of 0 disables it.
+ * Each entry is estimated as malloc allocations (8 bytes of header, in 16-byte steps) of its node (next pointer, key,
+ *   fitness and cached hash) and of the characters of its key (past the 15 of the short-string buffer), plus a
+ *   bucket pointer. The glibc heap grows within 5% of the estimate per entry for chromosomes of 100 to 3000 sensors
+ */
+static const size_t FITNESS_CACHE_BYTES = 64 * 1024 * 1024;
+static size_t fitness_cache_bytes = FITNESS_CACHE_BYTES;
+
+void ga_fitness_cache(size_t bytes) {fitness_cache_bytes = bytes;}
+
+static size_t fitness_cache_entry_bytes(const int chromo_size) {
+    auto allocation = [](const size_t bytes) {return ((bytes + sizeof(size_t) + 15) / 16) * 16;};
+    size_t bytes = allocation(sizeof(void*) + sizeof(std::pair<const std::string, double>) + sizeof(size_t))
+                   + sizeof(void*);
+    if (chromo_size > 15) {bytes += allocation((size_t)chromo_size + 1);}
+    return bytes;
+}
+
+
+/** GA METRICS
+ * Writes the metrics snapshot of the running GA (see kcmc_metrics.h)
+ */
+static void ga_metrics(int num_generation, long long evaluations, long long cache_hits, double evaluations_per_second,
+                       double best_fitness, double pop_entropy) {
+    metrics_write({
+        {"kcmc_ga_generation", "gauge", "Current generation of the GA", (double)num_generation},
+        {"kcmc_ga_evaluations_total", "counter", "Individuals evaluated, including fitness cache hits",
+         (double)evaluations},
+        {"kcmc_ga_evaluations_per_second", "gauge", "Individuals evaluated per second since the last snapshot",
+         evaluations_per_second},
+        {"kcmc_ga_fitness_cache_hits_total", "counter", "Evaluations answered by the fitness cache", (double)cache_hits},
+        {"kcmc_ga_fitness_cache_hit_ratio", "gauge", "Fraction of the evaluations answered by the fitness cache",
+         (evaluations > 0) ? (double)cache_hits / (double)evaluations : 0.0},
+        {"kcmc_ga_best_fitness", "gauge", "Best fitness found so far (lower is better)", best_fitness},
+        {"kcmc_ga_population_entropy", "gauge", "Average entropy of the genes in the current population", pop_entropy},
+    });
+}
+
+
+/** Genetic Algorithm with binary tiers of fitness, for valid and invalid solutions
+ *
+ * @param unused_sensors  Output Buffer
+ * @param print_interval  Generations interval until printing the best individual to STDOUT. If 0, nothing is printed
+ * @param max_generations MAX GenAlg Generations (Iterations)
+ * @param pop_size        Population Size
+ * @param sel_size        Selection/Crossover Group Size
+ * @param mut_rate        Mutation Rate
+ * @param wsn             KCMC WSN Instance
+ * @param K               KCMC K
+ * @param M               KCMC M
+ * @param w_coverage      Weight of the penalty on coverage violations
+ * @param w_connectivity  Weight of the penalty on connectivity violations
+ * @param presolve        If not null, the WSN instance is presolved, and printed individuals are mapped back
+ * @param lower_bound     If not negative, stops as soon as a valid individual uses no more sensors than the bound
+ * @param trace           If not null, receives each improvement of the best individual, with its time since the start
+ * @return
+ */
+int genalg_binary(
+    std::unordered_set<int> *unused_sensors,
+    int print_interval, int max_generations, int pop_size, int sel_size, float mut_rate, float one_bias,
+    KCMC_Instance *wsn, int K, int M,
+    double w_valid, double w_invalid,
+    KCMC_Presolve *presolve, int lower_bound,
+    std::vector<GATracePoint> *trace
+) {
+    // Prepare buffers
+    auto start = std::chrono::steady_clock::now();
+    bool improved;
+    int i, best, num_generation, parent_0, parent_1,
+        chromo_size = wsn->num_sensors,
+        population[pop_size][chromo_size];
+    double pop_entropy, best_fitness_ever = WORST_FITNESS, fitness[pop_size], colunar_entropy[chromo_size];
+    std::vector<int> selection;
+    std::unordered_map<std::string, double> fitness_cache;
+    const size_t max_cached = fitness_cache_bytes / fitness_cache_entry_bytes(chromo_size);
+    std::string chromo_key((size_t)chromo_size, '0');
+    long long evaluations = 0, cache_hits = 0, last_evaluations = 0;
+    auto last_metrics = start;
+    std::vector<int> original_individual((size_t)((presolve == nullptr) ? 0 : presolve->reduced->num_sensors
+                                                                              + presolve->removed_sensors.size()));
+
+    // FLAGS
+    bool SAFE = true,
+         ELITISM = true;  // The best individual always stays intact in the next generation
+
+    // Prepare an alternate buffer for the population
+    // Look, it's C++, OK? Sometimes things like that are necessary
+    int *pop[pop_size];
+    if (SAFE) {for (size_t j = 0; j<pop_size; j++) {pop[j] = population[j];}}
+
+    // Generate a random population
+    for (i=0; i<pop_size; i++) {individual_creation(one_bias, chromo_size, population[i]);}
+
+    // Evolve "FOREVER". THE OS IS SUPPOSED TO HANDLE TIMEOUTS!
+    // This software assumes that the OS will handle timeouts, thus avoiding
+    // overhead and complexity in the algorithm itself. As a fallback security
+    // measure, we limit the generations to a otherwise very large number.
+    // The software will handle gracefully OS signals SIGINT, SIGALRM, SIGABRT and SIGTERM, between generations
+    KCMC_Trace_Summary summary;  // Evaluations and validations of every generation, without per-POI events
+    for (num_generation=0; num_generation<max_generations+1; num_generation++) {
+
+        // If in safe mode, inspect the population once every INSPECTION_FREQUENCY generations
+        if (SAFE & ((num_generation % INSPECTION_FREQUENCY) == 0)) {inspect_population(pop_size, wsn->num_sensors, pop);}
+
+        // Evaluate the population and find the best
+        {
+            KCMC_TRACE("ga_evaluate", "generation", num_generation);
+            for (i=0; i<pop_size; i++) {
+                for (int j=0; j<chromo_size; j++) {chromo_key[j] = (char)('0' + population[i][j]);}
+                auto cached = fitness_cache.find(chromo_key);
+                if (cached != fitness_cache.end()) {fitness[i] = cached->second; cache_hits++;}
+                else {
+                    fitness[i] = fitness_binary(wsn, K, M, w_valid, w_invalid, population[i]);
+                    if (max_cached > 0) {
+                        if (fitness_cache.size() >= max_cached) {fitness_cache.clear();}
+                        fitness_cache.emplace(chromo_key, fitness[i]);
+                    }
+                }
+            }
+            evaluations += pop_size;
+            best = ((int)(std::min_element(fitness, fitness + pop_size) - fitness));
+        }
+
+        // If the current best is the best ever found,
+        // or if we have run the appropriate interval of generations.
+        improved = (fitness[best] < best_fitness_ever);
+        if (((print_interval > 0) and ((num_generation % print_interval) == 0)) | improved) {
+
+            // Compute the population's entropy, average and by column
+            pop_entropy = population_entropy(colunar_entropy, pop_size, chromo_size, pop);
+
+            // Print the best individual in the population
+            if (print_interval <= 0) {}
+            else if (presolve == nullptr) {
+                printout(num_generation, pop_entropy, chromo_size, population[best], fitness[best]);
+            } else {
+                presolve->expand(population[best], original_individual.data());
+                printout(num_generation, pop_entropy, (int)(original_individual.size()),
+                         original_individual.data(), fitness[best]);
+            }
+
+            // Update the best fitness ever found and the resulting set of unused sensors
+            best_fitness_ever = fitness[best];
+            setify(*unused_sensors, chromo_size, population[best], 0);
+
+            // Trace the improvement
+            if (improved and (trace != nullptr)) {
+                trace->push_back({
+                    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count(),
+                    num_generation, std::accumulate(population[best], population[best]+chromo_size, 0), fitness[best],
+                    wsn->validate(false, K, M, *unused_sensors)
+                });
+            }
+
+            // A valid individual at the lower bound is optimal
+            if ((lower_bound >= 0)
+                and (std::accumulate(population[best], population[best]+chromo_size, 0) <= lower_bound)
+                and wsn->validate(false, K, M, *unused_sensors)) {
+                if (print_interval > 0) {
+                    std::cerr << " REACHED THE LOWER BOUND (" << lower_bound << ") AT GENERATION " << num_generation
+                              << ". Exiting gracefully..." << std::endl;
+                }
+                return num_generation;
+            }
+        }
+
+        // On SIGUSR1 or at the metrics interval, write a snapshot between generations
+        if (metrics_due()) {
+            auto now = std::chrono::steady_clock::now();
+            double seconds = std::chrono::duration<double>(now - last_metrics).count();
+            ga_metrics(num_generation, evaluations, cache_hits,
+                       (seconds > 0.0) ? (double)(evaluations - last_evaluations) / seconds : 0.0,
+                       std::min(best_fitness_ever, fitness[best]),
+                       population_entropy(colunar_entropy, pop_size, chromo_size, pop));
+            last_metrics = now;
+            last_evaluations = evaluations;
+        }
+
+        // On an exit signal, stop with the best individual printed so far
+        if (exit_requested()) {return num_generation;}
+
+        // Select individuals for next generation
+        {
+            KCMC_TRACE("ga_select", "generation", num_generation);
+            selection_roulette(sel_size, &selection, pop_size, fitness);
+        }
+
+        // For every population position that was *not* selected
+        {
+            KCMC_TRACE("ga_crossover", "generation", num_generation);
+            for (i=0; i<pop_size; i++) {
+                if ((not isin(selection, i)) and ((i != best) or (not ELITISM))) {
+
+                    // Choose 2 different individuals among the selected in this generation
+                    parent_0 = selection_get_one(sel_size, selection, -1);
+                    parent_1 = selection_get_one(sel_size, selection, parent_0);
+
+                    // Replace the population position with a crossover of the selected pair
+                    crossover_single_point(chromo_size, population[parent_0], population[parent_1], population[i]);
+                }
+            }
+        }
+
+        // For every individual in the population
+        {
+            KCMC_TRACE("ga_mutate", "generation", num_generation);
+            for (i=0; i<pop_size; i++) {
+                // If this individual got lucky, randomly flip a bit
+                if ((((double) ga_rand() / (RAND_MAX)) < mut_rate) and ((i != best) or (not ELITISM))) {
+                    mutation_random_bit_flip(chromo_size, population[i]);
+                }
+            }
+        }
+    }
+    if (print_interval > 0) {
+        std::cerr << " Reached HARD-LIMIT OF GENERATIONS (" << num_generation-1 << "). Exiting gracefully..." << std::endl;
+    }
+    return num_generation;
+}
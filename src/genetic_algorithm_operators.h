@@ -14,7 +14,15 @@
 #ifndef GENETIC_ALGORITHM_OPERATORS_H
 #define GENETIC_ALGORITHM_OPERATORS_H
 
+/* EXIT SIGNALS
+ * The handler records the signal. Long loops (generations, branch-and-bound nodes, heuristics of the optimizer) poll
+ *   exit_requested and stop normally, so every result is written. It reports the signal the first time it is true
+ */
 void exit_signal_handler(int signal);
+bool exit_requested();
+
+void ga_seed(unsigned int seed);
+int ga_rand();
 
 void printout(int num_generation, double pop_entropy, int chromo_size, int *individual, double fitness);
 
@@ -33,4 +41,29 @@ int mutation_random_reset(int size, int chromo[]);
 
 double population_entropy(double *target, int pop_size, int chromo_size, int **population);
 
+double fitness_binary(KCMC_Instance *wsn, int K, int M, double weight_k, double weight_m, int *chromo);
+
+/* GA TRACE POINT
+ * An improvement of the best individual: microseconds since the start of the GA, generation, active sensors,
+ *   fitness and validity
+ */
+struct GATracePoint {
+    long long microseconds;
+    int generation, active;
+    double fitness;
+    bool valid;
+};
+
+/* FITNESS CACHE BUDGET
+ * Estimated bytes of the fitness cache of EACH run of genalg_binary (concurrent runs have a cache each). 0 disables the
+ *   cache. Defaults to 64 MB. Set it before the runs start
+ */
+void ga_fitness_cache(size_t bytes);
+
+class KCMC_Presolve;
+int genalg_binary(std::unordered_set<int> *unused_sensors,
+                  int print_interval, int max_generations, int pop_size, int sel_size, float mut_rate, float one_bias,
+                  KCMC_Instance *wsn, int K, int M, double w_valid, double w_invalid,
+                  KCMC_Presolve *presolve, int lower_bound, std::vector<GATracePoint> *trace = nullptr);
+
 #endif
@@ -0,0 +1,125 @@
+/*
+ * KCMC ILP exporter
+ * Writes the Single-Flow or Multi-Flow ILP of a KCMC instance as an LP or MPS file, readable by any solver
+ */
+
+
+// STDLib Dependencies
+#include <iostream>  // cin, cout, endl
+#include <chrono>    // time functions
+
+// Dependencies from this package
+#include "kcmc_instance.h"
+#include "ilp_writer.h"
+#include "presolve.h"
+
+
+/* #####################################################################################################################
+ * RUNTIME
+ * */
+
+
+void help() {
+    std::cout << "Please, use the correct input for the KCMC ILP exporter:" << std::endl << std::endl;
+    std::cout << "./ilp_exporter [--presolve] <model> <output> <k> <m> <instance> [<heuristic>]" << std::endl;
+    std::cout << "  where:" << std::endl << std::endl;
+    std::cout << "--presolve (optional) leaves the useless sensors out of the model and fixes the forced ones" << std::endl;
+    std::cout << "<model> is single_flow or multi_flow. Prefix it with y_binary_ for binary flow variables" << std::endl;
+    std::cout << "  or path_<N>, the path-selection model over pools of the N shortest paths of each POI" << std::endl;
+    std::cout << "<output> is the model file. Its extension (.lp or .mps) sets the format" << std::endl;
+    std::cout << "K > 0 is the desired K coverage" << std::endl;
+    std::cout << "M > 0 is the desired M connectivity" << std::endl;
+    std::cout << "<instance> is the serialized KCMC instance" << std::endl;
+    std::cout << "<heuristic> optionally restricts the model to the sensors used by a heuristic" << std::endl;
+    std::cout << "  (dinic, min_flood, max_flood, no_reuse, min_reuse, max_reuse, best_reuse)" << std::endl;
+    std::cout << std::endl << "./ilp_exporter --check <model.mps> <start.mst>" << std::endl;
+    std::cout << "  checks the MIP start (as written by the optimizer) against every row and bound of the model" << std::endl;
+    std::cout << "--stats (optional, before anything else) prints the hot-path counters to STDERR at exit."
+              << " Counters are only compiled in builds configured with -DKCMC_STATS=ON" << std::endl;
+    std::cout << "--trace <file> (optional, before anything else) writes a timeline of the phases (parse, level graph,"
+              << " path searches, floods, GA steps...) to the file at exit, as Chrome trace-event JSON" << std::endl;
+    exit(0);
+}
+
+
+int main(int argc, char* const argv[]) {
+    {int skip = diagnostic_flags(argc, argv); argv += skip; argc -= skip;}  // --stats and --trace, at exit
+    if (argc < 4) { help(); }
+
+    // Check a MIP start against an exported model
+    if (std::string(argv[1]) == "--check") {
+        long long violations = check_start(argv[2], argv[3], std::cerr, 20);
+        std::cout << (violations == 0 ? "OK" : "INVALID") << "\t" << violations << std::endl;
+        return (violations == 0) ? 0 : 1;
+    }
+
+    // Optional leading flag
+    bool use_presolve = (std::string(argv[1]) == "--presolve");
+    if (use_presolve) {argv++; argc--;}
+    if (argc < 6) { help(); }
+
+    // Buffers
+    int k, m, model, pool_size = 0;
+    long long rows, columns;
+    bool y_binary;
+    long long nonzeros;
+    std::string model_name, output, heuristic;
+    std::unordered_set<int> emptyset, inactive_sensors, used_sensors;
+
+    /* Parse base Arguments */
+    model_name = argv[1];
+    output = argv[2];
+    k = std::stoi(argv[3]);
+    m = std::stoi(argv[4]);
+    auto *instance = new KCMC_Instance(argv[5]);
+    heuristic = (argc > 6) ? argv[6] : "";
+
+    y_binary = (model_name.rfind("y_binary_", 0) == 0);
+    if (y_binary) {model_name = model_name.substr(9);}
+    if (model_name == "single_flow") {model = SINGLE_FLOW;}
+    else if (model_name == "multi_flow") {model = MULTI_FLOW;}
+    else if (model_name.rfind("path_", 0) == 0) {model = PATH_SELECTION; pool_size = std::stoi(model_name.substr(5));}
+    else {help(); return 1;}
+
+    // Restrict the model to the sensors used by the heuristic, if any
+    auto start = std::chrono::high_resolution_clock::now();
+    if (not heuristic.empty()) {
+        instance->heuristic(heuristic, k, m, emptyset, &used_sensors);
+        instance->invert_set(used_sensors, &inactive_sensors);
+    }
+
+    // Presolve the instance, if required. Removed sensors are inactive. Sensor names stay the original ones
+    KCMC_Presolve *presolve = nullptr;
+    if (use_presolve) {
+        presolve = new KCMC_Presolve(instance, k, m, false);
+        inactive_sensors.insert(presolve->removed_sensors.begin(), presolve->removed_sensors.end());
+    }
+
+    // Build and write the model
+    if (model == PATH_SELECTION) {
+        KCMC_PathILP ilp(instance, k, m, pool_size, inactive_sensors);
+        if (ilp.num_short > 0) {std::cerr << ilp.num_short << " POIS HAVE LESS THAN M PATHS IN THEIR POOLS" << std::endl;}
+        nonzeros = ilp.write(output);
+        rows = ilp.num_rows();
+        columns = ilp.num_columns();
+    } else {
+        KCMC_ILP ilp(instance, k, m, model, y_binary, inactive_sensors);
+        if (presolve != nullptr) {
+            for (const int &a_sensor : presolve->forced_sensors) {
+                if (not isin(inactive_sensors, a_sensor)) {ilp.forced_sensors.insert(a_sensor);}
+            }
+        }
+        nonzeros = ilp.write(output);
+        rows = ilp.num_rows();
+        columns = ilp.num_columns();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    // Print a line with the key, K, M, model, heuristic, microsseconds, rows, columns and non-zeros
+    std::cout << instance->key() << "\t" << k << "\t" << m
+              << "\t" << argv[1] << "\t" << (heuristic.empty() ? "none" : heuristic)
+              << "\t" << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+              << "\t" << rows << "\t" << columns << "\t" << nonzeros << std::endl;
+    delete presolve;
+    return 0;
+}
@@ -0,0 +1,867 @@
+/** ILP_WRITER.cpp
+ * Writer of the Single-Flow and Multi-Flow ILP formulations of a KCMC instance, as LP or MPS files
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <fstream>    // ofstream
+#include <cstdlib>    // abs
+#include <algorithm>  // sort
+#include <stdexcept>  // runtime_error
+#include <sstream>    // istringstream
+#include <cmath>      // round, HUGE_VAL
+#include <queue>      // queue
+#include <functional> // function
+
+// Dependencies from this package
+#include "ilp_writer.h"  // KCMC ILP headers
+
+#define TERMS_PER_LINE 8  // Keeps LP lines well under the 510 characters many readers accept
+
+
+/* NODE NAMES
+ * The same names of the Python KCMC_Instance: p{index}, i{index} and s{index}
+ */
+static std::string node_name(Node node) {
+    switch (node.nodetype) {
+        case tPOI: return "p" + std::to_string(node.index);
+        case tSENSOR: return "i" + std::to_string(node.index);
+        default: return "s" + std::to_string(node.index);
+    }
+}
+
+
+/* LP TERM
+ * Writes a signed term of an LP expression, breaking the line every few terms
+ */
+static void lp_term(std::ostream &out, const int coefficient, const std::string &variable, int *terms) {
+    if ((*terms > 0) and ((*terms % TERMS_PER_LINE) == 0)) {out << "\n  ";}
+    if (coefficient < 0) {out << " - ";} else if (*terms > 0) {out << " + ";} else {out << " ";}
+    if ((coefficient != 1) and (coefficient != -1)) {out << std::abs(coefficient) << " ";}
+    out << variable;
+    (*terms)++;
+}
+
+
+/** KCMC ILP CONSTRUCTOR
+ * Collects the sets of the formulation from the instance, ignoring inactive sensors
+ */
+KCMC_ILP::KCMC_ILP(KCMC_Instance *instance, const int k, const int m, const int model, const bool y_binary,
+                   std::unordered_set<int> &inactive_sensors) {
+    if (model != SINGLE_FLOW and model != MULTI_FLOW) {throw std::runtime_error("UNKNOWN ILP MODEL!");}
+
+    this->k = k;
+    this->m = m;
+    this->model = model;
+    this->y_binary = y_binary;
+    this->num_layers = (model == MULTI_FLOW) ? m : 1;
+    this->num_pois = instance->num_pois;
+    this->num_sensors = instance->num_sensors;
+    this->out_arcs.resize((size_t)(this->num_pois + this->num_sensors + 1));
+    this->in_arcs.resize((size_t)(this->num_pois + this->num_sensors + 1));
+    this->covering.resize((size_t)this->num_pois);
+    this->covered.resize((size_t)this->num_sensors);
+
+    // P and I. Differently from the Python models, sensors without sensor neighbors are kept in I, otherwise flow
+    //   could cross them without installing them
+    int a_poi, a_sensor, a_sink;
+    for (a_poi=0; a_poi<this->num_pois; a_poi++) {this->pois.push_back(a_poi);}
+    for (a_sensor=0; a_sensor<this->num_sensors; a_sensor++) {
+        if (not isin(inactive_sensors, a_sensor)) {this->sensors.push_back(a_sensor);}
+    }
+
+    // A = A_c + A_g + A_s, in increasing order of tail and head, for deterministic files
+    std::vector<int> neighbors;
+    auto sorted_active = [&](std::unordered_set<int> &source) {
+        neighbors.clear();
+        for (const int &neighbor : source) {if (not isin(inactive_sensors, neighbor)) {neighbors.push_back(neighbor);}}
+        std::sort(neighbors.begin(), neighbors.end());
+    };
+    for (a_poi=0; a_poi<this->num_pois; a_poi++) {
+        sorted_active(instance->poi_sensor.at(a_poi));
+        for (const int &head : neighbors) {
+            this->arcs.push_back({{tPOI, a_poi}, {tSENSOR, head}});
+            this->covering[a_poi].push_back(head);
+            this->covered[head].push_back(a_poi);
+        }
+    }
+    for (const int &tail : this->sensors) {
+        sorted_active(instance->sensor_sensor.at(tail));
+        for (const int &head : neighbors) {this->arcs.push_back({{tSENSOR, tail}, {tSENSOR, head}});}
+    }
+    for (const int &tail : this->sensors) {
+        if (not isin(instance->sensor_sink, tail)) {continue;}
+        for (a_sink=0; a_sink<instance->num_sinks; a_sink++) {
+            if (isin(instance->sensor_sink[tail], a_sink)) {this->arcs.push_back({{tSENSOR, tail}, {tSINK, a_sink}});}
+        }
+    }
+
+    // Arcs leaving and entering each node
+    for (int arc=0; arc<(int)(this->arcs.size()); arc++) {
+        this->out_arcs[this->node_id(this->arcs[arc].tail)].push_back(arc);
+        this->in_arcs[this->node_id(this->arcs[arc].head)].push_back(arc);
+    }
+}
+
+
+/* #####################################################################################################################
+ * NAMES AND DIMENSIONS
+ */
+
+
+int KCMC_ILP::node_id(Node node) const {
+    switch (node.nodetype) {
+        case tPOI: return node.index;
+        case tSENSOR: return this->num_pois + node.index;
+        default: return this->num_pois + this->num_sensors;  // Every sink is the same super-sink
+    }
+}
+
+std::string KCMC_ILP::layered(const std::string &name, const std::string &index, const int layer) const {
+    if (this->model == MULTI_FLOW) {return name + "(" + index + "," + std::to_string(layer) + ")";}
+    return name + "(" + index + ")";
+}
+
+std::string KCMC_ILP::x_name(const int sensor, const int layer) const {
+    return this->layered("x", "i" + std::to_string(sensor), layer);
+}
+
+std::string KCMC_ILP::y_name(const int arc, const int poi, const int layer) const {
+    return this->layered("y", node_name(this->arcs[arc].tail) + "," + node_name(this->arcs[arc].head)
+                              + ",p" + std::to_string(poi), layer);
+}
+
+long long KCMC_ILP::num_rows() const {
+    const long long P = (long long)(this->pois.size()), I = (long long)(this->sensors.size()), L = this->num_layers;
+    long long rows = (2*P*L) + (2*I*P*L) + P;  // flow_p, flow_s, flow_i, projection, k_coverage
+    if (this->model == MULTI_FLOW) {rows += I;}  // disjunction
+    return rows;
+}
+
+long long KCMC_ILP::num_columns() const {
+    const long long P = (long long)(this->pois.size()), I = (long long)(this->sensors.size()), L = this->num_layers;
+    return (I*L) + ((long long)(this->arcs.size())*P*L);
+}
+
+
+/* #####################################################################################################################
+ * LP WRITER
+ */
+
+
+/** FLOW ROW
+ * Flow of the POI commodity (at the layer) leaving the node, minus the flow entering it
+ */
+void KCMC_ILP::write_flow_row(std::ostream &out, const std::string &row, const int node, const int poi,
+                              const int layer, long long *nonzeros) {
+    int terms = 0;
+    out << " " << row << ":";
+    for (const int &arc : this->out_arcs[node]) {lp_term(out, 1, this->y_name(arc, poi, layer), &terms);}
+    for (const int &arc : this->in_arcs[node]) {lp_term(out, -1, this->y_name(arc, poi, layer), &terms);}
+    if (terms == 0) {out << " 0 " << this->x_name(this->sensors.empty() ? 0 : this->sensors[0], 0);}  // Empty rows
+    *nonzeros += terms;
+}
+
+
+long long KCMC_ILP::write_lp(std::ostream &out) {
+    int l, terms;
+    long long nonzeros = 0;
+    const int sink = this->num_pois + this->num_sensors;
+    const std::string name = (this->model == MULTI_FLOW) ? "MULTI-FLOW" : "SINGLE-FLOW";
+    const int flow = (this->model == MULTI_FLOW) ? 1 : this->m;  // Flow of each commodity at each layer
+
+    out << "\\ KCMC " << name << " K" << this->k << " M" << this->m
+        << " (" << this->pois.size() << " POIs, " << this->sensors.size() << " sensors, " << this->arcs.size() << " arcs)\n";
+
+    // Objective: the number of installed sensors
+    out << "Minimize\n obj:";
+    terms = 0;
+    for (const int &i : this->sensors) {for (l=0; l<this->num_layers; l++) {lp_term(out, 1, this->x_name(i, l), &terms);}}
+    out << "\nSubject To\n";
+
+    // Disjunction: each sensor is in at most one layer
+    if (this->model == MULTI_FLOW) {
+        for (const int &i : this->sensors) {
+            terms = 0;
+            out << " disjunction(i" << i << "):";
+            for (l=0; l<this->num_layers; l++) {lp_term(out, 1, this->x_name(i, l), &terms);}
+            out << (isin(this->forced_sensors, i) ? " = 1\n" : " <= 1\n");
+            nonzeros += terms;
+        }
+    }
+
+    // Flow at the POIs, then at the sensors and at the sink (the Single-Flow model has sinks before sensors)
+    for (l=0; l<this->num_layers; l++) {
+        for (const int &p : this->pois) {
+            this->write_flow_row(out, this->layered("flow_p", "p" + std::to_string(p), l), p, p, l, &nonzeros);
+            out << " = " << flow << "\n";
+        }
+    }
+    auto sink_rows = [&]() {
+        for (l=0; l<this->num_layers; l++) {
+            for (const int &p : this->pois) {
+                this->write_flow_row(out, this->layered("flow_s", "p" + std::to_string(p), l), sink, p, l, &nonzeros);
+                out << " = " << -flow << "\n";
+            }
+        }
+    };
+    if (this->model == SINGLE_FLOW) {sink_rows();}
+    for (const int &i : this->sensors) {
+        for (const int &p : this->pois) {
+            for (l=0; l<this->num_layers; l++) {
+                this->write_flow_row(out, this->layered("flow_i", "i" + std::to_string(i) + ",p" + std::to_string(p), l),
+                                     this->num_pois + i, p, l, &nonzeros);
+                out << " = 0\n";
+            }
+        }
+    }
+    if (this->model == MULTI_FLOW) {sink_rows();}
+
+    // Projection: flow may only leave installed sensors
+    for (const int &i : this->sensors) {
+        for (const int &p : this->pois) {
+            for (l=0; l<this->num_layers; l++) {
+                terms = 0;
+                out << " " << this->layered("projection", "i" + std::to_string(i) + ",p" + std::to_string(p), l) << ":";
+                for (const int &arc : this->out_arcs[this->num_pois + i]) {lp_term(out, 1, this->y_name(arc, p, l), &terms);}
+                lp_term(out, -1, this->x_name(i, l), &terms);
+                out << " <= 0\n";
+                nonzeros += terms;
+            }
+        }
+    }
+
+    // K-Coverage: each POI is covered by at least K installed sensors
+    for (const int &p : this->pois) {
+        terms = 0;
+        out << " k_coverage(p" << p << "):";
+        for (const int &i : this->covering[p]) {
+            for (l=0; l<this->num_layers; l++) {lp_term(out, 1, this->x_name(i, l), &terms);}
+        }
+        if (terms == 0) {out << " 0 " << this->x_name(this->sensors.empty() ? 0 : this->sensors[0], 0);}
+        out << " >= " << this->k << "\n";
+        nonzeros += terms;
+    }
+
+    // Forced sensors of the Single-Flow model are fixed, and not binaries
+    auto fixed = [&](const int i) {return (this->model == SINGLE_FLOW) and isin(this->forced_sensors, i);};
+    out << "Bounds\n";
+    for (const int &i : this->sensors) {if (fixed(i)) {out << " " << this->x_name(i, 0) << " = 1\n";}}
+
+    // Variable types. Continuous Y are non-negative, the LP default
+    out << "Binaries\n";
+    for (const int &i : this->sensors) {
+        if (fixed(i)) {continue;}
+        for (l=0; l<this->num_layers; l++) {out << " " << this->x_name(i, l) << "\n";}
+    }
+    if (this->y_binary) {
+        for (int arc=0; arc<(int)(this->arcs.size()); arc++) {
+            for (const int &p : this->pois) {
+                for (l=0; l<this->num_layers; l++) {out << " " << this->y_name(arc, p, l) << "\n";}
+            }
+        }
+    }
+    out << "End\n";
+    return nonzeros;
+}
+
+
+/* #####################################################################################################################
+ * MPS WRITER
+ */
+
+
+long long KCMC_ILP::write_mps(std::ostream &out) {
+    int l, arc;
+    long long nonzeros = 0;
+    const std::string name = (this->model == MULTI_FLOW) ? "KCMC_MULTI_FLOW" : "KCMC_SINGLE_FLOW";
+    const int flow = (this->model == MULTI_FLOW) ? 1 : this->m;
+    auto p_name = [](const int p) {return "p" + std::to_string(p);};
+    auto ip_name = [](const int i, const int p) {return "i" + std::to_string(i) + ",p" + std::to_string(p);};
+    auto entry = [&](const std::string &column, const std::string &row, const int value) {
+        out << "    " << column << "  " << row << "  " << value << "\n";
+    };
+
+    // ROWS, in the same order of the LP file
+    out << "NAME " << name << "_K" << this->k << "_M" << this->m << "\nROWS\n N  obj\n";
+    if (this->model == MULTI_FLOW) {
+        for (const int &i : this->sensors) {out << (isin(this->forced_sensors, i) ? " E" : " L") << "  disjunction(i" << i << ")\n";}
+    }
+    for (l=0; l<this->num_layers; l++) {for (const int &p : this->pois) {out << " E  " << this->layered("flow_p", p_name(p), l) << "\n";}}
+    auto sink_rows = [&]() {
+        for (l=0; l<this->num_layers; l++) {for (const int &p : this->pois) {out << " E  " << this->layered("flow_s", p_name(p), l) << "\n";}}
+    };
+    if (this->model == SINGLE_FLOW) {sink_rows();}
+    for (const int &i : this->sensors) {
+        for (const int &p : this->pois) {
+            for (l=0; l<this->num_layers; l++) {out << " E  " << this->layered("flow_i", ip_name(i, p), l) << "\n";}
+        }
+    }
+    if (this->model == MULTI_FLOW) {sink_rows();}
+    for (const int &i : this->sensors) {
+        for (const int &p : this->pois) {
+            for (l=0; l<this->num_layers; l++) {out << " L  " << this->layered("projection", ip_name(i, p), l) << "\n";}
+        }
+    }
+    for (const int &p : this->pois) {out << " G  k_coverage(p" << p << ")\n";}
+
+    // COLUMNS. X: objective, disjunction, projection at each POI and coverage of each covered POI
+    out << "COLUMNS\n";
+    for (const int &i : this->sensors) {
+        for (l=0; l<this->num_layers; l++) {
+            const std::string column = this->x_name(i, l);
+            entry(column, "obj", 1);
+            if (this->model == MULTI_FLOW) {entry(column, "disjunction(i" + std::to_string(i) + ")", 1); nonzeros++;}
+            for (const int &p : this->pois) {entry(column, this->layered("projection", ip_name(i, p), l), -1); nonzeros++;}
+            for (const int &p : this->covered[i]) {entry(column, "k_coverage(p" + std::to_string(p) + ")", 1); nonzeros++;}
+        }
+    }
+
+    // Y: leaves its tail (if the tail is the POI of the commodity, or a sensor) and enters its head
+    for (arc=0; arc<(int)(this->arcs.size()); arc++) {
+        const Arc &an_arc = this->arcs[arc];
+        for (const int &p : this->pois) {
+            for (l=0; l<this->num_layers; l++) {
+                const std::string column = this->y_name(arc, p, l);
+                int entries = 0;
+                if ((an_arc.tail.nodetype == tPOI) and (an_arc.tail.index == p)) {
+                    entry(column, this->layered("flow_p", p_name(p), l), 1); entries++;
+                } else if (an_arc.tail.nodetype == tSENSOR) {
+                    entry(column, this->layered("flow_i", ip_name(an_arc.tail.index, p), l), 1);
+                    entry(column, this->layered("projection", ip_name(an_arc.tail.index, p), l), 1);
+                    entries += 2;
+                }
+                if (an_arc.head.nodetype == tSENSOR) {
+                    entry(column, this->layered("flow_i", ip_name(an_arc.head.index, p), l), -1); entries++;
+                } else if (an_arc.head.nodetype == tSINK) {
+                    entry(column, this->layered("flow_s", p_name(p), l), -1); entries++;
+                }
+                if (entries == 0) {entry(column, "obj", 0);}  // Columns must appear even if empty
+                nonzeros += entries;
+            }
+        }
+    }
+
+    // RHS of the flow, disjunction and coverage rows. All others are 0
+    out << "RHS\n";
+    if (this->model == MULTI_FLOW) {for (const int &i : this->sensors) {entry("rhs", "disjunction(i" + std::to_string(i) + ")", 1);}}
+    for (l=0; l<this->num_layers; l++) {
+        for (const int &p : this->pois) {
+            entry("rhs", this->layered("flow_p", p_name(p), l), flow);
+            entry("rhs", this->layered("flow_s", p_name(p), l), -flow);
+        }
+    }
+    for (const int &p : this->pois) {entry("rhs", "k_coverage(p" + std::to_string(p) + ")", this->k);}
+
+    // BOUNDS: binary X (and Y), or fixed X of forced sensors in the Single-Flow model.
+    //   Continuous Y are non-negative, the MPS default
+    out << "BOUNDS\n";
+    for (const int &i : this->sensors) {
+        if ((this->model == SINGLE_FLOW) and isin(this->forced_sensors, i)) {
+            out << " FX BND  " << this->x_name(i, 0) << "  1\n";
+            continue;
+        }
+        for (l=0; l<this->num_layers; l++) {out << " BV BND  " << this->x_name(i, l) << "\n";}
+    }
+    if (this->y_binary) {
+        for (arc=0; arc<(int)(this->arcs.size()); arc++) {
+            for (const int &p : this->pois) {
+                for (l=0; l<this->num_layers; l++) {out << " BV BND  " << this->y_name(arc, p, l) << "\n";}
+            }
+        }
+    }
+    out << "ENDATA\n";
+    return nonzeros;
+}
+
+
+/** FILE WRITER
+ * Streams the model to the file, in the format of its extension (.lp or .mps)
+ */
+long long KCMC_ILP::write(const std::string &filename) {
+    std::ofstream out(filename);
+    if (not out.is_open()) {throw std::runtime_error("UNABLE TO OPEN " + filename);}
+
+    long long nonzeros;
+    if ((filename.size() > 3) and (filename.substr(filename.size()-3) == ".lp")) {nonzeros = this->write_lp(out);}
+    else if ((filename.size() > 4) and (filename.substr(filename.size()-4) == ".mps")) {nonzeros = this->write_mps(out);}
+    else {throw std::runtime_error("UNKNOWN MODEL FORMAT (USE .lp OR .mps) " + filename);}
+
+    out.close();
+    return nonzeros;
+}
+
+
+/* #####################################################################################################################
+ * PATH-BASED (SET SELECTION) MODEL
+ */
+
+
+/** KCMC PATH ILP CONSTRUCTOR
+ * Builds the path pools, then the sensors of the pool of each POI and the paths with each of them
+ */
+KCMC_PathILP::KCMC_PathILP(KCMC_Instance *instance, const int k, const int m, const int pool_size,
+                           std::unordered_set<int> &inactive_sensors) {
+    this->k = k;
+    this->m = m;
+    this->pool_size = pool_size;
+    this->num_short = 0;
+    this->graph = new KCMC_Graph(instance);
+    this->pool = new KCMC_PathPool(this->graph, pool_size, m, inactive_sensors);
+
+    int a_poi, a_sensor;
+    for (a_poi=0; a_poi<instance->num_pois; a_poi++) {this->pois.push_back(a_poi);}
+    for (a_sensor=0; a_sensor<instance->num_sensors; a_sensor++) {
+        if (not isin(inactive_sensors, a_sensor)) {this->sensors.push_back(a_sensor);}
+    }
+    this->covering.resize(this->pois.size());
+    this->pool_sensors.resize(this->pois.size());
+    this->sensor_paths.resize(this->pois.size());
+
+    std::unordered_map<int, std::vector<int>> paths_with;
+    for (const int &p : this->pois) {
+        for (int i=this->graph->poi_sensor.offsets[p]; i<this->graph->poi_sensor.offsets[p+1]; i++) {
+            a_sensor = this->graph->poi_sensor.targets[i];
+            if (not isin(inactive_sensors, a_sensor)) {this->covering[p].push_back(a_sensor);}
+        }
+        const auto &poi_paths = this->pool->paths[p];
+        if ((int)(poi_paths.size()) < m) {this->num_short++;}
+        paths_with.clear();
+        for (int path=0; path<(int)(poi_paths.size()); path++) {
+            for (const int &i : poi_paths[path]) {paths_with[i].push_back(path);}
+        }
+        for (const auto &entry : paths_with) {this->pool_sensors[p].push_back(entry.first);}
+        std::sort(this->pool_sensors[p].begin(), this->pool_sensors[p].end());
+        for (const int &i : this->pool_sensors[p]) {this->sensor_paths[p].push_back(paths_with[i]);}
+    }
+}
+
+KCMC_PathILP::~KCMC_PathILP() {
+    delete this->pool;
+    delete this->graph;
+}
+
+
+long long KCMC_PathILP::num_rows() const {
+    long long rows = 2 * (long long)(this->pois.size());  // paths, k_coverage
+    for (const auto &poi_sensors : this->pool_sensors) {rows += (long long)(poi_sensors.size());}  // use
+    return rows;
+}
+
+long long KCMC_PathILP::num_columns() const {
+    return (long long)(this->sensors.size()) + this->pool->num_paths();
+}
+
+
+static std::string z_name(const int poi, const int path) {
+    return "z(p" + std::to_string(poi) + "," + std::to_string(path) + ")";
+}
+
+static std::string use_name(const int poi, const int sensor) {
+    return "use(p" + std::to_string(poi) + ",i" + std::to_string(sensor) + ")";
+}
+
+
+long long KCMC_PathILP::write_lp(std::ostream &out) {
+    int terms, path;
+    long long nonzeros = 0;
+    out << "\\ KCMC PATH-SELECTION K" << this->k << " M" << this->m << " POOL " << this->pool_size
+        << " (" << this->pois.size() << " POIs, " << this->sensors.size() << " sensors, "
+        << this->pool->num_paths() << " paths)\n";
+
+    // Objective: the number of installed sensors
+    out << "Minimize\n obj:";
+    terms = 0;
+    for (const int &i : this->sensors) {lp_term(out, 1, "x(i" + std::to_string(i) + ")", &terms);}
+    out << "\nSubject To\n";
+
+    // Paths: M paths of each POI
+    for (const int &p : this->pois) {
+        terms = 0;
+        out << " paths(p" << p << "):";
+        for (path=0; path<(int)(this->pool->paths[p].size()); path++) {lp_term(out, 1, z_name(p, path), &terms);}
+        if (terms == 0) {out << " 0 x(i" << (this->sensors.empty() ? 0 : this->sensors[0]) << ")";}  // Empty rows
+        out << " = " << this->m << "\n";
+        nonzeros += terms;
+    }
+
+    // Use: the chosen paths of a POI install their sensors, and share none
+    for (const int &p : this->pois) {
+        for (size_t s=0; s<this->pool_sensors[p].size(); s++) {
+            terms = 0;
+            out << " " << use_name(p, this->pool_sensors[p][s]) << ":";
+            for (const int &a_path : this->sensor_paths[p][s]) {lp_term(out, 1, z_name(p, a_path), &terms);}
+            lp_term(out, -1, "x(i" + std::to_string(this->pool_sensors[p][s]) + ")", &terms);
+            out << " <= 0\n";
+            nonzeros += terms;
+        }
+    }
+
+    // K-Coverage
+    for (const int &p : this->pois) {
+        terms = 0;
+        out << " k_coverage(p" << p << "):";
+        for (const int &i : this->covering[p]) {lp_term(out, 1, "x(i" + std::to_string(i) + ")", &terms);}
+        if (terms == 0) {out << " 0 x(i" << (this->sensors.empty() ? 0 : this->sensors[0]) << ")";}
+        out << " >= " << this->k << "\n";
+        nonzeros += terms;
+    }
+
+    out << "Binaries\n";
+    for (const int &i : this->sensors) {out << " x(i" << i << ")\n";}
+    for (const int &p : this->pois) {
+        for (path=0; path<(int)(this->pool->paths[p].size()); path++) {out << " " << z_name(p, path) << "\n";}
+    }
+    out << "End\n";
+    return nonzeros;
+}
+
+
+long long KCMC_PathILP::write_mps(std::ostream &out) {
+    int path;
+    long long nonzeros = 0;
+    auto entry = [&](const std::string &column, const std::string &row, const int value) {
+        out << "    " << column << "  " << row << "  " << value << "\n";
+    };
+
+    // ROWS, in the same order of the LP file
+    out << "NAME KCMC_PATH_SELECTION_K" << this->k << "_M" << this->m << "_POOL" << this->pool_size << "\nROWS\n N  obj\n";
+    for (const int &p : this->pois) {out << " E  paths(p" << p << ")\n";}
+    for (const int &p : this->pois) {for (const int &i : this->pool_sensors[p]) {out << " L  " << use_name(p, i) << "\n";}}
+    for (const int &p : this->pois) {out << " G  k_coverage(p" << p << ")\n";}
+
+    // COLUMNS. X: objective, use at each POI with the sensor in its pool and coverage of each covered POI
+    std::vector<std::vector<int>> uses((size_t)this->graph->num_sensors), covered((size_t)this->graph->num_sensors);
+    for (const int &p : this->pois) {
+        for (const int &i : this->pool_sensors[p]) {uses[i].push_back(p);}
+        for (const int &i : this->covering[p]) {covered[i].push_back(p);}
+    }
+    out << "COLUMNS\n";
+    for (const int &i : this->sensors) {
+        const std::string column = "x(i" + std::to_string(i) + ")";
+        entry(column, "obj", 1);
+        for (const int &p : uses[i]) {entry(column, use_name(p, i), -1); nonzeros++;}
+        for (const int &p : covered[i]) {entry(column, "k_coverage(p" + std::to_string(p) + ")", 1); nonzeros++;}
+    }
+
+    // Z: paths of its POI, and use of each of its sensors
+    for (const int &p : this->pois) {
+        for (path=0; path<(int)(this->pool->paths[p].size()); path++) {
+            const std::string column = z_name(p, path);
+            entry(column, "paths(p" + std::to_string(p) + ")", 1);
+            for (const int &i : this->pool->paths[p][path]) {entry(column, use_name(p, i), 1);}
+            nonzeros += 1 + (long long)(this->pool->paths[p][path].size());
+        }
+    }
+
+    out << "RHS\n";
+    for (const int &p : this->pois) {entry("rhs", "paths(p" + std::to_string(p) + ")", this->m);}
+    for (const int &p : this->pois) {entry("rhs", "k_coverage(p" + std::to_string(p) + ")", this->k);}
+
+    out << "BOUNDS\n";
+    for (const int &i : this->sensors) {out << " BV BND  x(i" << i << ")\n";}
+    for (const int &p : this->pois) {
+        for (path=0; path<(int)(this->pool->paths[p].size()); path++) {out << " BV BND  " << z_name(p, path) << "\n";}
+    }
+    out << "ENDATA\n";
+    return nonzeros;
+}
+
+
+long long KCMC_PathILP::write(const std::string &filename) {
+    std::ofstream out(filename);
+    if (not out.is_open()) {throw std::runtime_error("UNABLE TO OPEN " + filename);}
+
+    long long nonzeros;
+    if ((filename.size() > 3) and (filename.substr(filename.size()-3) == ".lp")) {nonzeros = this->write_lp(out);}
+    else if ((filename.size() > 4) and (filename.substr(filename.size()-4) == ".mps")) {nonzeros = this->write_mps(out);}
+    else {throw std::runtime_error("UNKNOWN MODEL FORMAT (USE .lp OR .mps) " + filename);}
+
+    out.close();
+    return nonzeros;
+}
+
+
+/* #####################################################################################################################
+ * MIP START
+ */
+
+
+/* FLOW EDGE
+ * Edge of the residual network used to find disjoint paths. Sensors are split in (2*i) and out (2*i+1) nodes
+ */
+struct FlowEdge {
+    int to, capacity, reverse, arc;
+    bool forward;
+};
+
+
+/** DISJOINT PATHS
+ * Up to M vertex-disjoint paths from the POI to the super-sink among the installed sensors, by augmenting paths on the
+ *   split network (an exact maximum flow, differently from the greedy paths of the heuristics).
+ * Each path is the sequence of arcs of the formulation it uses. Returns the number of paths
+ */
+int KCMC_ILP::disjoint_paths(const int poi, const std::vector<bool> &installed,
+                             std::vector<std::vector<int>> *paths) const {
+    const int source = 2*this->num_sensors, sink = source+1;
+    std::vector<std::vector<FlowEdge>> network((size_t)(sink+1));
+    auto add_edge = [&](const int from, const int to, const int arc) {
+        network[from].push_back({to, 1, (int)(network[to].size()), arc, true});
+        network[to].push_back({from, 0, (int)(network[from].size())-1, -1, false});
+    };
+
+    // Build the network: POI arcs, sensor capacities, sensor-sensor and sensor-sink arcs
+    for (const int &arc : this->out_arcs[poi]) {
+        if (installed[this->arcs[arc].head.index]) {add_edge(source, 2*this->arcs[arc].head.index, arc);}
+    }
+    for (const int &i : this->sensors) {
+        if (not installed[i]) {continue;}
+        add_edge(2*i, (2*i)+1, -1);
+        for (const int &arc : this->out_arcs[this->num_pois + i]) {
+            const Node &head = this->arcs[arc].head;
+            if (head.nodetype == tSINK) {add_edge((2*i)+1, sink, arc);}
+            else if (installed[head.index]) {add_edge((2*i)+1, 2*head.index, arc);}
+        }
+    }
+
+    // Augment (breadth-first) until M paths or no more augmenting paths
+    int num_paths, node;
+    std::vector<std::pair<int, int>> parent;  // Node and edge leading to each node
+    std::queue<int> queue;
+    for (num_paths=0; num_paths<this->m; num_paths++) {
+        parent.assign(network.size(), {-1, -1});
+        parent[source] = {source, -1};
+        queue.push(source);
+        while ((not queue.empty()) and (parent[sink].first == -1)) {
+            node = queue.front();
+            queue.pop();
+            for (int e=0; e<(int)(network[node].size()); e++) {
+                const FlowEdge &edge = network[node][e];
+                if ((edge.capacity > 0) and (parent[edge.to].first == -1)) {
+                    parent[edge.to] = {node, e};
+                    queue.push(edge.to);
+                }
+            }
+        }
+        std::queue<int>().swap(queue);
+        if (parent[sink].first == -1) {break;}
+        for (node=sink; node!=source; node=parent[node].first) {
+            FlowEdge &edge = network[parent[node].first][parent[node].second];
+            edge.capacity--;
+            network[node][edge.reverse].capacity++;
+        }
+    }
+
+    // Decompose the flow into paths, consuming the saturated forward edges
+    paths->assign((size_t)num_paths, std::vector<int>());
+    for (auto &path : *paths) {
+        for (node=source; node!=sink;) {
+            for (FlowEdge &edge : network[node]) {
+                if (edge.forward and (edge.capacity == 0)) {
+                    edge.capacity = 1;
+                    if (edge.arc >= 0) {path.push_back(edge.arc);}
+                    node = edge.to;
+                    break;
+                }
+            }
+        }
+    }
+    return num_paths;
+}
+
+
+/** MIP START WRITER
+ * Single-Flow: every path carries one unit of the POI commodity.
+ * Multi-Flow: the paths of each POI are matched to layers (augmenting paths, as a bipartite matching), such that
+ *   every sensor stays in a single layer. Installed sensors in no path (e.g. only for K-coverage) go to layer 0.
+ */
+int KCMC_ILP::write_start(std::ostream &out, std::unordered_set<int> &installed_sensors) {
+    int p, l, incomplete = 0;
+    std::vector<bool> installed((size_t)this->num_sensors, false);
+    for (const int &i : this->sensors) {installed[i] = isin(installed_sensors, i);}
+
+    // Layer of each installed sensor, and layer of each arc in the flow of the current POI (-1 if not in it)
+    std::vector<int> sensor_layer((size_t)this->num_sensors, -1), arc_layer(this->arcs.size(), -1);
+    std::vector<std::vector<int>> paths, poi_arcs(this->pois.size());
+    std::vector<std::vector<int>> poi_layers(this->pois.size());
+    std::vector<int> path_of_layer, layer_of_path;
+    std::vector<bool> visited;
+
+    // Sensors of a path (heads of its arcs) may join the layer if they are in no other layer
+    auto compatible = [&](const std::vector<int> &path, const int layer) {
+        for (const int &arc : path) {
+            const Node &head = this->arcs[arc].head;
+            if ((head.nodetype == tSENSOR) and (sensor_layer[head.index] != -1) and (sensor_layer[head.index] != layer)) {return false;}
+        }
+        return true;
+    };
+    std::function<bool(int)> match = [&](const int path) {
+        for (int layer=0; layer<this->num_layers; layer++) {
+            if (visited[layer] or (not compatible(paths[path], layer))) {continue;}
+            visited[layer] = true;
+            if ((path_of_layer[layer] == -1) or match(path_of_layer[layer])) {
+                path_of_layer[layer] = path;
+                layer_of_path[path] = layer;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    for (p=0; p<(int)(this->pois.size()); p++) {
+        int num_paths = this->disjoint_paths(this->pois[p], installed, &paths);
+        bool complete = (num_paths == this->m);
+
+        // Layers of the paths: all 0 in the Single-Flow model
+        layer_of_path.assign((size_t)num_paths, 0);
+        if (this->model == MULTI_FLOW) {
+            path_of_layer.assign((size_t)this->num_layers, -1);
+            layer_of_path.assign((size_t)num_paths, -1);
+            for (int path=0; path<num_paths; path++) {
+                visited.assign((size_t)this->num_layers, false);
+                complete = match(path) and complete;
+            }
+        }
+        for (int path=0; path<num_paths; path++) {
+            if (layer_of_path[path] == -1) {continue;}
+            for (const int &arc : paths[path]) {
+                poi_arcs[p].push_back(arc);
+                poi_layers[p].push_back(layer_of_path[path]);
+                const Node &head = this->arcs[arc].head;
+                if (head.nodetype == tSENSOR) {sensor_layer[head.index] = layer_of_path[path];}
+            }
+        }
+        if (not complete) {incomplete++;}
+    }
+    for (const int &i : this->sensors) {if (installed[i] and (sensor_layer[i] == -1)) {sensor_layer[i] = 0;}}
+
+    // Every column of the model, in the order of the writers
+    out << "# MIP start for KCMC " << ((this->model == MULTI_FLOW) ? "MULTI-FLOW" : "SINGLE-FLOW")
+        << " K" << this->k << " M" << this->m << ", objective " << installed_sensors.size()
+        << ", " << incomplete << " POIs with incomplete flow\n";
+    for (const int &i : this->sensors) {
+        for (l=0; l<this->num_layers; l++) {out << this->x_name(i, l) << " " << ((sensor_layer[i] == l) ? 1 : 0) << "\n";}
+    }
+    for (p=0; p<(int)(this->pois.size()); p++) {
+        for (size_t a=0; a<poi_arcs[p].size(); a++) {arc_layer[poi_arcs[p][a]] = poi_layers[p][a];}
+        for (int arc=0; arc<(int)(this->arcs.size()); arc++) {
+            for (l=0; l<this->num_layers; l++) {
+                out << this->y_name(arc, this->pois[p], l) << " " << ((arc_layer[arc] == l) ? 1 : 0) << "\n";
+            }
+        }
+        for (const int &arc : poi_arcs[p]) {arc_layer[arc] = -1;}
+    }
+    return incomplete;
+}
+
+
+int KCMC_ILP::write_start(const std::string &filename, std::unordered_set<int> &installed_sensors) {
+    std::ofstream out(filename);
+    if (not out.is_open()) {throw std::runtime_error("UNABLE TO OPEN " + filename);}
+    int incomplete = this->write_start(out, installed_sensors);
+    out.close();
+    return incomplete;
+}
+
+
+/* #####################################################################################################################
+ * MIP START CHECKER
+ */
+
+
+long long check_start(const std::string &mps_filename, const std::string &start_filename,
+                      std::ostream &report, const int max_reports) {
+    const double tolerance = 1e-6;
+    std::ifstream mps(mps_filename), start(start_filename);
+    if (not mps.is_open()) {throw std::runtime_error("UNABLE TO OPEN " + mps_filename);}
+    if (not start.is_open()) {throw std::runtime_error("UNABLE TO OPEN " + start_filename);}
+
+    // Buffers
+    std::string line, section, name, row, bound_type;
+    double value;
+    long long violations = 0;
+    std::unordered_map<std::string, int> row_index;
+    std::vector<std::string> row_names;
+    std::vector<char> row_type;
+    std::vector<double> rhs, activity;
+    std::unordered_map<std::string, std::vector<std::pair<int, double>>> columns;
+    std::unordered_map<std::string, std::pair<double, double>> bounds;
+    std::unordered_set<std::string> integers, given;
+    auto violation = [&](const std::string &message) {
+        if (violations < max_reports) {report << message << std::endl;}
+        violations++;
+    };
+
+    // Read the model. Section headers start at the first character, entries are indented
+    while (std::getline(mps, line)) {
+        if (line.empty() or (line[0] == '*')) {continue;}
+        std::istringstream tokens(line);
+        if (line[0] != ' ') {tokens >> section; continue;}
+        if (section == "ROWS") {
+            tokens >> bound_type >> name;
+            row_index[name] = (int)(row_names.size());
+            row_names.push_back(name);
+            row_type.push_back(bound_type[0]);
+        } else if (section == "COLUMNS") {
+            tokens >> name;
+            if (line.find("'MARKER'") != std::string::npos) {continue;}
+            auto &column = columns[name];
+            while (tokens >> row >> value) {column.emplace_back(row_index.at(row), value);}
+        } else if (section == "RHS") {
+            rhs.resize(row_names.size(), 0.0);
+            tokens >> name;
+            while (tokens >> row >> value) {rhs[row_index.at(row)] = value;}
+        } else if (section == "BOUNDS") {
+            tokens >> bound_type >> row >> name;
+            value = 0.0;
+            tokens >> value;
+            auto &bound = bounds.emplace(name, std::make_pair(0.0, HUGE_VAL)).first->second;
+            if (bound_type == "BV") {bound = {0.0, 1.0}; integers.insert(name);}
+            else if (bound_type == "FX") {bound = {value, value};}
+            else if (bound_type == "UP") {bound.second = value;}
+            else if (bound_type == "LO") {bound.first = value;}
+            else if (bound_type == "MI") {bound.first = -HUGE_VAL;}
+            else if (bound_type == "FR") {bound = {-HUGE_VAL, HUGE_VAL};}
+        }
+    }
+    rhs.resize(row_names.size(), 0.0);
+    activity.assign(row_names.size(), 0.0);
+
+    // Read the start, checking the bounds of the given variables
+    while (std::getline(start, line)) {
+        if (line.empty() or (line[0] == '#')) {continue;}
+        std::istringstream tokens(line);
+        tokens >> name >> value;
+        if (columns.find(name) == columns.end()) {violation("UNKNOWN VARIABLE " + name); continue;}
+        given.insert(name);
+        for (const auto &entry : columns[name]) {activity[entry.first] += entry.second * value;}
+        std::pair<double, double> bound = (bounds.find(name) != bounds.end()) ? bounds[name] : std::make_pair(0.0, HUGE_VAL);
+        if ((value < bound.first - tolerance) or (value > bound.second + tolerance)) {
+            violation("BOUND " + name + " = " + std::to_string(value));
+        } else if (isin(integers, name) and (std::abs(value - std::round(value)) > tolerance)) {
+            violation("INTEGRALITY " + name + " = " + std::to_string(value));
+        }
+    }
+
+    // Missing variables are 0, which violates positive lower bounds (e.g. fixed sensors)
+    for (const auto &bound : bounds) {
+        if ((bound.second.first > tolerance) and (not isin(given, bound.first))) {violation("BOUND " + bound.first + " MISSING");}
+    }
+
+    // Check every row but the objective
+    for (int r=0; r<(int)(row_names.size()); r++) {
+        bool ok;
+        switch (row_type[r]) {
+            case 'E': ok = std::abs(activity[r] - rhs[r]) <= tolerance; break;
+            case 'L': ok = activity[r] <= rhs[r] + tolerance; break;
+            case 'G': ok = activity[r] >= rhs[r] - tolerance; break;
+            default: continue;
+        }
+        if (not ok) {
+            violation("ROW " + row_names[r] + " " + row_type[r] + " " + std::to_string(rhs[r])
+                      + " HAS " + std::to_string(activity[r]));
+        }
+    }
+    return violations;
+}
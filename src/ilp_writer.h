@@ -0,0 +1,139 @@
+/** ILP_WRITER.h
+ * Writer of the Single-Flow and Multi-Flow ILP formulations of a KCMC instance, as LP or MPS files
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <string>    // string
+#include <vector>    // vector
+#include <ostream>   // ostream
+
+// Dependencies from this package
+#include "kcmc_instance.h"  // KCMC Instance class headers
+#include "path_pool.h"      // KCMC Path Pool headers
+
+
+#ifndef ILP_WRITER_H
+#define ILP_WRITER_H
+
+#define SINGLE_FLOW 0
+#define MULTI_FLOW 1
+#define PATH_SELECTION 2
+
+
+/* ARC
+ * Directed arc of the flow network: POI->sensor, sensor->sensor (both directions) or sensor->sink
+ */
+struct Arc {
+    Node tail, head;
+};
+
+
+/** KCMC ILP Object
+ * The same formulations of gurobi_models.py (gurobi_single_flow and gurobi_multi_flow), built directly from the
+ *   adjacencies of the instance and streamed to disk, so any solver can read them.
+ * The model may be restricted to a subset of sensors (all others inactive), as in the *_reuse_gurobi_* models.
+ * Names follow the Gurobi tupledicts, with parenthesis instead of brackets: x(i3), y(p0,i3,p0), x(i3,0), y(p0,i3,p0,0).
+ *   Rows are named as the constraint groups: flow_p(p0), flow_i(i3,p0), projection(i3,p0,0), k_coverage(p0), ...
+ */
+class KCMC_ILP {
+
+    public:
+        int k, m, model, num_layers;
+        bool y_binary;
+
+        /* Sets of the formulation
+         * P: every POI. I: every active sensor. A: every arc among active components
+         * Sinks are taken as a single super-sink (the Python models assume a single sink)
+         */
+        std::vector<int> pois, sensors;
+        std::vector<Arc> arcs;
+
+        /* Forced sensors (e.g. from the presolve), installed in every solution
+         * Single-Flow fixes their X to 1. Multi-Flow turns their disjunction into an equality (exactly one layer)
+         */
+        std::unordered_set<int> forced_sensors;
+
+        KCMC_ILP(KCMC_Instance *instance, int k, int m, int model, bool y_binary,
+                 std::unordered_set<int> &inactive_sensors);
+
+        /* Writers
+         * Write the model as CPLEX-LP or free-MPS. Return the number of non-zeros in the constraints matrix
+         * Write chooses the format from the file extension (.lp or .mps)
+         */
+        long long write_lp(std::ostream &out);
+        long long write_mps(std::ostream &out);
+        long long write(const std::string &filename);
+
+        /* MIP start
+         * Write a MIP start (Gurobi .mst format, "name value" lines) for a solution with the given installed sensors:
+         *   X of the installed sensors and Y of vertex-disjoint paths from each POI to the sinks among them.
+         * In the Multi-Flow model each path is given a layer, consistently with the layers of the previous POIs.
+         * Return the number of POIs whose flow could not be completed (their Y are partial, for the solver to repair)
+         */
+        int write_start(std::ostream &out, std::unordered_set<int> &installed_sensors);
+        int write_start(const std::string &filename, std::unordered_set<int> &installed_sensors);
+
+        /* Model dimensions and names
+         */
+        long long num_rows() const;
+        long long num_columns() const;
+        std::string x_name(int sensor, int layer) const;
+        std::string y_name(int arc, int poi, int layer) const;
+
+    private:
+        int num_pois, num_sensors;
+        std::vector<std::vector<int>> out_arcs, in_arcs;  // Arcs leaving (entering) each POI, sensor and sink
+        std::vector<std::vector<int>> covering, covered;  // Active sensors covering each POI, POIs covered by each sensor
+
+        int node_id(Node node) const;
+        std::string layered(const std::string &name, const std::string &index, int layer) const;
+        void write_flow_row(std::ostream &out, const std::string &row, int node, int poi, int layer, long long *nonzeros);
+        int disjoint_paths(int poi, const std::vector<bool> &installed, std::vector<std::vector<int>> *paths) const;
+};
+
+
+/** KCMC Path ILP Object
+ * Path-based (set selection) formulation over a pool of candidate paths of each POI (see KCMC_PathPool):
+ *   min sum x(i)
+ *   paths(p):      sum_j z(p,j) = M                        for each POI p
+ *   use(p,i):      sum_{j in p, i in j} z(p,j) - x(i) <= 0  for each POI p and sensor i in its pool
+ *   k_coverage(p): sum_{i covers p} x(i) >= K               for each POI p
+ * The use rows both install the sensors of the chosen paths and keep the paths of a POI vertex-disjoint.
+ * Much smaller than the arc-flow models, but only as complete as the pools: larger pools are closer to optimal.
+ */
+class KCMC_PathILP {
+
+    public:
+        int k, m, pool_size, num_short;  // POIs with less than M paths in their pools
+        std::vector<int> pois, sensors;
+        KCMC_PathPool *pool;
+
+        KCMC_PathILP(KCMC_Instance *instance, int k, int m, int pool_size, std::unordered_set<int> &inactive_sensors);
+        ~KCMC_PathILP();
+
+        long long write_lp(std::ostream &out);
+        long long write_mps(std::ostream &out);
+        long long write(const std::string &filename);
+
+        long long num_rows() const;
+        long long num_columns() const;
+
+    private:
+        KCMC_Graph *graph;
+        std::vector<std::vector<int>> covering;    // Active sensors covering each POI
+        std::vector<std::vector<int>> pool_sensors;  // Sensors in any path of the pool of each POI, in increasing order
+        std::vector<std::vector<std::vector<int>>> sensor_paths;  // Paths of the pool of each POI with each of those sensors
+};
+
+
+/** MIP START CHECKER
+ * Evaluates a MIP start (.mst) against every row and bound of a model in MPS format (as written by KCMC_ILP).
+ * Variables missing from the start are taken as 0. Violations are reported to the stream (up to max_reports).
+ * Returns the number of violated rows and bounds, and unknown variables
+ */
+long long check_start(const std::string &mps_filename, const std::string &start_filename,
+                      std::ostream &report, int max_reports);
+
+#endif
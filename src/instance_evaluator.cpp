@@ -9,6 +9,8 @@
 
 // Dependencies from this package
 #include "kcmc_instance.h"
+#include "kcmc_graph.h"     // Feasibility oracle
+#include "result_sink.h"    // Asynchronous output
 
 
 /* #####################################################################################################################
@@ -18,44 +20,89 @@
 
 void help() {
     std::cout << "Please, use the correct input for the KCMC instance evaluator:" << std::endl << std::endl;
-    std::cout << "./instance_evaluator <k> <m> <instance> <inactive+>" << std::endl;
+    std::cout << "./instance_evaluator [--report] <k> <m> <instance> <inactive+>" << std::endl;
+    std::cout << "./instance_evaluator [--report] <k> <m> <instance> --solution <solution>" << std::endl;
+    std::cout << "./instance_evaluator --limits <instance> <inactive+>" << std::endl;
+    std::cout << "./instance_evaluator --decode <solution>" << std::endl;
     std::cout << "  where:" << std::endl << std::endl;
+    std::cout << "--report lists EVERY POI lacking coverage or connectivity, instead of only the first failure" << std::endl;
+    std::cout << "--limits prints the largest K and M supported by the active sensors (exact connectivity)" << std::endl;
     std::cout << "K > 0 is the evaluated K coverage. If K <=0, the instance will not be evaluated but regenerated from its key, and M is ignored." << std::endl;
     std::cout << "M >= K is the evaluated M connectivity. Ignored if K <= 0" << std::endl;
     std::cout << "<instance> is the serialized KCMC instance" << std::endl;
     std::cout << "<inactive+> is the set of 0+ inactive sensors, as integers. Ignored if K <= 0" << std::endl;
+    std::cout << "<solution> is a solution as printed by the optimizers, in any --encoding (its inactive sensors are"
+              << " the zeros). --decode prints it in the --encoding of the results (by default, as 0/1 characters)" << std::endl;
+    std::cout << "--format <tsv|jsonl|binary> (optional, right after --stats and --trace) is the format of the results:"
+              << " TSV lines (default), JSON Lines, or the binary records described in result_sink.h" << std::endl;
+    std::cout << "--encoding <bits|delta|rle> (optional, with --format) is the encoding of printed solutions" << std::endl;
+    std::cout << "--stats (optional, before anything else) prints the hot-path counters to STDERR at exit."
+              << " Counters are only compiled in builds configured with -DKCMC_STATS=ON" << std::endl;
+    std::cout << "--trace <file> (optional, before anything else) writes a timeline of the phases (parse, level graph,"
+              << " path searches, floods, GA steps...) to the file at exit, as Chrome trace-event JSON" << std::endl;
     exit(0);
 }
 
 int main(int argc, char* const argv[]) {
+    {int skip = diagnostic_flags(argc, argv); argv += skip; argc -= skip;}  // --stats and --trace, at exit
+    {int skip = result_flags(argc, argv); argv += skip; argc -= skip;}  // --format and --encoding of the results
     if (argc < 3) { help(); }
 
     // Buffers
-    int k, m;
+    int k, m, arg = 1;
+    bool full_report = false;
     std::unordered_set<int> inactive_sensors;
     std::string serialized_instance, k_cov, m_conn;
 
-    /* Parse CMD SETTINGS */
-    k = atoi(argv[1]);
-    m = atoi(argv[2]);
-    serialized_instance = argv[3];
+    /* Parse CMD FLAGS */
+    if (std::string(argv[arg]) == "--decode") {
+        results().write(KCMC_Record().bits("solution", decode_solution(argv[arg+1])));
+        return 0;
+    }
+    if (std::string(argv[arg]) == "--limits") {
+        auto *instance = new KCMC_Instance(std::string(argv[arg+1]));
+        std::vector<char> allowed((size_t)instance->num_sensors, 1);
+        for (int i=arg+2; i<argc; i++) {allowed[atoi(argv[i])] = 0;}
+        KCMC_Graph graph(instance);
+        graph.limits(allowed, &k, &m);
+        results().write(KCMC_Record().integer("k_max", k, 0, ' ', "K-MAX: ").integer("m_max", m, 0, ' ', "\t|\tM-MAX: "));
+        return 0;
+    }
+    if (std::string(argv[arg]) == "--report") {full_report = true; arg++;}
+    if (argc < arg+3) { help(); }
 
-    // Parse the inactive sensors
-    if (argc > 3) {for (int i=4; i<argc; i++){inactive_sensors.insert(atoi(argv[i]));}}
+    /* Parse CMD SETTINGS */
+    k = atoi(argv[arg]);
+    m = atoi(argv[arg+1]);
+    serialized_instance = argv[arg+2];
+
+    // Parse the inactive sensors, listed or as the zeros of a solution
+    if ((argc == arg+5) and (std::string(argv[arg+3]) == "--solution")) {
+        std::vector<char> solution = decode_solution(argv[arg+4]);
+        for (int i=0; i<(int)(solution.size()); i++) {if (solution[i] == 0) {inactive_sensors.insert(i);}}
+    } else {
+        for (int i=arg+3; i<argc; i++){inactive_sensors.insert(atoi(argv[i]));}
+    }
 
     // De-serialize the instance
     auto *instance = new KCMC_Instance(serialized_instance);
 
     // If K <= 0, just print the instance and return
     if (k <= 0) {
-        printf("%s\n", instance->serialize().c_str());
+        results().write(KCMC_Record().text("instance", instance->serialize()));
+        return 0;
+    }
+
+    // Report every deficient POI, if required
+    if (full_report) {
+        results().write(KCMC_Record().text("report", instance->report(k, m, inactive_sensors)));
         return 0;
     }
 
     // Evaluate the instance, printinf the output
     k_cov = instance->k_coverage(k, inactive_sensors);
     m_conn = instance->m_connectivity(m, inactive_sensors);
-    printf("K-COV: %s\t|\tM-CON: %s", k_cov.c_str(), m_conn.c_str());
+    results().write(KCMC_Record().text("k_coverage", k_cov, "K-COV: ").text("m_connectivity", m_conn, "\t|\tM-CON: "));
 
     return 0;
 }
@@ -10,6 +10,8 @@
 
 // Dependencies from this package
 #include "kcmc_instance.h"
+#include "kcmc_graph.h"     // Feasibility oracle
+#include "result_sink.h"    // Asynchronous output
 
 
 /* #####################################################################################################################
@@ -17,13 +19,30 @@
  * */
 
 
+/** FEASIBLE PAIRS
+ * Every (K, M) pair up to the limits of the instance, K-major. The largest pair is the last one
+ */
+std::string feasible_pairs(KCMC_Instance *instance) {
+    int k_max, m_max;
+    KCMC_Graph graph(instance);
+    graph.limits(std::vector<char>((size_t)instance->num_sensors, 1), &k_max, &m_max);
+
+    std::string result;
+    for (int k=1; k<=k_max; k++) {
+        for (int m=1; m<=m_max; m++) {result += "(K" + std::to_string(k) + "M" + std::to_string(m) + ")";}
+    }
+    return result;
+}
+
+
 void help(int argc, char* const argv[]) {
     std::cout << "RECEIVED LINE (" << argc << "): ";
     for (int i=0; i<argc; i++) {std::cout << argv[i] << " ";}
     std::cout << std::endl;
     std::cout << "Please, use the correct input for the KCMC instance generator:" << std::endl << std::endl;
-    std::cout << "./instance_generator <p> <s> <k> <area_s> <cov_v> <com_r> <seed>+" << std::endl;
+    std::cout << "./instance_generator [--limits] <p> <s> <k> <area_s> <cov_v> <com_r> <seed>+" << std::endl;
     std::cout << "  where:" << std::endl << std::endl;
+    std::cout << "--limits tags each instance with every feasible (K, M) pair, as (K1M1)(K1M2)..., after a second '|'" << std::endl;
     std::cout << "p > 0 is the number of POIs to be randomly generated" << std::endl;
     std::cout << "s > 0 is the number of Sensors to be generated" << std::endl;
     std::cout << "k > 0 is the number of Sinks to be generated. If n=1, the sink will be placed at the center of the area" << std::endl;
@@ -33,13 +52,28 @@ void help(int argc, char* const argv[]) {
     std::cout << "seed is an integer number that is used as seed of the PRNG." << std::endl;
     std::cout << "++ If more than one seed is provided, many instances will be generated" << std::endl;
     std::cout << "++ If a single instance is provided, its de-serialization will be tested" << std::endl;
+    std::cout << "--format <tsv|jsonl|binary> (optional, right after --stats and --trace) is the format of the results:"
+              << " TSV lines (default), JSON Lines, or the binary records described in result_sink.h" << std::endl;
+    std::cout << "--stats (optional, before anything else) prints the hot-path counters to STDERR at exit."
+              << " Counters are only compiled in builds configured with -DKCMC_STATS=ON" << std::endl;
+    std::cout << "--trace <file> (optional, before anything else) writes a timeline of the phases (parse, level graph,"
+              << " path searches, floods, GA steps...) to the file at exit, as Chrome trace-event JSON" << std::endl;
     exit(0);
 }
 
 
 
 int main(int argc, char* const argv[]) {
+    {int skip = diagnostic_flags(argc, argv); argv += skip; argc -= skip;}  // --stats and --trace, at exit
+    {int skip = result_flags(argc, argv); argv += skip; argc -= skip;}  // --format and --encoding of the results
     if (argc < 7) {help(argc, argv);}
+    int arg = 1;
+    bool limits = false;
+
+    /* Parse CMD FLAGS */
+    if (std::string(argv[arg]) == "--limits") {limits = true; arg++;}
+    if (argc < arg+6) {help(argc, argv);}
+    const bool debug = (argc == arg+7);  // A single seed tests the de-serialization
 
     /* ======================== *
      * PARSE THE INPUT SETTINGS *
@@ -51,12 +85,12 @@ int main(int argc, char* const argv[]) {
     std::unordered_set<int> emptyset, ignoredset;
 
     /* Parse CMD SETTINGS */
-    num_pois    = atoi(argv[1]);
-    num_sensors = atoi(argv[2]);
-    num_sinks   = atoi(argv[3]);
-    area_side   = atoi(argv[4]);
-    coverage_radius = atoi(argv[5]);
-    communication_radius = atoi(argv[6]);
+    num_pois    = atoi(argv[arg]);
+    num_sensors = atoi(argv[arg+1]);
+    num_sinks   = atoi(argv[arg+2]);
+    area_side   = atoi(argv[arg+3]);
+    coverage_radius = atoi(argv[arg+4]);
+    communication_radius = atoi(argv[arg+5]);
 
     // Get a random previous seed
     srand(time(NULL) + getpid());  // Diferent seed in each run for each process
@@ -66,7 +100,7 @@ int main(int argc, char* const argv[]) {
      * GENERATE INSTANCES *
      * ================== */
 
-    for (i=7; i<argc; i++) {
+    for (i=arg+6; i<argc; i++) {
         random_seed = atoll(argv[i]);
 
         // FAIL-SAFE mode
@@ -90,35 +124,46 @@ int main(int argc, char* const argv[]) {
                 if (success == -1) {
                     success = instance->fast_m_connectivity(m, emptyset, &ignoredset);
                     if (success == -1) {
-                        //printf("%s | (K%dM%d)\n", instance->serialize().c_str(), k, m);
-                        printf("KCMC;%s;END | (K%dM%d)\n", instance->key().c_str(), k, m);
+                        KCMC_Record record;
+                        record.text("instance", "KCMC;" + instance->key() + ";END")
+                              .text("pair", "(K" + std::to_string(k) + "M" + std::to_string(m) + ")", " | ");
+                        if (limits) {record.text("limits", feasible_pairs(instance), " | ");}
+                        results().write(std::move(record));
                         previous_seed = random_seed + std::abs((rand() % 100000)) + 7;
                         break;
                     }
                 }
                 random_seed++;
             }
-            if (success != -1) {printf("UNABLE TO GENERATE VALID INSTANCE WITH PARAMETERS %d %d %d %d %d %d 0 %d %d\n",
-                                       num_pois, num_sensors, num_sinks, area_side, coverage_radius, communication_radius, k, m);}
+            if (success != -1) {
+                results().write(KCMC_Record().text("error", "UNABLE TO GENERATE VALID INSTANCE WITH PARAMETERS "
+                    + std::to_string(num_pois) + " " + std::to_string(num_sensors) + " " + std::to_string(num_sinks)
+                    + " " + std::to_string(area_side) + " " + std::to_string(coverage_radius)
+                    + " " + std::to_string(communication_radius) + " 0 " + std::to_string(k) + " " + std::to_string(m)));
+            }
         } else {
             // FAIL-PRONE MODE
             try {
                 auto *instance = new KCMC_Instance(num_pois, num_sensors, num_sinks,
                                                    area_side, coverage_radius, communication_radius,
                                                    random_seed);
-                printf("%s\n", instance->serialize().c_str());
+                KCMC_Record record;
+                record.text("instance", instance->serialize());
+                if (limits) {record.text("limits", feasible_pairs(instance), " | ");}
+                results().write(std::move(record));
 
                 /* FOR VERIFICATION */
-                if (argc == 8) {
+                if (debug) {
                     std::string serialized_instance = instance->serialize();
                     auto *new_instance = new KCMC_Instance(serialized_instance);
                     if (new_instance->serialize() == instance->serialize()) {
-                        printf("%s\nEQUAL\n", new_instance->serialize().c_str());
+                        results().write(KCMC_Record().text("instance", new_instance->serialize()));
+                        results().write(KCMC_Record().text("check", "EQUAL"));
                     } else { throw std::runtime_error("NOT EQUAL!"); }
                 }
 
             } catch (const std::exception &exc) {
-                if (argc == 8) { throw exc; }  // Only throw the exception if we're in DEBUG mode
+                if (debug) { throw exc; }  // Only throw the exception if we're in DEBUG mode
                 fprintf(stderr, "%lld\t%s\n", random_seed, exc.what());
             }
         }
@@ -8,6 +8,8 @@
 #include <sstream>    // ostringstream
 #include <random>     // mt19937, uniform_real_distribution
 #include <algorithm>  // std::find
+#include <thread>     // thread, hardware_concurrency
+#include <atomic>     // atomic
 
 // Dependencies from this package
 #include "kcmc_instance.h"  // KCMC Instance class headers
@@ -33,6 +35,7 @@ bool isin(std::vector<int> *ref, const int item){return std::find(ref->begin(),
  * Returns the set that is the difference between the given sets
  */
 std::unordered_set<int> set_diff(const std::unordered_set<int> &left, const std::unordered_set<int> &right) {
+    KCMC_COUNT(STAT_SET_ALLOC, 1);
     auto rightend = right.end();
     std::unordered_set<int> remainder;
     for (const int &item : left) {
@@ -71,6 +74,7 @@ void push(std::unordered_map<int, std::unordered_set<int>> &buffer, const int so
  * Adds a vote to an element in an unordered map. Adds the element to the map if not there
  */
 void vote(std::unordered_map<int, int> &buffer, const int target, const int value){
+    KCMC_COUNT(STAT_VOTE, 1);
     if (isin(buffer, target)){buffer[target] = buffer[target] + value;}
     else {buffer[target] = value;}
 }
@@ -89,6 +93,35 @@ void setify(std::unordered_set<int> &target, std::unordered_map<int, int> *refer
 }
 
 
+/* PARALLEL CHUNKS
+ * Runs the task over contiguous chunks of [0, size). Chunks are handed to the threads on demand, so a slow chunk does
+ * not hold back the others. With a single core (or a tiny range) the task runs in the calling thread.
+ */
+void parallel_chunks(const int size, const std::function<void(int, int)> &task) {
+    if (size < 1) {return;}
+
+    // Use as many threads as available, with at least a few chunks for each
+    int num_threads = (int)(std::thread::hardware_concurrency());
+    num_threads = (num_threads < 1) ? 1 : ((num_threads > size) ? size : num_threads);
+    if (num_threads == 1) {task(0, size); return;}
+    int chunk_size = (size / (num_threads * 4)) + 1;
+
+    // Each worker takes the next free chunk until there are none left
+    std::atomic<int> next_chunk(0);
+    auto worker = [&]() {
+        int begin;
+        while ((begin = next_chunk.fetch_add(chunk_size)) < size) {
+            KCMC_TRACE("parallel_chunk", "begin", begin);
+            task(begin, (begin + chunk_size < size) ? begin + chunk_size : size);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int i=1; i<num_threads; i++) {threads.emplace_back(worker);}
+    worker();  // The calling thread also works
+    for (auto &a_thread : threads) {a_thread.join();}
+}
+
+
 /* #####################################################################################################################
  * KCMC-PROBLEM K-COVERAGE METHODS
  */
@@ -121,6 +154,8 @@ int KCMC_Instance::fast_k_coverage(const int k, std::unordered_set<int> &inactiv
  * Very trivial k-coverage validator
  */
 int KCMC_Instance::fast_k_coverage(const int k, std::unordered_set<int> &inactive_sensors, std::unordered_set<int> *result_buffer) {
+    KCMC_TRACE("k_coverage");
+
     // Clear the set of active sensors
     result_buffer->clear();
 
@@ -0,0 +1,217 @@
+/*
+ * KCMC micro-benchmarks
+ * Repeatable timings of the hot paths of the KCMC_Module, on corpus instances and on synthetic scale-ups of them
+ */
+
+
+// STDLib Dependencies
+#include <chrono>     // time functions
+#include <cmath>      // sqrt
+#include <fstream>    // ifstream
+#include <functional> // function
+#include <iomanip>    // setprecision
+#include <iostream>   // cin, cout, endl
+
+// Dependencies from this package
+#include "kcmc_instance.h"
+#include "genetic_algorithm_operators.h"  // fitness_binary
+#include "kcmc_graph.h"                   // Feasibility oracle of the scale-ups
+#include "allocation_hook.h"              // Allocations of each batch
+
+
+/* #####################################################################################################################
+ * HARNESS
+ * */
+
+
+/** KCMC BENCH
+ * Access to the private path search of the instance
+ */
+class KCMC_Bench {
+    public:
+        static int find_path(KCMC_Instance *instance, int poi, std::unordered_set<int> &used_sensors,
+                             int level_graph[], int predecessors[]) {
+            return instance->find_path(poi, used_sensors, level_graph, predecessors);
+        }
+};
+
+
+/** BENCHMARK RUNNER
+ * Runs the operation in batches, doubling the batch until a batch takes at least min_time, and prints a line with:
+ * - The name of the benchmark and the key of the instance
+ * - The number of iterations of the last batch
+ * - Nanosseconds per operation, items per second (items per operation are given) and allocations per operation
+ * The first run is a warm-up. If it throws, the benchmark is skipped with a message to STDERR
+ */
+void run(const std::string &name, const std::string &filter, KCMC_Instance *instance, const long long items,
+         const double min_time, const std::function<void()> &operation) {
+    if ((not filter.empty()) and (name.find(filter) == std::string::npos)) {return;}
+
+    try {operation();}
+    catch (const std::exception &exc) {
+        std::cerr << "SKIPPED " << name << " ON " << instance->key() << ": " << exc.what() << std::endl;
+        return;
+    }
+
+    long long iterations = 1, allocations;
+    double elapsed;
+    while (true) {
+        allocations = allocation_counts().allocations;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (long long i=0; i<iterations; i++) {operation();}
+        auto end = std::chrono::high_resolution_clock::now();
+        allocations = allocation_counts().allocations - allocations;
+        elapsed = (double)(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        if ((elapsed >= min_time * 1e6) or (iterations >= (1LL << 30))) {break;}
+        iterations *= 2;
+    }
+
+    std::cout << name << "\t" << instance->key() << "\t" << iterations
+              << "\t" << std::fixed << std::setprecision(1) << (elapsed / (double)iterations)
+              << "\t" << std::setprecision(1) << ((double)(items * iterations) / (elapsed / 1e9))
+              << "\t" << std::setprecision(2) << ((double)allocations / (double)iterations) << std::endl;
+}
+
+
+/** BENCHMARK SUITE
+ * Every hot path on a single instance
+ */
+void suite(KCMC_Instance *instance, const int k, const int m, const std::string &filter, const double min_time) {
+    std::unordered_set<int> emptyset, used_sensors;
+    std::unordered_map<int, int> visited_sensors;
+    const std::string serialized = instance->serialize();
+    std::vector<int> levels((size_t)instance->num_sensors, 0), predecessors((size_t)instance->num_sensors, -2);
+    instance->level_graph(levels.data(), emptyset);
+
+    // A seeded random individual, with half of the sensors active
+    std::vector<int> individual((size_t)instance->num_sensors);
+    srand(0);
+    individual_creation(0.5, instance->num_sensors, individual.data());
+
+    run("regenerate", filter, instance, instance->num_sensors, min_time, [&]() {
+        delete new KCMC_Instance(instance->num_pois, instance->num_sensors, instance->num_sinks, instance->area_side,
+                                 instance->sensor_coverage_radius, instance->sensor_communication_radius,
+                                 instance->random_seed);
+    });
+    run("deserialize", filter, instance, (long long)serialized.size(), min_time, [&]() {
+        delete new KCMC_Instance(serialized);
+    });
+    run("serialize", filter, instance, (long long)serialized.size(), min_time, [&]() {
+        instance->serialize();
+    });
+    run("level_graph", filter, instance, instance->num_sensors, min_time, [&]() {
+        instance->level_graph(levels.data(), emptyset);
+    });
+    run("find_path", filter, instance, instance->num_pois, min_time, [&]() {
+        for (int poi=0; poi < instance->num_pois; poi++) {
+            std::fill(predecessors.begin(), predecessors.end(), -2);
+            KCMC_Bench::find_path(instance, poi, emptyset, levels.data(), predecessors.data());
+        }
+    });
+    run("fast_k_coverage", filter, instance, instance->num_pois, min_time, [&]() {
+        instance->fast_k_coverage(k, emptyset, &used_sensors);
+    });
+    run("fast_m_connectivity", filter, instance, instance->num_pois, min_time, [&]() {
+        instance->fast_m_connectivity(m, emptyset, &visited_sensors);
+    });
+    run("flood", filter, instance, instance->num_pois, min_time, [&]() {
+        instance->flood(k, m, false, emptyset, &visited_sensors);
+    });
+    run("flood_full", filter, instance, instance->num_pois, min_time, [&]() {
+        instance->flood(k, m, true, emptyset, &visited_sensors);
+    });
+    run("reuse", filter, instance, instance->num_pois, min_time, [&]() {
+        visited_sensors.clear();
+        instance->reuse(k, m, emptyset, &visited_sensors);
+    });
+    run("fitness_binary", filter, instance, instance->num_pois, min_time, [&]() {
+        fitness_binary(instance, k, m, 1.0, 1.0, individual.data());
+    });
+}
+
+
+/* #####################################################################################################################
+ * RUNTIME
+ * */
+
+
+void help() {
+    std::cout << "Please, use the correct input for the KCMC micro-benchmarks:" << std::endl << std::endl;
+    std::cout << "./kcmc_bench [--filter <name>] [--min-time <ms>] [--lines <n>] [--scale <factor>]* <corpus>+" << std::endl;
+    std::cout << "  where:" << std::endl << std::endl;
+    std::cout << "--filter (optional) runs only the benchmarks whose name contains the given text" << std::endl;
+    std::cout << "--min-time (optional) is the minimal time of the measured batch of each benchmark. Default 200 ms" << std::endl;
+    std::cout << "--lines (optional) is the number of instances read from each corpus file. Default 1" << std::endl;
+    std::cout << "--scale (optional, many) also runs a synthetic scale-up of each instance, with factor times the POIs"
+              << " and sensors in an area of the same density (same seed, sinks and radii). Default 4."
+              << " K and M are lowered to the largest the scale-up supports" << std::endl;
+    std::cout << "<corpus> is a file of instances, one per line, as KCMC;...;END | (K{k}M{m}) (i.e. data/instances.10.csv)"
+              << std::endl << std::endl;
+    std::cout << "Prints a line per benchmark and instance: name, instance key, iterations, ns/op, items/s and allocations/op."
+              << " Items are the sensors (regenerate, level_graph), bytes (deserialize, serialize) or POIs (others)" << std::endl;
+    std::cout << "--stats (optional, before anything else) prints the hot-path counters to STDERR at exit."
+              << " Counters are only compiled in builds configured with -DKCMC_STATS=ON" << std::endl;
+    std::cout << "--trace <file> (optional, before anything else) writes a timeline of the phases (parse, level graph,"
+              << " path searches, floods, GA steps...) to the file at exit, as Chrome trace-event JSON" << std::endl;
+    exit(0);
+}
+
+
+int main(int argc, char* const argv[]) {
+    {int skip = diagnostic_flags(argc, argv); argv += skip; argc -= skip;}  // --stats and --trace, at exit
+    if (argc < 2) { help(); }
+
+    // Optional leading flags
+    std::string filter;
+    double min_time = 200.0;
+    int num_lines = 1;
+    std::vector<int> scales;
+    while ((argc > 1) and (std::string(argv[1]).rfind("--", 0) == 0)) {
+        if (argc < 3) {help();}
+        if (std::string(argv[1]) == "--filter") {filter = argv[2];}
+        else if (std::string(argv[1]) == "--min-time") {min_time = std::stod(argv[2]);}
+        else if (std::string(argv[1]) == "--lines") {num_lines = std::stoi(argv[2]);}
+        else if (std::string(argv[1]) == "--scale") {scales.push_back(std::stoi(argv[2]));}
+        else {help();}
+        argv += 2; argc -= 2;
+    }
+    if (argc < 2) { help(); }
+    if (scales.empty()) {scales.push_back(4);}
+    allocation_counting(true);  // Allocations of every batch
+
+    // Print the header
+    printf("Benchmark\tInstance\tIterations\tns/op\titems/s\tallocs/op\n");
+
+    for (int arg=1; arg<argc; arg++) {
+        std::ifstream corpus(argv[arg]);
+        if (not corpus.is_open()) {throw std::runtime_error("UNABLE TO OPEN CORPUS " + std::string(argv[arg]) + "!");}
+        std::string line;
+        for (int i=0; (i < num_lines) and std::getline(corpus, line); i++) {
+
+            // Instance and pair of the line
+            size_t tag = line.find("(K");
+            if (tag == std::string::npos) {throw std::runtime_error("LINE WITHOUT (K{k}M{m}) TAG!");}
+            int k = std::stoi(line.substr(tag+2));
+            int m = std::stoi(line.substr(line.find('M', tag)+1));
+            std::string serialized = line.substr(0, line.find('|'));
+            serialized.erase(serialized.find_last_not_of(' ')+1);
+            auto *instance = new KCMC_Instance(serialized);
+            suite(instance, k, m, filter, min_time);
+
+            // Scale-ups, of the same density. The pair is lowered to the limits of the scale-up, if needed
+            for (const int &factor : scales) {
+                int k_max, m_max;
+                auto *scaled = new KCMC_Instance(instance->num_pois * factor, instance->num_sensors * factor,
+                                                 instance->num_sinks, (int)(instance->area_side * std::sqrt((double)factor)),
+                                                 instance->sensor_coverage_radius, instance->sensor_communication_radius,
+                                                 instance->random_seed);
+                KCMC_Graph graph(scaled);
+                graph.limits(std::vector<char>((size_t)scaled->num_sensors, 1), &k_max, &m_max);
+                suite(scaled, std::min(k, k_max), std::min(m, m_max), filter, min_time);
+                delete scaled;
+            }
+            delete instance;
+        }
+    }
+    return 0;
+}
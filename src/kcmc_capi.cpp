@@ -0,0 +1,184 @@
+/** KCMC_CAPI.cpp
+ * Plain C interface of the KCMC instance object
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <string>     // string
+#include <algorithm>  // copy
+
+// Dependencies from this package
+#include "kcmc_instance.h"  // KCMC Instance class headers
+#include "kcmc_graph.h"     // KCMC Graph (CSR) headers
+#include "lower_bounds.h"   // KCMC Lower Bounds headers
+#include "kcmc_capi.h"      // C interface headers
+
+
+/* HANDLE
+ * Owns the instance, its compact graph and the buffer of the last returned string
+ */
+struct kcmc_handle {
+    KCMC_Instance *instance;
+    KCMC_Graph *graph;
+    std::string buffer;
+};
+
+static thread_local std::string last_error;
+
+
+/* UTILITIES
+ * Conversions between solutions (arrays of bytes) and sets of inactive sensors
+ */
+static void inactive_set(kcmc_handle *handle, const unsigned char *solution, std::unordered_set<int> *inactive_sensors) {
+    inactive_sensors->clear();
+    for (int i=0; i<handle->instance->num_sensors; i++) {if (solution[i] == 0) {inactive_sensors->insert(i);}}
+}
+
+static void solution_array(kcmc_handle *handle, std::unordered_set<int> &used_sensors, unsigned char *solution) {
+    std::fill(solution, solution + handle->instance->num_sensors, 0);
+    for (const int &a_sensor : used_sensors) {solution[a_sensor] = 1;}
+}
+
+static kcmc_handle *wrap(KCMC_Instance *instance) {
+    auto *handle = new kcmc_handle;
+    handle->instance = instance;
+    handle->graph = new KCMC_Graph(instance);
+    return handle;
+}
+
+
+/* #####################################################################################################################
+ * C INTERFACE
+ */
+
+
+const char *kcmc_last_error() {return last_error.c_str();}
+
+
+kcmc_handle *kcmc_new(const char *serialized_instance) {
+    try {return wrap(new KCMC_Instance(std::string(serialized_instance)));}
+    catch (const std::exception &exc) {last_error = exc.what(); return nullptr;}
+}
+
+
+kcmc_handle *kcmc_new_random(const int num_pois, const int num_sensors, const int num_sinks,
+                             const int area_side, const int coverage_radius, const int communication_radius,
+                             const long long random_seed) {
+    try {
+        return wrap(new KCMC_Instance(num_pois, num_sensors, num_sinks,
+                                      area_side, coverage_radius, communication_radius, random_seed));
+    }
+    catch (const std::exception &exc) {last_error = exc.what(); return nullptr;}
+}
+
+
+void kcmc_free(kcmc_handle *handle) {
+    if (handle == nullptr) {return;}
+    delete handle->graph;
+    delete handle->instance;
+    delete handle;
+}
+
+
+void kcmc_dimensions(kcmc_handle *handle, int *dimensions) {
+    dimensions[0] = handle->instance->num_pois;
+    dimensions[1] = handle->instance->num_sensors;
+    dimensions[2] = handle->instance->num_sinks;
+}
+
+
+const char *kcmc_key(kcmc_handle *handle) {
+    handle->buffer = handle->instance->key();
+    return handle->buffer.c_str();
+}
+
+
+const char *kcmc_serialize(kcmc_handle *handle) {
+    handle->buffer = handle->instance->serialize();
+    return handle->buffer.c_str();
+}
+
+
+void kcmc_placements(kcmc_handle *handle, int *coordinates) {
+    KCMC_Instance *instance = handle->instance;
+    std::vector<Placement> pl_pois((size_t)instance->num_pois), pl_sensors((size_t)instance->num_sensors),
+                           pl_sinks((size_t)instance->num_sinks);
+    instance->get_placements(pl_pois.data(), pl_sensors.data(), pl_sinks.data());
+
+    int i = 0;
+    for (const Placement &pl : pl_pois) {coordinates[i++] = pl.x; coordinates[i++] = pl.y;}
+    for (const Placement &pl : pl_sensors) {coordinates[i++] = pl.x; coordinates[i++] = pl.y;}
+    for (const Placement &pl : pl_sinks) {coordinates[i++] = pl.x; coordinates[i++] = pl.y;}
+}
+
+
+int kcmc_adjacency(kcmc_handle *handle, const int adjacency,
+                   const int **offsets, int *num_offsets, const int **targets, int *num_targets) {
+    CSRAdjacency *source;
+    switch (adjacency) {
+        case KCMC_POI_SENSOR: source = &(handle->graph->poi_sensor); break;
+        case KCMC_SENSOR_SENSOR: source = &(handle->graph->sensor_sensor); break;
+        case KCMC_SENSOR_SINK: source = &(handle->graph->sensor_sink); break;
+        default: last_error = "UNKNOWN ADJACENCY!"; return -1;
+    }
+    *offsets = source->offsets.data();
+    *num_offsets = (int)(source->offsets.size());
+    *targets = source->targets.data();
+    *num_targets = (int)(source->targets.size());
+    return 0;
+}
+
+
+int kcmc_validate(kcmc_handle *handle, const int k, const int m, const unsigned char *solution) {
+    std::unordered_set<int> inactive_sensors;
+    inactive_set(handle, solution, &inactive_sensors);
+    try {return handle->instance->validate(false, k, m, inactive_sensors) ? 1 : 0;}
+    catch (const std::exception &exc) {last_error = exc.what(); return -1;}
+}
+
+
+int kcmc_report(kcmc_handle *handle, const int k, const int m, const unsigned char *solution,
+                int *triplets, const int capacity) {
+    std::unordered_set<int> inactive_sensors;
+    std::vector<POIDeficit> deficits;
+    inactive_set(handle, solution, &inactive_sensors);
+    try {handle->instance->deficiency_report(k, m, inactive_sensors, &deficits);}
+    catch (const std::exception &exc) {last_error = exc.what(); return -1;}
+    for (int i=0; (i < capacity) and (i < (int)(deficits.size())); i++) {
+        triplets[(3*i)] = deficits[i].poi;
+        triplets[(3*i)+1] = deficits[i].coverage;
+        triplets[(3*i)+2] = deficits[i].connectivity;
+    }
+    return (int)(deficits.size());
+}
+
+
+int kcmc_heuristic(kcmc_handle *handle, const char *heuristic, const int k, const int m, unsigned char *solution) {
+    std::unordered_set<int> emptyset, used_sensors;
+    int result;
+
+    // Same heuristics (and names) as the optimizer output
+    try {result = handle->instance->heuristic(std::string(heuristic), k, m, emptyset, &used_sensors);}
+    catch (const std::exception &exc) {last_error = exc.what(); return -1;}
+
+    solution_array(handle, used_sensors, solution);
+    return result;
+}
+
+
+int kcmc_lower_bound(kcmc_handle *handle, const int k, const int m, int *bounds) {
+    KCMC_Bounds result;
+    lower_bounds(handle->graph, k, m, &result);
+    bounds[0] = result.coverage;
+    bounds[1] = result.packing;
+    bounds[2] = result.hops;
+    return result.best;
+}
+
+
+void kcmc_limits(kcmc_handle *handle, const unsigned char *solution, int *limits) {
+    std::vector<char> allowed((size_t)handle->instance->num_sensors, 1);
+    if (solution != nullptr) {for (size_t i=0; i<allowed.size(); i++) {allowed[i] = (char)(solution[i] != 0);}}
+    handle->graph->limits(allowed, &(limits[0]), &(limits[1]));
+}
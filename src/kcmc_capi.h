@@ -0,0 +1,75 @@
+/** KCMC_CAPI.h
+ * Plain C interface of the KCMC instance object, for in-process use from other languages (i.e. Python ctypes)
+ * Jose F. R. Fonseca
+ *
+ * Instances are opaque handles. Functions that may fail return NULL or a negative value, and the reason can be read
+ *   with kcmc_last_error(). Strings and adjacency arrays belong to the handle and live until kcmc_free().
+ * Solutions are arrays of num_sensors bytes, 1 for active sensors and 0 for inactive ones.
+ */
+
+
+#ifndef KCMC_CAPI_H
+#define KCMC_CAPI_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KCMC_POI_SENSOR 0
+#define KCMC_SENSOR_SENSOR 1
+#define KCMC_SENSOR_SINK 2
+
+typedef struct kcmc_handle kcmc_handle;
+
+const char *kcmc_last_error();
+
+/* Construction and destruction
+ * From a serialized instance or its key (regenerated), or from the random-instance descriptors
+ */
+kcmc_handle *kcmc_new(const char *serialized_instance);
+kcmc_handle *kcmc_new_random(int num_pois, int num_sensors, int num_sinks,
+                             int area_side, int coverage_radius, int communication_radius, long long random_seed);
+void kcmc_free(kcmc_handle *handle);
+
+/* Basic services
+ * Dimensions are written as (num_pois, num_sensors, num_sinks)
+ * Placements are written as (x, y) pairs of every POI, then every sensor, then every sink
+ */
+void kcmc_dimensions(kcmc_handle *handle, int *dimensions);
+const char *kcmc_key(kcmc_handle *handle);
+const char *kcmc_serialize(kcmc_handle *handle);
+void kcmc_placements(kcmc_handle *handle, int *coordinates);
+
+/* Zero-copy CSR adjacency (KCMC_POI_SENSOR, KCMC_SENSOR_SENSOR or KCMC_SENSOR_SINK)
+ */
+int kcmc_adjacency(kcmc_handle *handle, int adjacency,
+                   const int **offsets, int *num_offsets, const int **targets, int *num_targets);
+
+/* Validation and diagnostics of a solution
+ * kcmc_validate returns 1 if valid, 0 if not. kcmc_report writes (poi, coverage, connectivity) triplets of up to
+ *   capacity deficient POIs and returns the total number of deficient POIs
+ */
+int kcmc_validate(kcmc_handle *handle, int k, int m, const unsigned char *solution);
+int kcmc_report(kcmc_handle *handle, int k, int m, const unsigned char *solution, int *triplets, int capacity);
+
+/* Heuristics
+ * Runs the named heuristic (dinic, min_flood, max_flood, no_reuse, min_reuse, max_reuse, best_reuse), writing its
+ *   solution. Returns the number of paths (flood) or sensors added for k-coverage (reuse), 0 for dinic
+ */
+int kcmc_heuristic(kcmc_handle *handle, const char *heuristic, int k, int m, unsigned char *solution);
+
+/* Lower bounds
+ * Writes the (coverage, packing, hops) lower bounds and returns the largest of them
+ */
+int kcmc_lower_bound(kcmc_handle *handle, int k, int m, int *bounds);
+
+/* Feasibility oracle
+ * Writes the largest supported (K, M) pair of the solution. With a NULL solution, every sensor is active
+ */
+void kcmc_limits(kcmc_handle *handle, const unsigned char *solution, int *limits);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,217 @@
+/*
+ * KCMC GA anytime benchmark
+ * Many seeded GA runs per instance, in parallel. Measures the time to reach a target solution size and the quality of
+ *   the best valid solution over time, so GA configurations are compared on quality per second
+ */
+
+
+// STDLib Dependencies
+#include <algorithm>  // sort, min
+#include <atomic>     // atomic
+#include <chrono>     // time functions
+#include <fstream>    // ifstream, ofstream
+#include <iostream>   // cin, cout, endl
+#include <sstream>    // ostringstream
+#include <thread>     // thread
+
+// Dependencies from this package
+#include "kcmc_instance.h"
+#include "kcmc_graph.h"                   // Lower bounds, as targets
+#include "lower_bounds.h"
+#include "genetic_algorithm_operators.h"  // genalg_binary, ga_seed, ga_fitness_cache
+
+
+/* GA RUN
+ * A seeded run of the GA on an instance of the corpus, and its trace of improvements
+ */
+struct GARun {
+    int instance, seed;
+    long long microseconds;
+    std::vector<GATracePoint> trace;
+};
+
+
+/** BEST VALID SO FAR
+ * Fewest active sensors among the valid improvements of the run up to the given time, or -1 if none is valid yet
+ */
+int best_valid(const GARun &run, const long long microseconds) {
+    int best = -1;
+    for (const GATracePoint &point : run.trace) {
+        if (point.microseconds > microseconds) {break;}
+        if (point.valid and ((best == -1) or (point.active < best))) {best = point.active;}
+    }
+    return best;
+}
+
+
+/* #####################################################################################################################
+ * RUNTIME
+ * */
+
+
+void help() {
+    std::cout << "Please, use the correct input for the KCMC GA anytime benchmark:" << std::endl << std::endl;
+    std::cout << "./kcmc_ga_bench [--runs <n>] [--threads <n>] [--generations <n>] [--target <target>] [--lines <n>]"
+              << " [--population <p>] [--selection <c>] [--mutation <r>] [--bias <o_b>]"
+              << " [--profile <file>] [--step <ms>] [--fitness-cache <MB>] <corpus>+" << std::endl;
+    std::cout << "  where:" << std::endl << std::endl;
+    std::cout << "--runs (optional) is the number of GA runs on each instance, seeded 1 to n. Default 10" << std::endl;
+    std::cout << "--threads (optional) is the number of concurrent runs. Default 0 (one per core)."
+              << " More threads than cores inflate the wall times" << std::endl;
+    std::cout << "--generations (optional) is the number of generations of each run. Default 200" << std::endl;
+    std::cout << "--target (optional) is the solution size to reach: a number, 'bound' (the lower bound of the instance)"
+              << " or the name of a heuristic of the optimizer (its solution size). Default best_reuse" << std::endl;
+    std::cout << "--lines (optional) is the number of instances read from each corpus file. Default 1" << std::endl;
+    std::cout << "--population, --selection, --mutation and --bias (optional) configure the GA."
+              << " Defaults 50, 10, 0.33 and 0.75 (weights are 1.0)" << std::endl;
+    std::cout << "--profile (optional) writes the anytime profile of each instance as CSV: the number of runs with a valid"
+              << " solution and the best, median and worst of their best valid sizes, every <step> ms. Default step 100 ms"
+              << std::endl;
+    std::cout << "--fitness-cache (optional) is the memory budget of the fitness caches of all the concurrent runs,"
+              << " split evenly among them (each run has its own cache). 0 disables them. Default 64" << std::endl;
+    std::cout << "<corpus> is a file of instances, one per line, as KCMC;...;END | (K{k}M{m}) (i.e. data/instances.10.csv)"
+              << std::endl << std::endl;
+    std::cout << "Prints a CSV line per run, with the time (ms) and generation at which the best individual was first"
+              << " valid with at most <target> sensors (-1 if never), and the final best solution" << std::endl;
+    std::cout << "--stats (optional, before anything else) prints the hot-path counters to STDERR at exit."
+              << " Counters are only compiled in builds configured with -DKCMC_STATS=ON" << std::endl;
+    std::cout << "--trace <file> (optional, before anything else) writes a timeline of the phases (parse, level graph,"
+              << " path searches, floods, GA steps...) to the file at exit, as Chrome trace-event JSON" << std::endl;
+    exit(0);
+}
+
+
+int main(int argc, char* const argv[]) {
+    {int skip = diagnostic_flags(argc, argv); argv += skip; argc -= skip;}  // --stats and --trace, at exit
+    if (argc < 2) { help(); }
+
+    // Optional leading flags
+    int num_runs = 10, num_threads = 0, num_generations = 200, num_lines = 1, pop_size = 50, sel_size = 10;
+    float mut_rate = 0.33, one_bias = 0.75;
+    double step = 100.0, cache_megabytes = 64.0;
+    std::string target_name = "best_reuse", profile_file;
+    while ((argc > 1) and (std::string(argv[1]).rfind("--", 0) == 0)) {
+        if (argc < 3) {help();}
+        const std::string flag = argv[1];
+        if (flag == "--runs") {num_runs = std::stoi(argv[2]);}
+        else if (flag == "--threads") {num_threads = std::stoi(argv[2]);}
+        else if (flag == "--generations") {num_generations = std::stoi(argv[2]);}
+        else if (flag == "--target") {target_name = argv[2];}
+        else if (flag == "--lines") {num_lines = std::stoi(argv[2]);}
+        else if (flag == "--population") {pop_size = std::stoi(argv[2]);}
+        else if (flag == "--selection") {sel_size = std::stoi(argv[2]);}
+        else if (flag == "--mutation") {mut_rate = std::stof(argv[2]);}
+        else if (flag == "--bias") {one_bias = std::stof(argv[2]);}
+        else if (flag == "--profile") {profile_file = argv[2];}
+        else if (flag == "--step") {step = std::stod(argv[2]);}
+        else if (flag == "--fitness-cache") {cache_megabytes = std::stod(argv[2]);}
+        else {help();}
+        argv += 2; argc -= 2;
+    }
+    if (argc < 2) { help(); }
+    if (num_threads < 1) {num_threads = (int)(std::thread::hardware_concurrency());}
+    if (num_threads < 1) {num_threads = 1;}
+    ga_fitness_cache((size_t)(cache_megabytes * 1024 * 1024 / num_threads));  // Per concurrent run
+
+    // Configuration label of the output
+    std::ostringstream config;
+    config << "P" << pop_size << "S" << sel_size << "R" << mut_rate << "B" << one_bias << "G" << num_generations;
+
+    // Read the corpus, with the pair and the target of each instance
+    std::vector<KCMC_Instance*> instances;
+    std::vector<int> ks, ms, targets;
+    std::unordered_set<int> emptyset, used_sensors;
+    for (int arg=1; arg<argc; arg++) {
+        std::ifstream corpus(argv[arg]);
+        if (not corpus.is_open()) {throw std::runtime_error("UNABLE TO OPEN CORPUS " + std::string(argv[arg]) + "!");}
+        std::string line;
+        for (int i=0; (i < num_lines) and std::getline(corpus, line); i++) {
+            size_t tag = line.find("(K");
+            if (tag == std::string::npos) {throw std::runtime_error("LINE WITHOUT (K{k}M{m}) TAG!");}
+            int k = std::stoi(line.substr(tag+2)), m = std::stoi(line.substr(line.find('M', tag)+1));
+            std::string serialized = line.substr(0, line.find('|'));
+            serialized.erase(serialized.find_last_not_of(' ')+1);
+            auto *instance = new KCMC_Instance(serialized);
+
+            int target;
+            if (target_name == "bound") {
+                KCMC_Graph graph(instance);
+                KCMC_Bounds bounds;
+                lower_bounds(&graph, k, m, &bounds);
+                target = bounds.best;
+            } else if (std::isdigit(target_name[0])) {target = std::stoi(target_name);}
+            else {
+                instance->heuristic(target_name, k, m, emptyset, &used_sensors);
+                target = (int)(used_sensors.size());
+            }
+            instances.push_back(instance);
+            ks.push_back(k);
+            ms.push_back(m);
+            targets.push_back(target);
+        }
+    }
+
+    // Every run, in parallel. Each thread seeds its own PRNG for each run
+    std::vector<GARun> runs;
+    for (int i=0; i<(int)(instances.size()); i++) {
+        for (int seed=1; seed<=num_runs; seed++) {runs.push_back({i, seed, 0, {}});}
+    }
+    std::atomic<int> next_run(0);
+    auto worker = [&]() {
+        std::unordered_set<int> unused_sensors;
+        int r;
+        while ((r = next_run.fetch_add(1)) < (int)(runs.size())) {
+            GARun &run = runs[r];
+            ga_seed((unsigned int)run.seed);
+            auto start = std::chrono::steady_clock::now();
+            genalg_binary(&unused_sensors, 0, num_generations, pop_size, sel_size, mut_rate, one_bias,
+                          instances[run.instance], ks[run.instance], ms[run.instance], 1.0, 1.0, nullptr, -1, &run.trace);
+            run.microseconds = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int t=1; t<num_threads; t++) {threads.emplace_back(worker);}
+    worker();
+    for (auto &a_thread : threads) {a_thread.join();}
+
+    // Time to target of each run
+    std::cout << "instance,config,seed,target,ttt_ms,ttt_generation,runtime_ms,best_active,best_valid" << std::endl;
+    for (const GARun &run : runs) {
+        double ttt_ms = -1.0;
+        int ttt_generation = -1;
+        for (const GATracePoint &point : run.trace) {
+            if (point.valid and (point.active <= targets[run.instance])) {
+                ttt_ms = (double)(point.microseconds) / 1000.0;
+                ttt_generation = point.generation;
+                break;
+            }
+        }
+        const GATracePoint &last = run.trace.back();  // The first generation is always an improvement
+        std::cout << instances[run.instance]->key() << "," << config.str() << "," << run.seed << ","
+                  << targets[run.instance] << "," << ttt_ms << "," << ttt_generation << ","
+                  << (double)(run.microseconds) / 1000.0 << "," << last.active << "," << (last.valid ? 1 : 0) << std::endl;
+    }
+
+    // Anytime profile of each instance
+    if (not profile_file.empty()) {
+        std::ofstream profile(profile_file);
+        profile << "instance,config,time_ms,runs_valid,best,median,worst" << std::endl;
+        for (int i=0; i<(int)(instances.size()); i++) {
+            long long horizon = 0;
+            for (const GARun &run : runs) {if (run.instance == i) {horizon = std::max(horizon, run.microseconds);}}
+            for (double t=0.0; t <= (double)horizon / 1000.0 + step; t += step) {
+                std::vector<int> sizes;
+                for (const GARun &run : runs) {
+                    if (run.instance != i) {continue;}
+                    int size = best_valid(run, (long long)(t * 1000.0));
+                    if (size >= 0) {sizes.push_back(size);}
+                }
+                std::sort(sizes.begin(), sizes.end());
+                profile << instances[i]->key() << "," << config.str() << "," << t << "," << sizes.size();
+                if (sizes.empty()) {profile << ",,," << std::endl;}
+                else {profile << "," << sizes.front() << "," << sizes[sizes.size() / 2] << "," << sizes.back() << std::endl;}
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,302 @@
+/** KCMC_GRAPH.cpp
+ * Compact (CSR) view of the adjacencies of a KCMC instance
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <algorithm>  // sort, fill
+#include <atomic>     // atomic
+#include <limits>     // numeric_limits
+
+// Dependencies from this package
+#include "kcmc_graph.h"  // KCMC Graph headers
+
+
+/** CSR BUILDER
+ * Flattens a HashMap of UnorderedSets into CSR arrays. Sources without entries in the HashMap have no neighbors.
+ */
+void csr(std::unordered_map<int, std::unordered_set<int>> &adjacency, const int num_sources, CSRAdjacency *target) {
+    target->offsets.assign((size_t)num_sources + 1, 0);
+    target->targets.clear();
+
+    for (int source=0; source<num_sources; source++) {
+        auto neighbors = adjacency.find(source);
+        if (neighbors != adjacency.end()) {
+            target->targets.insert(target->targets.end(), neighbors->second.begin(), neighbors->second.end());
+            std::sort(target->targets.begin() + target->offsets[source], target->targets.end());
+        }
+        target->offsets[source+1] = (int)(target->targets.size());
+    }
+}
+
+
+/** KCMC GRAPH CONSTRUCTOR
+ * Copies the adjacencies of the instance. Later changes to the instance are NOT reflected in the graph.
+ * The kernels get their own copy of the targets, in the narrowest index type
+ */
+KCMC_Graph::KCMC_Graph(KCMC_Instance *instance) {
+    this->num_pois = instance->num_pois;
+    this->num_sensors = instance->num_sensors;
+    this->num_sinks = instance->num_sinks;
+    csr(instance->poi_sensor, this->num_pois, &(this->poi_sensor));
+    csr(instance->sensor_sensor, this->num_sensors, &(this->sensor_sensor));
+    csr(instance->sensor_sink, this->num_sensors, &(this->sensor_sink));
+
+    // Narrowest index type of the kernels (with room for the NONE, SOURCE and SINK markers)
+    this->index_bits = (this->num_sensors < 65533) ? 16 : 32;
+    if (this->index_bits == 16) {this->narrow.build(this->poi_sensor, this->sensor_sensor, this->sensor_sink, this->num_sensors);}
+    else {this->wide.build(this->poi_sensor, this->sensor_sensor, this->sensor_sink, this->num_sensors);}
+}
+
+
+/* #####################################################################################################################
+ * COMPACT GRAPH KERNELS
+ */
+
+
+/* FLOW WORKSPACE
+ * Flow (successor and predecessor of each sensor, NONE if it carries no path) and search buffers (parent of each
+ *   state, visited in the current search if its mark is the current epoch). Between calls, every sensor is NONE
+ */
+template<typename Index>
+struct FlowWorkspace {
+    std::vector<Index> next, prev;
+    std::vector<uint32_t> parent, visited, queue;
+    std::vector<std::pair<Index, Index>> added;
+    std::vector<Index> touched;
+    uint32_t epoch = 0;
+};
+
+
+template<typename Index>
+void KCMC_CompactGraph<Index>::build(const CSRAdjacency &poi_sensor, const CSRAdjacency &sensor_sensor,
+                                     const CSRAdjacency &sensor_sink, const int num_sensors) {
+    this->num_sensors = num_sensors;
+    this->poi_offsets.assign(poi_sensor.offsets.begin(), poi_sensor.offsets.end());
+    this->poi_targets.assign(poi_sensor.targets.begin(), poi_sensor.targets.end());
+    this->sensor_offsets.assign(sensor_sensor.offsets.begin(), sensor_sensor.offsets.end());
+    this->sensor_targets.assign(sensor_sensor.targets.begin(), sensor_sensor.targets.end());
+    this->sink_adjacent.assign((size_t)num_sensors, 0);
+    for (int sensor=0; sensor<num_sensors; sensor++) {
+        this->sink_adjacent[sensor] = (char)(sensor_sink.offsets[sensor+1] > sensor_sink.offsets[sensor]);
+    }
+}
+
+
+template<typename Index>
+int KCMC_CompactGraph<Index>::coverage(const int poi, const std::vector<char> &allowed) const {
+    int result = 0;
+    for (uint32_t i=this->poi_offsets[poi]; i<this->poi_offsets[poi+1]; i++) {
+        if (allowed[this->poi_targets[i]]) {result++;}
+    }
+    return result;
+}
+
+
+/** DISJOINT PATHS
+ * Sensors are split in an entry (2*i) and an exit (2*i+1) state, with unit capacity between them. As each sensor
+ *   carries at most one path, the flow is kept as the successor and predecessor of each sensor (SINK or SOURCE at
+ *   the ends). Residual moves: the POI enters its free covering sensors; the entry of a free sensor reaches its exit,
+ *   and the entry of a used one goes back to the exit of its predecessor; the exit of a sensor reaches unused arcs
+ *   and, if used, goes back to its own entry.
+ */
+template<typename Index>
+int KCMC_CompactGraph<Index>::disjoint_paths(const int poi, const int max_paths, const std::vector<char> &allowed,
+                                             std::vector<std::vector<int>> *paths) const {
+    const Index NONE = std::numeric_limits<Index>::max(), SOURCE = NONE - 1, SINK = NONE - 2;
+    const uint32_t source_state = 2 * (uint32_t)this->num_sensors, sink_state = source_state + 1;
+    thread_local FlowWorkspace<Index> work;
+    if (work.next.size() < (size_t)this->num_sensors) {
+        work.next.resize((size_t)this->num_sensors, NONE);
+        work.prev.resize((size_t)this->num_sensors, NONE);
+    }
+    if (work.visited.size() < (size_t)sink_state + 1) {
+        work.visited.resize((size_t)sink_state + 1, 0);
+        work.parent.resize((size_t)sink_state + 1);
+    }
+    std::vector<Index> &next = work.next, &prev = work.prev;
+    std::vector<uint32_t> &parent = work.parent, &visited = work.visited, &queue = work.queue;
+    work.touched.clear();
+    int num_paths = 0;
+    uint32_t state;
+    Index sensor;
+
+    // Starting flow
+    for (const auto &path : *paths) {
+        if (path.empty()) {continue;}
+        for (size_t j=0; j<path.size(); j++) {
+            prev[path[j]] = (j == 0) ? SOURCE : (Index)path[j-1];
+            next[path[j]] = (j+1 == path.size()) ? SINK : (Index)path[j+1];
+            work.touched.push_back((Index)path[j]);
+        }
+        num_paths++;
+    }
+
+    while (num_paths < max_paths) {
+        // Breadth-first search of an augmenting path
+        if (++work.epoch == 0) {std::fill(visited.begin(), visited.end(), 0); work.epoch = 1;}
+        const uint32_t epoch = work.epoch;
+        queue.clear();
+        auto visit = [&](const uint32_t from, const uint32_t to) {
+            if (visited[to] != epoch) {visited[to] = epoch; parent[to] = from; queue.push_back(to);}
+        };
+        visit(source_state, source_state);
+        for (size_t head=0; (head<queue.size()) and (visited[sink_state] != epoch); head++) {
+            state = queue[head];
+            if (state == source_state) {
+                for (uint32_t i=this->poi_offsets[poi]; i<this->poi_offsets[poi+1]; i++) {
+                    sensor = this->poi_targets[i];
+                    if (allowed[sensor] and (prev[sensor] != SOURCE)) {visit(state, 2 * (uint32_t)sensor);}
+                }
+                continue;
+            }
+            sensor = (Index)(state / 2);
+            if ((state % 2) == 0) {  // Entry
+                if (prev[sensor] == NONE) {visit(state, state+1);}
+                else if (prev[sensor] < SINK) {visit(state, (2 * (uint32_t)prev[sensor]) + 1);}
+                continue;
+            }
+            // Exit
+            if ((next[sensor] != SINK) and this->sink_adjacent[sensor]) {visit(state, sink_state);}
+            for (uint32_t i=this->sensor_offsets[sensor]; i<this->sensor_offsets[sensor+1]; i++) {
+                const Index neighbor = this->sensor_targets[i];
+                if (allowed[neighbor] and (next[sensor] != neighbor)) {visit(state, 2 * (uint32_t)neighbor);}
+            }
+            if (prev[sensor] != NONE) {visit(state, state-1);}
+        }
+        if (visited[sink_state] != epoch) {break;}
+
+        // Augment: cancel the reversed arcs first, then add the forward ones
+        work.added.clear();
+        for (state=sink_state; state!=source_state; state=parent[state]) {
+            const uint32_t from = parent[state];
+            const Index tail = (from == source_state) ? SOURCE : (Index)(from / 2),
+                        head = (state == sink_state) ? SINK : (Index)(state / 2);
+            if ((from == source_state) or (state == sink_state) or (((from % 2) == 1) and ((state % 2) == 0) and (tail != head))) {
+                work.added.emplace_back(tail, head);  // Forward arc
+            } else if (((from % 2) == 0) and ((state % 2) == 1) and (tail != head)) {
+                next[head] = NONE;  // Reversed arc head->tail
+                prev[tail] = NONE;
+            }
+        }
+        for (const auto &arc : work.added) {
+            if (arc.first < SINK) {next[arc.first] = arc.second; work.touched.push_back(arc.first);}
+            if (arc.second < SINK) {prev[arc.second] = arc.first; work.touched.push_back(arc.second);}
+        }
+        num_paths++;
+    }
+
+    // Decompose the flow
+    paths->clear();
+    for (uint32_t i=this->poi_offsets[poi]; i<this->poi_offsets[poi+1]; i++) {
+        sensor = this->poi_targets[i];
+        if (prev[sensor] != SOURCE) {continue;}
+        paths->emplace_back();
+        for (; sensor!=SINK; sensor=next[sensor]) {paths->back().push_back((int)sensor);}
+    }
+
+    // Leave the workspace without flow for the next call
+    for (const Index &a_sensor : work.touched) {next[a_sensor] = NONE; prev[a_sensor] = NONE;}
+    return num_paths;
+}
+
+
+template class KCMC_CompactGraph<uint16_t>;
+template class KCMC_CompactGraph<uint32_t>;
+
+
+/* #####################################################################################################################
+ * EXACT CONNECTIVITY
+ */
+
+
+int KCMC_Graph::coverage(const int poi, const std::vector<char> &allowed) const {
+    return (this->index_bits == 16) ? this->narrow.coverage(poi, allowed) : this->wide.coverage(poi, allowed);
+}
+
+
+int KCMC_Graph::disjoint_paths(const int poi, const int max_paths, const std::vector<char> &allowed,
+                               std::vector<std::vector<int>> *paths) const {
+    return (this->index_bits == 16) ? this->narrow.disjoint_paths(poi, max_paths, allowed, paths)
+                                    : this->wide.disjoint_paths(poi, max_paths, allowed, paths);
+}
+
+
+/** FEASIBILITY ORACLE
+ * The running minimum connectivity caps the flow of the following POIs, as no POI may raise it: most POIs stop
+ *   after a few augmentations. M is also capped by the coverage of the POI and by the allowed sensors next to sinks
+ */
+void KCMC_Graph::limits(const std::vector<char> &allowed, int *k_max, int *m_max) const {
+    int sink_neighbors = 0;
+    for (int sensor=0; sensor<this->num_sensors; sensor++) {
+        if (allowed[sensor] and (this->sensor_sink.offsets[sensor+1] > this->sensor_sink.offsets[sensor])) {
+            sink_neighbors++;
+        }
+    }
+    std::atomic<int> min_coverage(this->num_sensors), min_connectivity(sink_neighbors);
+
+    // Lowers the shared minimum, if the value is smaller
+    auto lower = [](std::atomic<int> &minimum, const int value) {
+        int current = minimum.load();
+        while ((value < current) and (not minimum.compare_exchange_weak(current, value))) {}
+    };
+
+    parallel_chunks(this->num_pois, [&](const int begin, const int end) {
+        std::vector<std::vector<int>> paths;
+        for (int poi=begin; poi<end; poi++) {
+            const int poi_coverage = this->coverage(poi, allowed);
+            lower(min_coverage, poi_coverage);
+            const int cap = std::min(poi_coverage, min_connectivity.load());
+            if (cap < 1) {lower(min_connectivity, 0); continue;}
+            paths.clear();
+            lower(min_connectivity, this->disjoint_paths(poi, cap, allowed, &paths));
+        }
+    });
+
+    *k_max = min_coverage.load();
+    *m_max = min_connectivity.load();
+}
+
+
+/** REPAIR
+ * Repairing a POI may also repair the following ones (they share sensors), so deficient POIs are checked again
+ *   before their own repair
+ */
+int KCMC_Graph::repair(const int k, const int m, std::vector<char> *active) const {
+    std::vector<char> deficient((size_t)this->num_pois, 0), everything((size_t)this->num_sensors, 1);
+    auto is_deficient = [&](const int poi, std::vector<std::vector<int>> *paths) {
+        paths->clear();
+        return (this->coverage(poi, *active) < k) or (this->disjoint_paths(poi, m, *active, paths) < m);
+    };
+
+    parallel_chunks(this->num_pois, [&](const int begin, const int end) {
+        std::vector<std::vector<int>> paths;
+        for (int poi=begin; poi<end; poi++) {deficient[poi] = (char)is_deficient(poi, &paths);}
+    });
+
+    int added = 0;
+    std::vector<std::vector<int>> paths;
+    for (int poi=0; poi<this->num_pois; poi++) {
+        if ((not deficient[poi]) or (not is_deficient(poi, &paths))) {continue;}
+
+        // Connectivity, augmenting the paths among the active sensors
+        paths.clear();
+        if (this->disjoint_paths(poi, m, *active, &paths) < m) {
+            this->disjoint_paths(poi, m, everything, &paths);
+            for (const auto &path : paths) {
+                for (const int &sensor : path) {
+                    if (not (*active)[sensor]) {(*active)[sensor] = 1; added++;}
+                }
+            }
+        }
+
+        // Coverage, by the first inactive covering sensors (the paths already cover it)
+        int missing = k - this->coverage(poi, *active);
+        for (int i=this->poi_sensor.offsets[poi]; (i<this->poi_sensor.offsets[poi+1]) and (missing > 0); i++) {
+            const int sensor = this->poi_sensor.targets[i];
+            if (not (*active)[sensor]) {(*active)[sensor] = 1; added++; missing--;}
+        }
+    }
+    return added;
+}
@@ -0,0 +1,102 @@
+/** KCMC_GRAPH.h
+ * Compact (CSR) view of the adjacencies of a KCMC instance
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <vector>         // vector object
+#include <cstdint>        // uint16_t, uint32_t
+
+// Dependencies from this package
+#include "kcmc_instance.h"  // KCMC Instance class headers
+
+
+#ifndef KCMC_GRAPH_H
+#define KCMC_GRAPH_H
+
+
+/* CSR ADJACENCY
+ * Compressed Sparse Row adjacency. The neighbors of source i are targets[offsets[i]] to targets[offsets[i+1]-1],
+ * in increasing order. There are always (number of sources + 1) offsets.
+ */
+struct CSRAdjacency {
+    std::vector<int> offsets, targets;
+};
+
+void csr(std::unordered_map<int, std::unordered_set<int>> &adjacency, int num_sources, CSRAdjacency *target);
+
+
+/** KCMC Compact Graph
+ * The kernels of exact connectivity over a copy of the POI-sensor and sensor-sensor targets in the narrowest index
+ *   type that holds every sensor (and three markers). Instances with fewer than 65533 sensors (most of them) use
+ *   uint16_t, halving the bytes the augmenting path searches read. Sinks are a flag of each sensor.
+ * The kernels are compiled for each index type (uint16_t and uint32_t), and each thread keeps its own workspace of
+ *   the flow and the search (reset only where the previous call wrote), so calls do not allocate per sensor.
+ */
+template<typename Index>
+class KCMC_CompactGraph {
+
+    public:
+        void build(const CSRAdjacency &poi_sensor, const CSRAdjacency &sensor_sensor, const CSRAdjacency &sensor_sink,
+                   int num_sensors);
+        int disjoint_paths(int poi, int max_paths, const std::vector<char> &allowed,
+                           std::vector<std::vector<int>> *paths) const;
+        int coverage(int poi, const std::vector<char> &allowed) const;
+
+    private:
+        int num_sensors = 0;
+        std::vector<uint32_t> poi_offsets, sensor_offsets;
+        std::vector<Index> poi_targets, sensor_targets;
+        std::vector<char> sink_adjacent;
+};
+
+
+/** KCMC Graph Object
+ * Read-only, contiguous copy of the POI-sensor, sensor-sensor and sensor-sink adjacencies of a KCMC_Instance.
+ * Contiguous arrays are cheap to iterate and to share with other languages without copies.
+ */
+class KCMC_Graph {
+
+    public:
+        int num_pois, num_sensors, num_sinks;
+        CSRAdjacency poi_sensor, sensor_sensor, sensor_sink;
+
+        /* Index width
+         * Bits of the indexes of the compact graph of the kernels, chosen by the number of sensors (16 or 32)
+         */
+        int index_bits;
+
+        explicit KCMC_Graph(KCMC_Instance *instance);
+
+        /* Exact connectivity
+         * Vertex-disjoint paths from the POI to any sink among the allowed sensors, by augmenting paths (an exact
+         *   maximum flow, unlike the greedy paths of the heuristics). Paths already in the buffer (disjoint, among
+         *   allowed sensors) are the starting flow, so a POI that lost one path is repaired with a single augmentation.
+         * Returns the number of paths (at most max_paths). Each path is its sequence of sensors
+         * Coverage is the number of allowed sensors covering the POI
+         */
+        int disjoint_paths(int poi, int max_paths, const std::vector<char> &allowed,
+                           std::vector<std::vector<int>> *paths) const;
+        int coverage(int poi, const std::vector<char> &allowed) const;
+
+        /* Feasibility oracle
+         * Largest K and M the allowed sensors support: the smallest coverage and the smallest exact connectivity
+         *   among all POIs. Every pair (k <= K_max, m <= M_max) is feasible, and no other pair is. POIs run in parallel
+         */
+        void limits(const std::vector<char> &allowed, int *k_max, int *m_max) const;
+
+        /* Repair
+         * Activates sensors until every POI has K-coverage and M-connectivity among the active ones (if the instance
+         *   allows it): augmenting paths over every sensor, starting from the paths among the active ones, then the
+         *   missing covering sensors. POIs are checked in parallel, and only the deficient ones are repaired, in
+         *   order. Returns the number of activated sensors
+         */
+        int repair(int k, int m, std::vector<char> *active) const;
+
+    private:
+        KCMC_CompactGraph<uint16_t> narrow;  // Only built if index_bits is 16
+        KCMC_CompactGraph<uint32_t> wide;    // Only built if index_bits is 32
+};
+
+#endif
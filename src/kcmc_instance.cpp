@@ -7,7 +7,11 @@
 // STDLib dependencies
 #include <sstream>    // ostringstream
 #include <random>     // mt19937, uniform_real_distribution
-#include <algorithm>  // std::find
+#include <cstdlib>    // strtol
+#include <algorithm>  // std::find, sort, min, max
+#include <numeric>    // iota
+#include <utility>    // pair
+#include <stdexcept>  // runtime_error
 
 // Dependencies from this package
 #include "kcmc_instance.h"  // KCMC Instance class headers
@@ -62,6 +66,39 @@ void KCMC_Instance::get_placements(Placement *pl_pois, Placement *pl_sensors, Pl
 }
 
 
+/** PLACEMENT GRID
+ * Square cells of the area, each with the indexes of the placements in it (in increasing order).
+ * Placements are only compared to the ones in the 3x3 cells around them, instead of to every other placement.
+ * The grid has at most 1024 cells per side, so cells may be larger than the radius (never smaller)
+ */
+PlacementGrid::PlacementGrid(const std::vector<Placement> &placements, const int area_side, const int radius) {
+    this->cell_side = std::max(std::max(radius, 1), (area_side / 1024) + 1);
+    this->num_cells = (area_side / this->cell_side) + 1;
+    this->cells.resize((size_t)this->num_cells * (size_t)this->num_cells);
+    for (int i=0; i<(int)(placements.size()); i++) {this->cells[this->cell(placements[i].x, placements[i].y)].push_back(i);}
+}
+
+size_t PlacementGrid::cell(const int x, const int y) const {
+    int cx = std::min(std::max(x / this->cell_side, 0), this->num_cells - 1),
+        cy = std::min(std::max(y / this->cell_side, 0), this->num_cells - 1);
+    return (size_t)cx * (size_t)this->num_cells + (size_t)cy;
+}
+
+void PlacementGrid::neighborhood(const Placement &center, const int after, std::vector<int> *candidates) const {
+    candidates->clear();
+    int cx = std::min(std::max(center.x / this->cell_side, 0), this->num_cells - 1),
+        cy = std::min(std::max(center.y / this->cell_side, 0), this->num_cells - 1);
+    for (int x = std::max(cx-1, 0); x <= std::min(cx+1, this->num_cells-1); x++) {
+        for (int y = std::max(cy-1, 0); y <= std::min(cy+1, this->num_cells-1); y++) {
+            for (const int &index : this->cells[(size_t)x * (size_t)this->num_cells + (size_t)y]) {
+                if (index > after) {candidates->push_back(index);}
+            }
+        }
+    }
+    std::sort(candidates->begin(), candidates->end());
+}
+
+
 /** RANDOM-INSTANCE (RE)GENERATOR
  * Generates the instance's placements and edges, assuming the instance already have all main attributes
  */
@@ -69,21 +106,31 @@ void KCMC_Instance::regenerate() {
     /** Random-instance (re)generator
      * This constructor is used only to generate a new random instance that already has the seed attributes
      */
+    KCMC_TRACE("regenerate");
 
     // Prepare iteration buffers
-    int i, j;
+    int i;
+    std::vector<int> candidates;
 
     // Prepare the placement buffers. The scope of these buffers is only the constructor itself
-    Placement pl_pois[this->num_pois], pl_sensors[this->num_sensors], pl_sinks[this->num_sinks];
+    std::vector<Placement> pl_pois((size_t)this->num_pois), pl_sensors((size_t)this->num_sensors),
+                           pl_sinks((size_t)this->num_sinks);
 
     // Get the placemens of the instance objects
-    this->get_placements(pl_pois, pl_sensors, pl_sinks, true);  // Use the private version, that pushes components
+    this->get_placements(pl_pois.data(), pl_sensors.data(), pl_sinks.data(), true);  // Use the private version, that pushes components
 
-    // Iterate each sensor and find its connections
+    // Buckets of POIs, sensors and sinks in a grid of cells no smaller than both radii, so any neighbor is in an
+    // adjacent cell
+    PlacementGrid poi_grid(pl_pois, this->area_side, std::max(this->sensor_coverage_radius, this->sensor_communication_radius)),
+                  sensor_grid(pl_sensors, this->area_side, std::max(this->sensor_coverage_radius, this->sensor_communication_radius)),
+                  sink_grid(pl_sinks, this->area_side, std::max(this->sensor_coverage_radius, this->sensor_communication_radius));
+
+    // Iterate each sensor and find its connections. Candidates are visited in increasing order, as in a full scan
     for (i=0; i<this->num_sensors; i++) {
 
         // Iterate each POI, identifying sensor-poi coverage
-        for (j=0; j < this->num_pois; j++) {
+        poi_grid.neighborhood(pl_sensors[i], -1, &candidates);
+        for (const int &j : candidates) {
             if (distance(pl_sensors[i], pl_pois[j]) <= this->sensor_coverage_radius) {
                 push(this->poi_sensor, j, i);
                 push(this->sensor_poi, i, j);
@@ -91,7 +138,8 @@ void KCMC_Instance::regenerate() {
         }
 
         // Verify if the sensor can connect to a SINK
-        for (j=0; j<this->num_sinks; j++) {
+        sink_grid.neighborhood(pl_sensors[i], -1, &candidates);
+        for (const int &j : candidates) {
             if (distance(pl_sensors[i], pl_sinks[j]) <= this->sensor_communication_radius) {
                 push(this->sensor_sink, i, j);  // Symetric communication between sink and sensors
                 push(this->sink_sensor, j, i);  // Symetric communication between sink and sensors
@@ -99,7 +147,8 @@ void KCMC_Instance::regenerate() {
         }
 
         // Iterate each further sensor, identifying connections between sensors
-        for (j=i+1; j < this->num_sensors; j++) {
+        sensor_grid.neighborhood(pl_sensors[i], i, &candidates);
+        for (const int &j : candidates) {
             if (distance(pl_sensors[i], pl_sensors[j]) <= this->sensor_communication_radius) {
                 push(this->sensor_sensor, i, j);  // Symetric communication between sensors
                 push(this->sensor_sensor, j, i);  // Symetric communication between sensors
@@ -131,6 +180,7 @@ KCMC_Instance::KCMC_Instance(int num_pois, int num_sensors, int num_sinks,
 
     // Now that we have the main attributes, we can (re)generate the instance
     this->regenerate();
+    this->densify();
 }
 
 
@@ -141,14 +191,16 @@ KCMC_Instance::KCMC_Instance(const std::string& serialized_kcmc_instance) {
     /** Instance de-serializer constructor
      * This constructor is used to load a previously-generated instance. Node placements are irrelevant
      */
+    KCMC_TRACE("parse");
 
     // Iterate the string, looking for tokens
     size_t previous = 0, pos = 0;
     std::string token;
+    std::stringstream s_token;  // Only for the constants. Edges are parsed without streams
     int stage = 0, has_edges = 0;
     while ((pos = serialized_kcmc_instance.find(';', previous)) != std::string::npos) {
         token = serialized_kcmc_instance.substr(previous, pos-previous);
-        std::stringstream s_token(token);
+        if (stage < 4) {s_token.clear(); s_token.str(token);}
 
         switch(stage) {
             case 0:
@@ -205,6 +257,18 @@ KCMC_Instance::KCMC_Instance(const std::string& serialized_kcmc_instance) {
 
     // If we got here and have no edges, we must re-generate this instance
     if (has_edges == 0) { this->regenerate(); }
+    this->densify();
+}
+
+
+/** ADJACENCY DENSIFIER
+ * Ensures every POI and every sensor has an entry (even if empty) in the POI-sensor, sensor-POI and sensor-sensor maps.
+ * After it, lookups never insert new entries, so the maps can be read by many threads at the same time.
+ * The sensor-sink map is NOT densified, as being a key in it means being sink-adjacent.
+ */
+void KCMC_Instance::densify() {
+    for (int i=0; i<this->num_pois; i++) {this->poi_sensor[i];}
+    for (int i=0; i<this->num_sensors; i++) {this->sensor_poi[i]; this->sensor_sensor[i];}
 }
 
 
@@ -214,7 +278,7 @@ int KCMC_Instance::parse_edge(const int stage, const std::string& token){
     /* Instance de-serializer helper method. Parses a single edge */
 
     // Parse the stage itself
-    std::unordered_set<std::string> tags = {"PS", "SS", "SK", "END"};
+    static std::unordered_set<std::string> tags = {"PS", "SS", "SK", "END"};  // Only read, also by many threads
     if (isin(tags, token)){
         if      (token == "PS"){return 5;}
         else if (token == "SS"){return 6;}
@@ -223,10 +287,8 @@ int KCMC_Instance::parse_edge(const int stage, const std::string& token){
     } else if (stage == 4) {throw std::runtime_error("UNKNOWN TOKEN!");}
 
     // Parsing at the current stage
-    std::stringstream s_token(token);
-    int source, target;
-    s_token >> source;
-    s_token >> target;
+    char *rest;
+    const int source = (int)(std::strtol(token.c_str(), &rest, 10)), target = (int)(std::strtol(rest, nullptr, 10));
     switch (stage) {
         case 5:
             push(this->poi_sensor, source, target);
@@ -298,43 +360,35 @@ std::string KCMC_Instance::key() const {
 
 
 /** Instance serializer
+ * Edges are written in increasing order of source and target, so the serialization is deterministic.
+ * Each adjacency is sorted on its own (instead of testing every possible target), and read without inserting entries
  */
+static void serialize_edges(std::ostringstream &out, const std::unordered_map<int, std::unordered_set<int>> &adjacency,
+                            const int num_sources, const bool upper) {
+    std::vector<int> targets;
+    for (int source=0; source<num_sources; source++) {
+        auto entry = adjacency.find(source);
+        if (entry == adjacency.end()) {continue;}
+        targets.assign(entry->second.begin(), entry->second.end());
+        std::sort(targets.begin(), targets.end());
+        for (const int &target : targets) {
+            if ((not upper) or (target >= source)) {out << source << ' ' << target << ';';}
+        }
+    }
+}
+
 std::string KCMC_Instance::serialize() {
     /* Serializes an instance as an string */
-    int source, target;
-
     std::ostringstream out;
     out << "KCMC;" << this->key() << ';';
 
-    // Set the poi-sensor connections
+    // Set the poi-sensor, sensor-sensor (once per pair) and sensor-sink connections
     out << "PS;";
-    for (source=0; source<num_pois; source++) {
-        for (target=0; target<num_sensors; target++) {
-            if (isin(poi_sensor[source], target)) {
-                out << source << ' ' << target << ';';  // MUCH SLOWER than iterating the hashmap, but deterministic
-            }
-        }
-    }
-
-    // Set the sensor-sensor connections
+    serialize_edges(out, this->poi_sensor, this->num_pois, false);
     out << "SS;";
-    for (source=0; source<num_sensors; source++) {
-        for (target=source; target<num_sensors; target++) {
-            if (isin(this->sensor_sensor[source], target)) {
-                out << source << ' ' << target << ';';  // MUCH SLOWER than iterating the hashmap, but deterministic
-            }
-        }
-    }
-
-    // Set the sensor-sink connections
+    serialize_edges(out, this->sensor_sensor, this->num_sensors, true);
     out << "SK;";
-    for (source=0; source<num_sensors; source++) {
-        for (target=0; target<num_sinks; target++) {
-            if (isin(this->sensor_sink[source], target)) {
-                out << source << ' ' << target << ';';  // MUCH SLOWER than iterating the hashmap, but deterministic
-            }
-        }
-    }
+    serialize_edges(out, this->sensor_sink, this->num_sensors, false);
 
     // Return the out string
     out << "END";
@@ -352,6 +406,118 @@ int KCMC_Instance::invert_set(std::unordered_set<int> &source_set, std::unordere
 }
 
 
+/** SUB-INSTANCES
+ * Instances derived from this one keep its key constants (area, radii and seed) but have their own nodes and edges,
+ *   so they must NOT be regenerated from their key, nor have their placements computed.
+ * Edges are serialized in the given order (that of the adjacencies of the derived instance), each sensor-sensor edge
+ *   once
+ */
+KCMC_Instance *KCMC_Instance::derive(const int num_pois, const int num_sensors, const int num_sinks,
+                                     const std::vector<std::pair<int, int>> &poi_sensor,
+                                     const std::vector<std::pair<int, int>> &sensor_sensor,
+                                     const std::vector<std::pair<int, int>> &sensor_sink) const {
+    std::ostringstream out;
+    out << "KCMC;" << num_pois << ' ' << num_sensors << ' ' << num_sinks << ';'
+        << this->area_side << ' ' << this->sensor_coverage_radius << ' ' << this->sensor_communication_radius << ';'
+        << this->random_seed << ';';
+    for (auto section : {std::make_pair("PS;", &poi_sensor), std::make_pair("SS;", &sensor_sensor),
+                         std::make_pair("SK;", &sensor_sink)}) {
+        out << section.first;
+        for (const auto &edge : *(section.second)) {out << edge.first << ' ' << edge.second << ';';}
+    }
+    out << "END";
+    return new KCMC_Instance(out.str());
+}
+
+/* Subsets of the nodes, renumbered by their position. The neighbors of each node keep their order in this instance
+ *   (increasing index). The sinks of the extra sensor-sink edges past the given ones are new sinks, numbered after them
+ */
+KCMC_Instance *KCMC_Instance::subinstance(const std::vector<int> &pois, const std::vector<int> &sensors,
+                                          const std::vector<int> &sinks, const int num_linked,
+                                          const std::vector<std::pair<int, int>> &sink_edges) const {
+    std::unordered_map<int, int> sensor_index, sink_index;
+    for (int i=0; i<(int)(sensors.size()); i++) {sensor_index[sensors[i]] = i;}
+    for (int i=0; i<(int)(sinks.size()); i++) {sink_index[sinks[i]] = i;}
+    int num_sinks = (int)(sinks.size());
+    for (const auto &edge : sink_edges) {num_sinks = std::max(num_sinks, edge.second + 1);}
+
+    // Kept neighbors of a node, in increasing index of this instance, renumbered
+    std::vector<int> neighbors, kept;
+    auto kept_neighbors = [&](const std::unordered_map<int, std::unordered_set<int>> &adjacency, const int source,
+                              const std::unordered_map<int, int> &index) {
+        neighbors.clear();
+        kept.clear();
+        auto found = adjacency.find(source);
+        if (found == adjacency.end()) {return;}
+        neighbors.assign(found->second.begin(), found->second.end());
+        std::sort(neighbors.begin(), neighbors.end());
+        for (const int &neighbor : neighbors) {
+            auto renumbered = index.find(neighbor);
+            if (renumbered != index.end()) {kept.push_back(renumbered->second);}
+        }
+    };
+
+    // Only the first num_linked sensors keep their sensor-sensor and sensor-sink edges
+    std::vector<std::pair<int, int>> poi_sensor, sensor_sensor, sensor_sink;
+    for (int p=0; p<(int)(pois.size()); p++) {
+        kept_neighbors(this->poi_sensor, pois[p], sensor_index);
+        for (const int &target : kept) {poi_sensor.emplace_back(p, target);}
+    }
+    for (int i=0; i<num_linked; i++) {
+        kept_neighbors(this->sensor_sensor, sensors[i], sensor_index);
+        for (const int &target : kept) {if ((target > i) and (target < num_linked)) {sensor_sensor.emplace_back(i, target);}}
+    }
+    size_t extra = 0;
+    for (int i=0; i<(int)(sensors.size()); i++) {
+        if (i < num_linked) {
+            kept_neighbors(this->sensor_sink, sensors[i], sink_index);
+            for (const int &target : kept) {sensor_sink.emplace_back(i, target);}
+        }
+        for (; (extra < sink_edges.size()) and (sink_edges[extra].first == i); extra++) {sensor_sink.push_back(sink_edges[extra]);}
+    }
+    if (extra < sink_edges.size()) {throw std::runtime_error("EXTRA SINK EDGES OUT OF ORDER!");}
+    return this->derive((int)(pois.size()), (int)(sensors.size()), num_sinks, poi_sensor, sensor_sensor, sensor_sink);
+}
+
+/* Every POI and sink, and only the given sensors */
+KCMC_Instance *KCMC_Instance::subinstance(const std::vector<int> &sensors) const {
+    std::vector<int> pois((size_t)this->num_pois), sinks((size_t)this->num_sinks);
+    std::iota(pois.begin(), pois.end(), 0);
+    std::iota(sinks.begin(), sinks.end(), 0);
+    return this->subinstance(pois, sensors, sinks, (int)(sensors.size()), {});
+}
+
+
+/** MEMORY FOOTPRINT
+ * Estimated bytes of each adjacency structure: the bucket array and one node (a pointer and the value) per element of
+ *   every hash map and set. Allocator overheads are not counted
+ */
+template<class T>
+static size_t hash_bytes(const T &table) {
+    return table.bucket_count() * sizeof(void*) + table.size() * (sizeof(void*) + sizeof(typename T::value_type));
+}
+
+static size_t adjacency_bytes(const std::unordered_map<int, std::unordered_set<int>> &adjacency) {
+    size_t bytes = hash_bytes(adjacency);
+    for (const auto &entry : adjacency) {bytes += hash_bytes(entry.second);}
+    return bytes;
+}
+
+size_t KCMC_Instance::footprint(std::vector<std::pair<std::string, size_t>> *structures) const {
+    structures->clear();
+    structures->emplace_back("nodes", (this->poi.capacity() + this->sensor.capacity() + this->sink.capacity()) * sizeof(Node));
+    structures->emplace_back("poi_sensor", adjacency_bytes(this->poi_sensor));
+    structures->emplace_back("sensor_poi", adjacency_bytes(this->sensor_poi));
+    structures->emplace_back("sensor_sensor", adjacency_bytes(this->sensor_sensor));
+    structures->emplace_back("sensor_sink", adjacency_bytes(this->sensor_sink));
+    structures->emplace_back("sink_sensor", adjacency_bytes(this->sink_sensor));
+
+    size_t total = sizeof(KCMC_Instance);
+    for (const auto &structure : *structures) {total += structure.second;}
+    return total;
+}
+
+
 bool KCMC_Instance::validate(const bool raise, const int k, const int m,
                              std::unordered_set<int> &inactive_sensors,
                              std::unordered_set<int> *k_used_sensors,
@@ -5,11 +5,18 @@
 
 
 // STDLib dependencies
+#include <string>         // string object
 #include <vector>         // vector object
 #include <unordered_set>  // unordered_set object
 #include <unordered_map>  // unordered_map HashMap object
+#include <utility>        // pair
+#include <functional>     // function
 #include <cmath>          // sqrt, pow
 
+// Dependencies from this package
+#include "kcmc_stats.h"  // Hot-path counters
+#include "kcmc_trace.h"  // Phase timeline
+
 
 #ifndef KCMC_INSTANCE_H
 #define KCMC_INSTANCE_H
@@ -56,6 +63,32 @@ struct Placement {
 double distance(Placement source, Placement target);
 
 
+/* PLACEMENT GRID
+ * Buckets placements in square cells no smaller than a radius, so every placement within the radius of another is in
+ *   one of the 3x3 cells around it. Neighborhood lists the placements in those cells with index above the given one
+ */
+class PlacementGrid {
+    public:
+        PlacementGrid(const std::vector<Placement> &placements, int area_side, int radius);
+        void neighborhood(const Placement &center, int after, std::vector<int> *candidates) const;
+
+    private:
+        int cell_side, num_cells;
+        std::vector<std::vector<int>> cells;
+        size_t cell(int x, int y) const;
+};
+
+
+/* POI DEFICIT
+ * Diagnostic record of a POI that fails K-coverage, M-connectivity or both.
+ * Coverage is the number of active covering sensors, connectivity the number of disjoint paths found (up to M).
+ */
+struct POIDeficit {
+    int poi;
+    int coverage, connectivity;
+};
+
+
 /* ISIN
  * Many-types-of-input verification if a given item is in the reference set.
  * If the reference set is a mapping, the search is in its keys.
@@ -85,7 +118,7 @@ void vote(std::unordered_map<int, int> &buffer, int target);
  * Returns the set that is the sum (or difference) of the given sets
  */
 template<class T>
-T set_merge (T a, T b) {T t(a); t.insert(b.begin(),b.end()); return t;}
+T set_merge (T a, T b) {KCMC_COUNT(STAT_SET_ALLOC, 1); T t(a); t.insert(b.begin(),b.end()); return t;}
 std::unordered_set<int> set_diff(const std::unordered_set<int> &left, const std::unordered_set<int> &right);
 
 
@@ -96,6 +129,21 @@ void setify(std::unordered_set<int> &target, int size, int source[], int referen
 void setify(std::unordered_set<int> &target, std::unordered_map<int, int> *reference);
 
 
+/* PARALLEL CHUNKS
+ * Splits the range [0, size) in contiguous chunks and runs the task on each chunk, in as many threads as available.
+ * The task receives the [begin, end) of its chunk. Tasks must only READ shared data.
+ */
+void parallel_chunks(int size, const std::function<void(int, int)> &task);
+
+
+/* BEST REUSE
+ * Runs the reuse variant of each flood level (max, none and min) and keeps the one with fewest sensors.
+ * Returns the number of sensors added for k-coverage by the kept variant
+ */
+int best_reuse(const std::function<int(int, std::unordered_map<int, int>*)> &variant,
+               std::unordered_map<int, int> *visited_sensors);
+
+
 // #####################################################################################################################
 
 
@@ -148,11 +196,26 @@ class KCMC_Instance {
          * Get the KEY of the current instance
          * Serialize the current instance as a string
          * Invert a set of sensors (get every sensor in the instance not in the set)
+         * Derive an instance with the key constants of this one, and the given numbers of nodes and edges
+         * Get a sub-instance with the given POIs, sensors and sinks (renumbered by their position), and extra sensor-sink
+         *   edges (in the new indexes, by increasing sensor). Only the first num_linked sensors keep their sensor-sensor
+         *   and sensor-sink edges
+         * Get a sub-instance with every POI and sink, but only the given sensors (renumbered by their position)
+         * Estimate the memory footprint of the instance, in bytes, and of each of its adjacency structures
          * Validate the instance, raising errors if invalid. Some arguments are optional
          */
         std::string key() const;
         std::string serialize();
         int invert_set(std::unordered_set<int> &source_set, std::unordered_set<int> *target_set);
+        KCMC_Instance *derive(int num_pois, int num_sensors, int num_sinks,
+                              const std::vector<std::pair<int, int>> &poi_sensor,
+                              const std::vector<std::pair<int, int>> &sensor_sensor,
+                              const std::vector<std::pair<int, int>> &sensor_sink) const;
+        KCMC_Instance *subinstance(const std::vector<int> &pois, const std::vector<int> &sensors,
+                                   const std::vector<int> &sinks, int num_linked,
+                                   const std::vector<std::pair<int, int>> &sink_edges) const;
+        KCMC_Instance *subinstance(const std::vector<int> &sensors) const;
+        size_t footprint(std::vector<std::pair<std::string, size_t>> *structures) const;
         bool validate(bool raise, int k, int m);
         bool validate(bool raise, int k, int m, std::unordered_set<int> &inactive_sensors);
         bool validate(bool raise, int k, int m, std::unordered_set<int> &inactive_sensors,
@@ -180,18 +243,33 @@ class KCMC_Instance {
         int fast_m_connectivity(int m, std::unordered_set<int> &inactive_sensors, std::unordered_set<int> *all_used_sensors);
         std::string m_connectivity(int m, std::unordered_set<int> &inactive_sensors);
 
+        /* Instance diagnostics
+         * Lists, in a single parallel pass over the POIs, every POI that fails K-coverage or M-connectivity
+         * Repairs the POIs of the report, activating their missing covering sensors and the paths the validators find
+         *   for them among every sensor, until the report is empty (or a few rounds). Returns the activated sensors
+         */
+        int deficiency_report(int k, int m, std::unordered_set<int> &inactive_sensors, std::vector<POIDeficit> *report);
+        std::string report(int k, int m, std::unordered_set<int> &inactive_sensors);
+        int repair_deficits(int k, int m, std::vector<char> *active);
+
         /* Instance Preprocessors
          * Local Optima yelds ony the sensors required to validate the instance using Dinic's algorithm (limited)
          * Flood finds all parallel paths from the dinic paths required in the instance.
          *   The Minimal flood does it only for the required dinic paths. Full flood keeps on adding paths to the
          *     minimal requirements until paths start to increase, so it has way more sensors.
          * Reuse uses the full-flood to get paths. Each path votes on all its composing sensors. Then, new paths are
-         *   created preferring the most voted sensors in each dinic level.
+         *   created preferring the most voted sensors in each dinic level. Reuse-votes is this second stage alone,
+         *   over the votes already in the buffer
+         * Heuristic runs any of the above by its name in the optimizer output (dinic, min_flood, ..., best_reuse)
          */
         int local_optima(int k, int m, std::unordered_set<int> &inactive_sensors, std::unordered_set<int> *all_used_sensors);
         int flood(int k, int m, bool full, std::unordered_set<int> &inactive_sensors, std::unordered_map<int, int> *visited_sensors);
         int reuse(int k, int m, int flood_level, std::unordered_set<int> &inactive_sensors, std::unordered_map<int, int> *visited_sensors);
         int reuse(int k, int m, std::unordered_set<int> &inactive_sensors, std::unordered_map<int, int> *visited_sensors);
+        int reuse_votes(int k, int m, int num_paths,
+                        std::unordered_set<int> &inactive_sensors, std::unordered_map<int, int> *visited_sensors);
+        int heuristic(const std::string &name, int k, int m,
+                      std::unordered_set<int> &inactive_sensors, std::unordered_set<int> *used_sensors);
 
         /* Other useful information about the instance
          */
@@ -199,11 +277,17 @@ class KCMC_Instance {
         void get_placements(Placement *pl_pois, Placement *pl_sensors, Placement *pl_sinks);
 
     private:
+        friend class KCMC_Sweep;  // Reuses the paths and floods across (K, M) pairs
+        friend class KCMC_Bench;  // Micro-benchmarks of the path search
+
         void get_placements(Placement *pl_pois, Placement *pl_sensors, Placement *pl_sinks, bool push);
         void regenerate();
+        void densify();
         int parse_edge(int stage, const std::string& token);
         int find_path(int poi_number, std::unordered_set<int> &used_sensors,
                       int level_graph[], int predecessors[]);
+        void flood_path(int poi_number, const std::vector<int> &path,
+                        std::unordered_set<int> &inactive_sensors, std::unordered_map<int, int> *visited_sensors);
 };
 
 #endif
@@ -4,6 +4,7 @@ KCMC_Instance Object
 
 
 import json
+import time
 import subprocess
 import sys
 from typing import List, Set, Tuple, Dict
@@ -11,10 +12,22 @@ try:
     import igraph
 except Exception as exp:
     igraph = None
+try:
+    import kcmc_native
+    NATIVE = kcmc_native.is_available()
+except Exception as exp:
+    NATIVE = False
 
 
 # Get placements using C++ interface
 def get_placements(pois, sensors, sinks, area_side, random_seed, executable='/app/placements_visualizer'):
+
+    # In-process, if the native bindings are available. Only the placements matter, so radii are irrelevant
+    if NATIVE:
+        coordinates = kcmc_native.NativeKCMC(f'KCMC;{pois} {sensors} {sinks};{area_side} 0 0;{random_seed};END').placements()
+        names = [f'p{i}' for i in range(pois)] + [f'i{i}' for i in range(sensors)] + [f's{i}' for i in range(sinks)]
+        return {name: (int(x), int(y)) for name, (x, y) in zip(names, coordinates)}
+
     out = subprocess.Popen(list(map(str, [executable, pois, sensors, sinks, area_side, random_seed])),
                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
     stdout,stderr = out.communicate()
@@ -31,6 +44,11 @@ def get_placements(pois, sensors, sinks, area_side, random_seed, executable='/ap
 # Get the regenerated instance from its key using the C++ interface
 def get_serialized_instance(pois, sensors, sinks, area_side, sensor_coverage_radius, sensor_communication_radius, random_seed,
                             executable='/app/instance_evaluator'):
+    if NATIVE:
+        return kcmc_native.NativeKCMC(
+            f'KCMC;{pois} {sensors} {sinks};{area_side} {sensor_coverage_radius} {sensor_communication_radius};{random_seed};END'
+        ).serialize()
+
     out = subprocess.Popen(
         list(map(str, [
             executable, 0, 0,
@@ -49,6 +67,7 @@ def get_preprocessing(pois, sensors, sinks, area_side, sensor_coverage_radius, s
 
     # Run the C++ package
     instance_key = f'KCMC;{pois} {sensors} {sinks}; {area_side} {sensor_coverage_radius} {sensor_communication_radius};{random_seed};END'
+    if NATIVE: return get_native_preprocessing(instance_key, kcmc_k, kcmc_m)
     out = subprocess.Popen(
         list(map(str, [
             executable,
@@ -64,8 +83,9 @@ def get_preprocessing(pois, sensors, sinks, area_side, sensor_coverage_radius, s
     result = {}
     for line in stdout.decode().strip().splitlines():
         content = line.lower().strip().split('\t')[3:]
-        assert len(content) == 6, f'INVALID LINE.\nSTDOUT:{stdout.decode()}\n\nSTDERR:{stderr}'
-        item = dict(zip(['method', 'runtime_us', 'valid_result', 'num_used_sensors', 'compression_rate', 'solution'], content))
+        assert len(content) in (6, 7), f'INVALID LINE.\nSTDOUT:{stdout.decode()}\n\nSTDERR:{stderr}'
+        item = dict(zip(['method', 'runtime_us', 'valid_result', 'num_used_sensors', 'compression_rate', 'solution',
+                         'optimality_gap'], content))
 
         # Normalize the item method
         if item['method'][-1].isdigit():
@@ -77,10 +97,34 @@ def get_preprocessing(pois, sensors, sinks, area_side, sensor_coverage_radius, s
         item['runtime_us'] = int(item['runtime_us'])
         item['num_used_sensors'] = int(item['num_used_sensors'])
         item['compression_rate'] = float(item['compression_rate'])
+        if 'optimality_gap' in item: item['optimality_gap'] = float(item['optimality_gap'])
         result[item['method']] = item.copy()
     return result
 
 
+# Same as get_preprocessing, but in-process
+def get_native_preprocessing(instance_key, kcmc_k, kcmc_m):
+    instance = kcmc_native.NativeKCMC(instance_key)
+    lower_bound, _ = instance.lower_bound(kcmc_k, kcmc_m)
+    result = {}
+    for method in kcmc_native.HEURISTICS:
+        start = time.perf_counter_ns()
+        solution, num_paths = instance.heuristic(method, kcmc_k, kcmc_m)  # Fails loudly, as the optimizer does
+        runtime_us = (time.perf_counter_ns() - start) // 1000
+        item = {
+            'method': method,
+            'runtime_us': int(runtime_us),
+            'valid_result': instance.validate(solution, kcmc_k, kcmc_m),
+            'num_used_sensors': int(solution.sum()),
+            'compression_rate': float(round((instance.num_sensors - solution.sum()) / instance.num_sensors, 5)),
+            'solution': ''.join('1' if i else '0' for i in solution),
+            'optimality_gap': float(round(max(0, solution.sum() - lower_bound) / max(1, solution.sum()), 5))
+        }
+        if method != 'dinic': item['num_paths'] = int(num_paths)
+        result[method] = item
+    return result
+
+
 class KCMC_Instance(object):
 
     color_dict = {
@@ -134,6 +178,13 @@ class KCMC_Instance(object):
         self.edges = {}
         self.virtual_sinks_map = {}
 
+        # In-process, if the native bindings are available (with the tags of the C++ parser). They also regenerate
+        # instances given only by their key
+        if NATIVE:
+            self._parse_native(self.string.replace(';PI;', ';PS;').replace(';II;', ';SS;').replace(';IS;', ';SK;'),
+                               inactive_sensors)
+            return
+
         tag = None
         is_expanded = False
         for i, token in enumerate(instance[4:-1]):
@@ -173,6 +224,32 @@ class KCMC_Instance(object):
                 self.random_seed
             ), inactive_sensors)
 
+    def _parse_native(self, instance_string:str, inactive_sensors:Set[str]):
+        """Fills the adjacencies from the CSR arrays of the C++ instance, skipping the inactive sensors"""
+        native = kcmc_native.NativeKCMC(instance_string)
+        offsets, targets = native.adjacency('poi_sensor')
+        for alpha in range(self.num_pois):
+            for beta in targets[offsets[alpha]:offsets[alpha+1]].tolist():
+                if f'i{beta}' in inactive_sensors: continue
+                self._add_to(self.edges, f'p{alpha}', f'i{beta}')
+                self._add_to(self.poi_sensor, alpha, beta)
+                self._add_to(self.sensor_poi, beta, alpha)
+        offsets, targets = native.adjacency('sensor_sensor')
+        for alpha in range(self.num_sensors):
+            if f'i{alpha}' in inactive_sensors: continue
+            for beta in targets[offsets[alpha]:offsets[alpha+1]].tolist():
+                if (beta < alpha) or (f'i{beta}' in inactive_sensors): continue  # Each edge once, as serialized
+                self._add_to(self.edges, f'i{alpha}', f'i{beta}')
+                self._add_to(self.sensor_sensor, alpha, beta)
+                self._add_to(self.sensor_sensor, beta, alpha)
+        offsets, targets = native.adjacency('sensor_sink')
+        for alpha in range(self.num_sensors):
+            if f'i{alpha}' in inactive_sensors: continue
+            for beta in targets[offsets[alpha]:offsets[alpha+1]].tolist():
+                self._add_to(self.edges, f'i{alpha}', f's{beta}')
+                self._add_to(self.sensor_sink, alpha, beta)
+                self._add_to(self.sink_sensor, beta, alpha)
+
     def __init__(self, instance_string:str,
                  accept_loose_pois=False,
                  accept_loose_sensors=False,
@@ -0,0 +1,108 @@
+/** KCMC_METRICS.cpp
+ * Prometheus snapshots of long-running jobs
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <chrono>     // steady_clock
+#include <cstdio>     // rename
+#include <dirent.h>   // opendir, readdir
+#include <fstream>    // ifstream, ofstream
+#include <iostream>   // cerr
+#include <map>        // map
+#include <set>        // set
+#include <sstream>    // ostringstream
+#include <unistd.h>   // sysconf
+
+// Dependencies from this package
+#include "kcmc_metrics.h"  // KCMC Metrics headers
+
+
+static volatile sig_atomic_t metrics_requested = 0;
+static std::string metrics_destination;
+static double metrics_interval = 0.0;
+static std::chrono::steady_clock::time_point last_snapshot = std::chrono::steady_clock::now();
+static std::map<std::string, double> last_cpu_seconds;  // Of each thread, at the last snapshot
+
+
+static void metrics_signal_handler(int /*signal*/) {metrics_requested = 1;}
+
+
+void metrics_start(const std::string &destination, const double interval) {
+    metrics_destination = (destination == "-") ? "" : destination;
+    metrics_interval = interval;
+    last_snapshot = std::chrono::steady_clock::now();
+    signal(SIGUSR1, metrics_signal_handler);
+}
+
+
+bool metrics_due() {
+    if (metrics_requested) {metrics_requested = 0; return true;}
+    if (metrics_interval <= 0.0) {return false;}
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - last_snapshot).count() >= metrics_interval;
+}
+
+
+/** THREAD CPU TIMES
+ * Seconds of CPU (user and system) of each live thread of the process, by thread id, from /proc/self/task
+ */
+static std::map<std::string, double> thread_cpu_seconds() {
+    std::map<std::string, double> cpu_seconds;
+    const double ticks = (double)sysconf(_SC_CLK_TCK);
+    DIR *tasks = opendir("/proc/self/task");
+    if (tasks == nullptr) {return cpu_seconds;}
+    while (dirent *entry = readdir(tasks)) {
+        std::string tid = entry->d_name;
+        if (tid[0] == '.') {continue;}
+        std::ifstream stat_file("/proc/self/task/" + tid + "/stat");
+        std::string stat((std::istreambuf_iterator<char>(stat_file)), std::istreambuf_iterator<char>());
+        size_t name_end = stat.rfind(')');
+        if (name_end == std::string::npos) {continue;}
+
+        // After the name: state and 10 other fields, then the user and system ticks
+        std::istringstream fields(stat.substr(name_end + 2));
+        std::string skipped;
+        double user_ticks, system_ticks;
+        for (int i=0; i<11; i++) {fields >> skipped;}
+        if (fields >> user_ticks >> system_ticks) {cpu_seconds[tid] = (user_ticks + system_ticks) / ticks;}
+    }
+    closedir(tasks);
+    return cpu_seconds;
+}
+
+
+void metrics_write(const std::vector<KCMC_Metric> &metrics) {
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - last_snapshot).count();
+    std::map<std::string, double> cpu_seconds = thread_cpu_seconds();
+
+    std::ostringstream out;
+    std::set<std::string> described;
+    auto sample = [&](const KCMC_Metric &metric) {
+        std::string family = metric.name.substr(0, metric.name.find('{'));
+        if (described.insert(family).second) {
+            out << "# HELP " << family << " " << metric.help << std::endl;
+            out << "# TYPE " << family << " " << metric.type << std::endl;
+        }
+        out << metric.name << " " << metric.value << std::endl;
+    };
+    for (const KCMC_Metric &metric : metrics) {sample(metric);}
+    for (const auto &thread : cpu_seconds) {
+        double previous = last_cpu_seconds.count(thread.first) ? last_cpu_seconds[thread.first] : 0.0;
+        sample({"kcmc_thread_utilization{tid=\"" + thread.first + "\"}", "gauge",
+                "Fraction of the time since the last snapshot that the thread was on a CPU",
+                (elapsed > 0.0) ? (thread.second - previous) / elapsed : 0.0});
+    }
+    last_cpu_seconds = cpu_seconds;
+    last_snapshot = now;
+
+    if (metrics_destination.empty()) {std::cerr << out.str() << std::flush; return;}
+    std::string temporary = metrics_destination + ".tmp";
+    {
+        std::ofstream file(temporary);
+        if (not file.is_open()) {std::cerr << "UNABLE TO WRITE METRICS " << temporary << std::endl; return;}
+        file << out.str();
+    }
+    std::rename(temporary.c_str(), metrics_destination.c_str());
+}
@@ -0,0 +1,42 @@
+/** KCMC_METRICS.h
+ * Live snapshots of long-running jobs, in the Prometheus text format, on SIGUSR1 or on an interval
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <csignal>  // sig_atomic_t
+#include <string>   // string
+#include <vector>   // vector
+
+
+#ifndef KCMC_METRICS_H
+#define KCMC_METRICS_H
+
+
+/* METRIC
+ * A sample of the snapshot. The name may have labels, as name{label="value"}. Type is gauge or counter
+ */
+struct KCMC_Metric {
+    std::string name, type, help;
+    double value;
+};
+
+
+/* METRICS START AND DUE
+ * START: Sets the destination of the snapshots (a file, rewritten at each snapshot, or STDERR if empty or "-") and
+ *        their interval in seconds (none if not positive), and handles SIGUSR1
+ * DUE:   True (once) if SIGUSR1 arrived or the interval elapsed since the last snapshot. The signal handler only sets a
+ *        flag, so snapshots are written by the job itself, at a point where its state is consistent
+ */
+void metrics_start(const std::string &destination, double interval);
+bool metrics_due();
+
+
+/* METRICS WRITE
+ * Writes the samples, and the CPU utilization of each thread of the process since the last snapshot (Linux only).
+ * Files are written to a temporary and renamed, so readers never see a partial snapshot
+ */
+void metrics_write(const std::vector<KCMC_Metric> &metrics);
+
+#endif
@@ -0,0 +1,176 @@
+"""
+KCMC_Instance native bindings
+In-process access to the C++ KCMC instance object, through the C interface in libkcmc.so (see kcmc_capi.h)
+"""
+
+
+import os
+import ctypes
+from typing import Dict, Tuple
+
+import numpy as np
+
+
+LIBRARY_FILE = os.environ.get('KCMC_NATIVE_LIBRARY', '/app/libkcmc.so')
+ADJACENCIES = {'poi_sensor': 0, 'sensor_sensor': 1, 'sensor_sink': 2}
+HEURISTICS = ['dinic', 'min_flood', 'max_flood', 'no_reuse', 'min_reuse', 'max_reuse', 'best_reuse']
+
+_library = None
+
+
+def load_library(library_file:str=LIBRARY_FILE) -> ctypes.CDLL:
+    """Loads (once) the shared library and declares the signatures of its functions"""
+    global _library
+    if _library is not None: return _library
+
+    lib = ctypes.CDLL(library_file)
+    handle, c_int_p, c_bytes = ctypes.c_void_p, ctypes.POINTER(ctypes.c_int), ctypes.POINTER(ctypes.c_ubyte)
+    c_const_int_pp = ctypes.POINTER(ctypes.POINTER(ctypes.c_int))
+    signatures = {
+        'kcmc_last_error': (ctypes.c_char_p, []),
+        'kcmc_new': (handle, [ctypes.c_char_p]),
+        'kcmc_new_random': (handle, [ctypes.c_int]*6 + [ctypes.c_longlong]),
+        'kcmc_free': (None, [handle]),
+        'kcmc_dimensions': (None, [handle, c_int_p]),
+        'kcmc_key': (ctypes.c_char_p, [handle]),
+        'kcmc_serialize': (ctypes.c_char_p, [handle]),
+        'kcmc_placements': (None, [handle, c_int_p]),
+        'kcmc_adjacency': (ctypes.c_int, [handle, ctypes.c_int, c_const_int_pp, c_int_p, c_const_int_pp, c_int_p]),
+        'kcmc_validate': (ctypes.c_int, [handle, ctypes.c_int, ctypes.c_int, c_bytes]),
+        'kcmc_report': (ctypes.c_int, [handle, ctypes.c_int, ctypes.c_int, c_bytes, c_int_p, ctypes.c_int]),
+        'kcmc_heuristic': (ctypes.c_int, [handle, ctypes.c_char_p, ctypes.c_int, ctypes.c_int, c_bytes]),
+        'kcmc_lower_bound': (ctypes.c_int, [handle, ctypes.c_int, ctypes.c_int, c_int_p]),
+        'kcmc_limits': (None, [handle, c_bytes, c_int_p]),
+    }
+    for name, (restype, argtypes) in signatures.items():
+        function = getattr(lib, name)
+        function.restype, function.argtypes = restype, argtypes
+    _library = lib
+    return lib
+
+
+def is_available(library_file:str=LIBRARY_FILE) -> bool:
+    try:
+        load_library(library_file)
+        return True
+    except OSError:
+        return False
+
+
+class NativeKCMC(object):
+    """
+    A C++ KCMC_Instance living in this process.
+    Adjacencies are returned as read-only NumPy CSR arrays (offsets, targets) pointing to the C++ memory, which keep
+    this object (and so that memory) alive for as long as they live. Solutions are NumPy bool arrays of num_sensors positions, True for active sensors.
+    """
+
+    def __init__(self, instance:str=None, random:Tuple[int, int, int, int, int, int, int]=None,
+                 library_file:str=LIBRARY_FILE):
+        self._lib = load_library(library_file)
+        self._handle = None
+
+        # From a serialized instance (or its key), or from the random-instance descriptors
+        if instance is not None: self._handle = self._lib.kcmc_new(instance.strip().encode())
+        elif random is not None: self._handle = self._lib.kcmc_new_random(*random)
+        else: raise ValueError('EITHER A SERIALIZED INSTANCE OR THE RANDOM-INSTANCE DESCRIPTORS ARE REQUIRED')
+        if not self._handle: raise ValueError(self.last_error)
+
+        dimensions = (ctypes.c_int * 3)()
+        self._lib.kcmc_dimensions(self._handle, dimensions)
+        self.num_pois, self.num_sensors, self.num_sinks = dimensions
+
+    def __del__(self):
+        if getattr(self, '_handle', None): self._lib.kcmc_free(self._handle)
+        self._handle = None
+
+    def __repr__(self): return f'<NativeKCMC {self.key}>'
+
+    @property
+    def last_error(self) -> str: return self._lib.kcmc_last_error().decode()
+
+    # BASIC SERVICES ###################################################################################################
+
+    @property
+    def key(self) -> str: return self._lib.kcmc_key(self._handle).decode()
+
+    @property
+    def key_str(self) -> str: return f'KCMC;{self.key};END'
+
+    def serialize(self) -> str: return self._lib.kcmc_serialize(self._handle).decode()
+
+    def placements(self) -> np.ndarray:
+        """(x, y) of every POI, then every sensor, then every sink"""
+        coordinates = np.zeros((self.num_pois + self.num_sensors + self.num_sinks, 2), dtype=np.intc)
+        self._lib.kcmc_placements(self._handle, coordinates.ctypes.data_as(ctypes.POINTER(ctypes.c_int)))
+        return coordinates
+
+    def adjacency(self, name:str) -> Tuple[np.ndarray, np.ndarray]:
+        """
+        Zero-copy CSR arrays (offsets, targets) of poi_sensor, sensor_sensor or sensor_sink.
+        Views are not cached on this object: they reference it, so a cache would be a cycle, delaying kcmc_free until the
+        next collection of the garbage collector
+        """
+        offsets, targets = ctypes.POINTER(ctypes.c_int)(), ctypes.POINTER(ctypes.c_int)()
+        num_offsets, num_targets = ctypes.c_int(), ctypes.c_int()
+        if self._lib.kcmc_adjacency(self._handle, ADJACENCIES[name], ctypes.byref(offsets), ctypes.byref(num_offsets),
+                                    ctypes.byref(targets), ctypes.byref(num_targets)) != 0:
+            raise ValueError(self.last_error)
+        arrays = (self._view(offsets, num_offsets.value),
+                  self._view(targets, num_targets.value) if num_targets.value > 0 else np.zeros(0, dtype=np.intc))
+        for array in arrays: array.flags.writeable = False
+        return arrays
+
+    def _view(self, pointer, size:int) -> np.ndarray:
+        """NumPy array over C++ memory. Its base holds a reference to this object, so the memory outlives the array"""
+        buffer = (ctypes.c_int * size).from_address(ctypes.addressof(pointer.contents))
+        buffer._owner = self
+        return np.ctypeslib.as_array(buffer)
+
+    @property
+    def adjacencies(self) -> Dict[str, Tuple[np.ndarray, np.ndarray]]:
+        return {name: self.adjacency(name) for name in ADJACENCIES}
+
+    # PAYLOAD SERVICES #################################################################################################
+
+    def _solution(self, solution) -> np.ndarray:
+        solution = np.ascontiguousarray(solution, dtype=np.bool_)
+        assert solution.shape == (self.num_sensors,), f'SOLUTIONS MUST HAVE {self.num_sensors} POSITIONS'
+        return solution
+
+    def validate(self, solution, k:int, m:int) -> bool:
+        solution = self._solution(solution)
+        result = self._lib.kcmc_validate(self._handle, k, m, solution.ctypes.data_as(ctypes.POINTER(ctypes.c_ubyte)))
+        if result < 0: raise ValueError(self.last_error)
+        return result == 1
+
+    def report(self, solution, k:int, m:int) -> np.ndarray:
+        """Every POI lacking coverage or connectivity, as rows (poi, coverage, connectivity)"""
+        solution = self._solution(solution)
+        triplets = np.zeros((self.num_pois, 3), dtype=np.intc)
+        num_deficits = self._lib.kcmc_report(self._handle, k, m, solution.ctypes.data_as(ctypes.POINTER(ctypes.c_ubyte)),
+                                             triplets.ctypes.data_as(ctypes.POINTER(ctypes.c_int)), self.num_pois)
+        if num_deficits < 0: raise ValueError(self.last_error)
+        return triplets[:num_deficits]
+
+    def heuristic(self, name:str, k:int, m:int) -> Tuple[np.ndarray, int]:
+        """Solution of the heuristic and its numeric result (paths found or sensors added for k-coverage)"""
+        solution = np.zeros(self.num_sensors, dtype=np.bool_)
+        result = self._lib.kcmc_heuristic(self._handle, name.encode(), k, m,
+                                          solution.ctypes.data_as(ctypes.POINTER(ctypes.c_ubyte)))
+        if result < 0: raise ValueError(self.last_error)
+        return solution, result
+
+    def lower_bound(self, k:int, m:int) -> Tuple[int, np.ndarray]:
+        """Best lower bound on the number of sensors of any solution, and its parts (coverage, packing, hops)"""
+        bounds = np.zeros(3, dtype=np.intc)
+        best = self._lib.kcmc_lower_bound(self._handle, k, m, bounds.ctypes.data_as(ctypes.POINTER(ctypes.c_int)))
+        return best, bounds
+
+    def limits(self, solution=None) -> Tuple[int, int]:
+        """Largest (K, M) pair supported by the solution (by the whole instance, if None)"""
+        limits = np.zeros(2, dtype=np.intc)
+        if solution is not None: solution = self._solution(solution)
+        c_solution = None if solution is None else solution.ctypes.data_as(ctypes.POINTER(ctypes.c_ubyte))
+        self._lib.kcmc_limits(self._handle, c_solution, limits.ctypes.data_as(ctypes.POINTER(ctypes.c_int)))
+        return int(limits[0]), int(limits[1])
+
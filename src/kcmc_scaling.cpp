@@ -0,0 +1,276 @@
+/*
+ * KCMC scaling report
+ * Runs a selection of operations on a geometric ladder of synthetic instances of the same density (the counts of POIs,
+ *   sensors and sinks grow with the area) and fits the growth of their time and memory to the number of sensors
+ */
+
+
+// STDLib Dependencies
+#include <algorithm>  // find, max
+#include <chrono>     // time functions
+#include <cmath>      // pow, log, sqrt
+#include <fstream>    // ifstream
+#include <functional> // function
+#include <iomanip>    // setprecision
+#include <iostream>   // cin, cout, endl
+#include <map>        // map
+#include <sstream>    // stringstream
+#include <unistd.h>   // sysconf
+
+// Dependencies from this package
+#include "kcmc_instance.h"
+#include "kcmc_graph.h"  // Feasibility oracle
+#include "allocation_hook.h"  // Allocated bytes of each run
+
+
+/* #####################################################################################################################
+ * MEMORY
+ * */
+
+
+/** RESIDENT SET
+ * Current resident memory of the process, in bytes (Linux only, 0 elsewhere)
+ */
+long long resident_bytes() {
+    long long pages = 0, resident = 0;
+    std::ifstream statm("/proc/self/statm");
+    if (statm >> pages >> resident) {return resident * (long long)sysconf(_SC_PAGESIZE);}
+    return 0;
+}
+
+
+/* #####################################################################################################################
+ * MEASUREMENTS
+ * */
+
+
+struct Measurement {
+    int sensors;
+    double seconds, bytes;
+};
+
+
+/** MEASURE
+ * Runs the operation until the runs take at least min_time (a single run, if it takes longer), and writes the seconds
+ *   and allocated bytes per run. Returns false, with a message to STDERR, if the operation throws
+ */
+bool measure(const std::string &name, const int sensors, const double min_time,
+             const std::function<void()> &operation, Measurement *result) {
+    long long iterations = 0, bytes = allocation_counts().bytes;
+    double elapsed = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    try {
+        while ((iterations == 0) or (elapsed < min_time)) {
+            operation();
+            iterations++;
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    } catch (const std::exception &exc) {
+        std::cerr << "FAILED " << name << " WITH " << sensors << " SENSORS: " << exc.what() << std::endl;
+        return false;
+    }
+    *result = {sensors, elapsed / (double)iterations, (double)(allocation_counts().bytes - bytes) / (double)iterations};
+    return true;
+}
+
+
+/** POWER-LAW FIT
+ * Least-squares slope of log(value) on log(sensors): the exponent of the growth. Values of zero are ignored
+ */
+double exponent(const std::vector<Measurement> &measurements, const bool of_time, int *num_points) {
+    double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0, x, y;
+    int n = 0;
+    for (const Measurement &a_measurement : measurements) {
+        y = of_time ? a_measurement.seconds : a_measurement.bytes;
+        if (y <= 0.0) {continue;}
+        x = std::log((double)a_measurement.sensors);
+        y = std::log(y);
+        sx += x; sy += y; sxx += x*x; sxy += x*y;
+        n++;
+    }
+    *num_points = n;
+    if ((n < 2) or (n*sxx - sx*sx <= 0.0)) {return 0.0;}
+    return (n*sxy - sx*sy) / (n*sxx - sx*sx);
+}
+
+
+/* #####################################################################################################################
+ * RUNTIME
+ * */
+
+
+static const std::vector<std::string> OPERATIONS = {"regenerate", "serialize", "deserialize", "level_graph",
+                                                    "k_coverage", "m_connectivity", "min_flood", "max_flood",
+                                                    "best_reuse", "limits"};
+
+
+void help() {
+    std::cout << "Please, use the correct input for the KCMC scaling report:" << std::endl << std::endl;
+    std::cout << "./kcmc_scaling [--from <s>] [--to <s>] [--steps <n>] [--ops <op,op...>] [--k <k>] [--m <m>]"
+              << " [--min-time <ms>] [--budget <s>] [<p> <s> <k> <area_s> <cov_r> <com_r> <seed>]" << std::endl;
+    std::cout << "  where:" << std::endl << std::endl;
+    std::cout << "--from and --to (optional) are the smallest and largest number of sensors. Defaults 100 and 1000000"
+              << std::endl;
+    std::cout << "--steps (optional) is the number of sizes per decade of the ladder. Default 2" << std::endl;
+    std::cout << "--ops (optional) is the list of operations to run. Default (all):";
+    for (const std::string &name : OPERATIONS) {std::cout << " " << name;}
+    std::cout << std::endl;
+    std::cout << "--k and --m (optional) are the K and M of the heuristics. Default 1 and 1. Operations on instances"
+              << " that do not support them are reported as failures" << std::endl;
+    std::cout << "--min-time (optional) is the minimal time of the runs of each operation. Default 100 ms" << std::endl;
+    std::cout << "--budget (optional) skips an operation on larger sizes once a single run of it takes longer."
+              << " Default 60 s" << std::endl;
+    std::cout << "The base class (defaults 100 100 1 300 50 100 1) is scaled to each size: POIs and sinks grow with the"
+              << " sensors and the area side with its square root, so the density is the same" << std::endl << std::endl;
+    std::cout << "Prints a line per size and operation (sensors, POIs, sinks, area side, operation, seconds and allocated"
+              << " bytes per run), and the pseudo-operations footprint (estimated bytes of the instance) and resident"
+              << " (bytes of the process). Then, a FIT line per operation with the exponents of its time and bytes to"
+              << " the number of sensors, marked SUPER-LINEAR if the time exponent is above 1.2" << std::endl;
+    std::cout << "--stats (optional, before anything else) prints the hot-path counters to STDERR at exit."
+              << " Counters are only compiled in builds configured with -DKCMC_STATS=ON" << std::endl;
+    std::cout << "--trace <file> (optional, before anything else) writes a timeline of the phases (parse, level graph,"
+              << " path searches, floods, GA steps...) to the file at exit, as Chrome trace-event JSON" << std::endl;
+    exit(0);
+}
+
+
+int main(int argc, char* const argv[]) {
+    {int skip = diagnostic_flags(argc, argv); argv += skip; argc -= skip;}  // --stats and --trace, at exit
+
+    // Optional leading flags
+    int from = 100, to = 1000000, steps = 2, k = 1, m = 1;
+    double min_time = 0.1, budget = 60.0;
+    std::vector<std::string> operations = OPERATIONS;
+    while ((argc > 1) and (std::string(argv[1]).rfind("--", 0) == 0)) {
+        if (argc < 3) {help();}
+        const std::string flag = argv[1];
+        if (flag == "--from") {from = std::stoi(argv[2]);}
+        else if (flag == "--to") {to = std::stoi(argv[2]);}
+        else if (flag == "--steps") {steps = std::stoi(argv[2]);}
+        else if (flag == "--k") {k = std::stoi(argv[2]);}
+        else if (flag == "--m") {m = std::stoi(argv[2]);}
+        else if (flag == "--min-time") {min_time = std::stod(argv[2]) / 1000.0;}
+        else if (flag == "--budget") {budget = std::stod(argv[2]);}
+        else if (flag == "--ops") {
+            operations.clear();
+            std::stringstream list(argv[2]);
+            std::string name;
+            while (std::getline(list, name, ',')) {
+                if (std::find(OPERATIONS.begin(), OPERATIONS.end(), name) == OPERATIONS.end()) {help();}
+                operations.push_back(name);
+            }
+        }
+        else {help();}
+        argv += 2; argc -= 2;
+    }
+    if ((argc != 1) and (argc != 8)) {help();}
+    if ((from < 1) or (to < from) or (steps < 1)) {help();}
+    allocation_counting(true);  // Allocated bytes of every run
+
+    // Base class
+    int base_pois = 100, base_sensors = 100, base_sinks = 1, base_area = 300, coverage_radius = 50,
+        communication_radius = 100;
+    long long seed = 1;
+    if (argc == 8) {
+        base_pois = std::stoi(argv[1]); base_sensors = std::stoi(argv[2]); base_sinks = std::stoi(argv[3]);
+        base_area = std::stoi(argv[4]); coverage_radius = std::stoi(argv[5]); communication_radius = std::stoi(argv[6]);
+        seed = std::stoll(argv[7]);
+    }
+
+    // Ladder of sizes, in number of sensors
+    std::vector<int> ladder;
+    for (int step=0; ; step++) {
+        auto sensors = (int)(std::round((double)from * std::pow(10.0, (double)step / (double)steps)));
+        if (sensors > to) {break;}
+        if (ladder.empty() or (sensors > ladder.back())) {ladder.push_back(sensors);}
+    }
+
+    // Buffers
+    std::map<std::string, std::vector<Measurement>> measurements;
+    std::map<std::string, bool> skipped;
+    std::unordered_set<int> emptyset, used_sensors;
+    std::unordered_map<int, int> visited_sensors;
+    std::string serialized;
+
+    printf("Sensors\tPOIs\tSinks\tArea\tOperation\tSeconds\tBytes\n");
+    for (const int &sensors : ladder) {
+        double factor = (double)sensors / (double)base_sensors;
+        int pois = std::max(1, (int)(std::round(base_pois * factor))),
+            sinks = std::max(1, (int)(std::round(base_sinks * factor))),
+            area = std::max(1, (int)(std::round(base_area * std::sqrt(factor))));
+
+        auto print = [&](const std::string &name, const double seconds, const double bytes) {
+            std::cout << sensors << "\t" << pois << "\t" << sinks << "\t" << area << "\t" << name << "\t"
+                      << std::scientific << std::setprecision(4) << seconds << "\t" << std::fixed << std::setprecision(0)
+                      << bytes << std::endl;
+        };
+
+        // The instance of the size, and its memory
+        auto *instance = new KCMC_Instance(pois, sensors, sinks, area, coverage_radius, communication_radius, seed);
+        std::vector<std::pair<std::string, size_t>> structures;
+        measurements["footprint"].push_back({sensors, 0.0, (double)(instance->footprint(&structures))});
+        measurements["resident"].push_back({sensors, 0.0, (double)resident_bytes()});
+        print("footprint", 0.0, measurements["footprint"].back().bytes);
+        print("resident", 0.0, measurements["resident"].back().bytes);
+        serialized.clear();
+        if (std::find(operations.begin(), operations.end(), "deserialize") != operations.end()) {
+            serialized = instance->serialize();
+        }
+
+        for (const std::string &name : operations) {
+            if (skipped[name]) {continue;}
+            std::function<void()> operation;
+            if (name == "regenerate") {operation = [&]() {
+                delete new KCMC_Instance(pois, sensors, sinks, area, coverage_radius, communication_radius, seed);
+            };}
+            else if (name == "serialize") {operation = [&]() {serialized = instance->serialize();};}
+            else if (name == "deserialize") {operation = [&]() {delete new KCMC_Instance(serialized);};}
+            else if (name == "level_graph") {operation = [&]() {
+                std::vector<int> levels((size_t)instance->num_sensors, 0);
+                instance->level_graph(levels.data(), emptyset);
+            };}
+            else if (name == "k_coverage") {operation = [&]() {instance->fast_k_coverage(k, emptyset, &used_sensors);};}
+            else if (name == "m_connectivity") {operation = [&]() {
+                if (instance->fast_m_connectivity(m, emptyset, &visited_sensors) >= 1000000) {
+                    throw std::runtime_error("INSUFFICIENT CONNECTIVITY");
+                }
+            };}
+            else if (name == "min_flood") {operation = [&]() {instance->flood(k, m, false, emptyset, &visited_sensors);};}
+            else if (name == "max_flood") {operation = [&]() {instance->flood(k, m, true, emptyset, &visited_sensors);};}
+            else if (name == "best_reuse") {operation = [&]() {instance->reuse(k, m, emptyset, &visited_sensors);};}
+            else if (name == "limits") {operation = [&]() {
+                int k_max, m_max;
+                KCMC_Graph graph(instance);
+                graph.limits(std::vector<char>((size_t)instance->num_sensors, 1), &k_max, &m_max);
+            };}
+
+            Measurement result {};
+            if (not measure(name, sensors, min_time, operation, &result)) {continue;}
+            measurements[name].push_back(result);
+            print(name, result.seconds, result.bytes);
+            if (result.seconds > budget) {
+                skipped[name] = true;
+                std::cerr << "SKIPPING " << name << " ON LARGER SIZES (" << result.seconds << "s > BUDGET)" << std::endl;
+            }
+        }
+        delete instance;
+    }
+
+    // Fitted exponents of the growth of each operation, in the order of the ladder
+    printf("Fit\tOperation\tTime exponent\tBytes exponent\tSizes\tGrowth\n");
+    for (const std::string &name : operations) {
+        int time_points, bytes_points;
+        double time_exponent = exponent(measurements[name], true, &time_points),
+               bytes_exponent = exponent(measurements[name], false, &bytes_points);
+        std::cout << "FIT\t" << name << "\t" << std::fixed << std::setprecision(3) << time_exponent << "\t"
+                  << bytes_exponent << "\t" << time_points << "\t"
+                  << ((time_points < 2) ? "UNKNOWN" : ((time_exponent > 1.2) ? "SUPER-LINEAR" : "LINEAR")) << std::endl;
+    }
+    for (const char *name : {"footprint", "resident"}) {
+        int bytes_points;
+        double bytes_exponent = exponent(measurements[name], false, &bytes_points);
+        std::cout << "FIT\t" << name << "\t-\t" << std::fixed << std::setprecision(3) << bytes_exponent << "\t"
+                  << bytes_points << "\t" << ((bytes_exponent > 1.2) ? "SUPER-LINEAR" : "LINEAR") << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+/** KCMC_STATS.cpp
+ * Registry and report of the hot-path counters
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <cstdlib>    // atexit
+#include <iostream>   // cerr
+#include <mutex>      // mutex, lock_guard
+#include <string>     // string
+#include <vector>     // vector
+#include <algorithm>  // find
+
+// Dependencies from this package
+#include "kcmc_stats.h"  // KCMC Stats headers
+
+
+static const char *STAT_NAMES[NUM_STATS] = {"find_path_calls", "queue_pushes", "queue_pops", "bfs_levels",
+                                            "bfs_visited", "set_allocations", "vote_updates"};
+
+
+#ifdef KCMC_STATS
+
+/* REGISTRY
+ * The blocks of the live threads, and the totals of the ended ones.
+ * Never destroyed, as threads may end (and report) during the destruction of the static objects
+ */
+struct KCMC_Stats_Registry {
+    std::mutex lock;
+    std::vector<KCMC_Stats*> live;
+    long long ended[NUM_STATS] = {0};
+};
+
+static KCMC_Stats_Registry &registry() {
+    static auto *the_registry = new KCMC_Stats_Registry();
+    return *the_registry;
+}
+
+thread_local KCMC_Stats thread_stats;
+
+KCMC_Stats::KCMC_Stats() {
+    for (auto &count : this->counts) {count.store(0, std::memory_order_relaxed);}
+    std::lock_guard<std::mutex> guard(registry().lock);
+    registry().live.push_back(this);
+}
+
+KCMC_Stats::~KCMC_Stats() {
+    std::lock_guard<std::mutex> guard(registry().lock);
+    for (int i=0; i<NUM_STATS; i++) {registry().ended[i] += this->counts[i].load(std::memory_order_relaxed);}
+    registry().live.erase(std::find(registry().live.begin(), registry().live.end(), this));
+}
+
+void stats_snapshot(long long counts[NUM_STATS]) {
+    std::lock_guard<std::mutex> guard(registry().lock);
+    for (int i=0; i<NUM_STATS; i++) {
+        counts[i] = registry().ended[i];
+        for (const KCMC_Stats *block : registry().live) {counts[i] += block->counts[i].load(std::memory_order_relaxed);}
+    }
+}
+
+#else
+
+void stats_snapshot(long long counts[NUM_STATS]) {
+    for (int i=0; i<NUM_STATS; i++) {counts[i] = 0;}
+}
+
+#endif
+
+
+void stats_print(std::ostream &out) {
+    long long counts[NUM_STATS];
+    stats_snapshot(counts);
+#ifndef KCMC_STATS
+    out << "KCMC STATS NOT COMPILED (CONFIGURE WITH -DKCMC_STATS=ON)" << std::endl;
+#endif
+    for (int i=0; i<NUM_STATS; i++) {out << STAT_NAMES[i] << "\t" << counts[i] << std::endl;}
+}
+
+
+static void stats_at_exit() {stats_print(std::cerr);}
+
+bool stats_flag(const int argc, char* const argv[]) {
+    if ((argc < 2) or (std::string(argv[1]) != "--stats")) {return false;}
+    std::atexit(stats_at_exit);
+    return true;
+}
@@ -0,0 +1,61 @@
+/** KCMC_STATS.h
+ * Hot-path counters of the KCMC_Module, compiled in only with -DKCMC_STATS=ON
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <atomic>   // atomic
+#include <ostream>  // ostream
+
+
+#ifndef KCMC_STATS_H
+#define KCMC_STATS_H
+
+
+/* COUNTERS
+ * Operations counted in the hot paths of the heuristics:
+ * - Calls to find_path, and the pushes and pops of the priority queues of the path searches
+ * - Levels and visited sensors of the BFS of the level graph
+ * - Sets allocated by set_diff and set_merge
+ * - Updates of the vote maps of the floods and reuses
+ */
+enum KCMC_Counter {STAT_FIND_PATH, STAT_QUEUE_PUSH, STAT_QUEUE_POP, STAT_BFS_LEVEL, STAT_BFS_VISIT, STAT_SET_ALLOC,
+                   STAT_VOTE, NUM_STATS};
+
+
+/* COUNT
+ * Adds to a counter of the current thread. Without KCMC_STATS it compiles to nothing.
+ * Each thread has its own block of counters, so a count is a plain (relaxed) load and store. Blocks are registered
+ *   while their thread lives, and added to the totals of the process when it ends
+ */
+#ifdef KCMC_STATS
+
+struct KCMC_Stats {
+    std::atomic<long long> counts[NUM_STATS];
+    KCMC_Stats();
+    ~KCMC_Stats();
+};
+extern thread_local KCMC_Stats thread_stats;
+
+inline void stats_count(const KCMC_Counter counter, const long long amount) {
+    std::atomic<long long> &count = thread_stats.counts[counter];
+    count.store(count.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+#define KCMC_COUNT(counter, amount) stats_count(counter, (long long)(amount))
+
+#else
+#define KCMC_COUNT(counter, amount) ((void)0)
+#endif
+
+
+/* SNAPSHOT, PRINT AND FLAG
+ * SNAPSHOT: The totals of every counter, of the ended threads and of the live ones. Zeros if compiled out
+ * PRINT: Writes the totals, a counter per line (name TAB value)
+ * FLAG: If the first argument is --stats, prints the totals to STDERR at exit and returns true (the caller skips it)
+ */
+void stats_snapshot(long long counts[NUM_STATS]);
+void stats_print(std::ostream &out);
+bool stats_flag(int argc, char* const argv[]);
+
+#endif
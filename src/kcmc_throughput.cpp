@@ -0,0 +1,230 @@
+/*
+ * KCMC throughput benchmark
+ * Runs the heuristics of the optimizer and a few GA generations over a fixed corpus, and compares the throughput and
+ *   the solution sizes against a baseline
+ */
+
+
+// STDLib Dependencies
+#include <algorithm>  // sort
+#include <chrono>     // time functions
+#include <cmath>      // fabs
+#include <fstream>    // ifstream
+#include <iomanip>    // setprecision
+#include <iostream>   // cin, cout, endl
+#include <map>        // map
+#include <sstream>    // stringstream
+
+// Dependencies from this package
+#include "kcmc_instance.h"
+#include "genetic_algorithm_operators.h"  // genalg_binary
+
+
+// Heuristics of the optimizer, in the order of its output
+static const std::vector<std::string> HEURISTICS = {"dinic", "min_flood", "max_flood", "no_reuse", "min_reuse",
+                                                    "max_reuse", "best_reuse"};
+
+
+/* #####################################################################################################################
+ * RESULTS
+ * Results are a flat JSON object of numbers, with keys <instances|instances_per_second> and <method>.<metric>
+ * */
+
+
+double percentile(std::vector<double> values, const double fraction) {
+    if (values.empty()) {return 0.0;}
+    std::sort(values.begin(), values.end());
+    return values[(size_t)(fraction * (double)(values.size() - 1) + 0.5)];
+}
+
+
+void write_json(const std::map<std::string, double> &results, std::ostream &out) {
+    out << "{" << std::endl;
+    size_t i = 0;
+    for (const auto &entry : results) {
+        out << "  \"" << entry.first << "\": " << std::fixed << std::setprecision(3) << entry.second
+            << ((++i < results.size()) ? "," : "") << std::endl;
+    }
+    out << "}" << std::endl;
+}
+
+
+/** FLAT JSON READER
+ * Reads the "key": number pairs of a flat JSON object, as written above
+ */
+void read_json(const std::string &filename, std::map<std::string, double> *results) {
+    std::ifstream file(filename);
+    if (not file.is_open()) {throw std::runtime_error("UNABLE TO OPEN BASELINE " + filename + "!");}
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string text = buffer.str();
+
+    results->clear();
+    size_t pos = 0;
+    while ((pos = text.find('"', pos)) != std::string::npos) {
+        size_t end = text.find('"', pos+1), colon = text.find(':', end);
+        if ((end == std::string::npos) or (colon == std::string::npos)) {throw std::runtime_error("INVALID BASELINE!");}
+        (*results)[text.substr(pos+1, end-pos-1)] = std::stod(text.substr(colon+1));
+        pos = text.find_first_of(",}", colon);
+    }
+}
+
+
+/** BASELINE COMPARISON
+ * Fails if the throughput (or the median latency of any method) is worse than the baseline by more than the
+ *   tolerance, or if the solution sizes differ by more than the quality tolerance. Prints every comparison to STDERR
+ */
+bool compare(const std::map<std::string, double> &baseline, const std::map<std::string, double> &results,
+             const double tolerance, const double quality_tolerance) {
+    bool passed = true;
+    std::cerr << "Metric\tBaseline\tCurrent\tRatio\tStatus" << std::endl << std::fixed << std::setprecision(3);
+    for (const auto &entry : baseline) {
+        const std::string &key = entry.first;
+        auto current = results.find(key);
+        bool ok;
+        double ratio = 0.0;
+        if (current == results.end()) {ok = false;}
+        else {
+            ratio = (entry.second != 0.0) ? current->second / entry.second : ((current->second == 0.0) ? 1.0 : 0.0);
+            if (key == "instances") {ok = (current->second == entry.second);}
+            else if (key == "instances_per_second") {ok = (ratio >= 1.0 - tolerance);}
+            else if (key.rfind(".median_us") == key.size() - 10) {ok = (ratio <= 1.0 + tolerance);}
+            else if (key.rfind(".p95_us") == key.size() - 7) {ok = true;}  // Informative only, too noisy
+            else {ok = (std::fabs(current->second - entry.second) <= quality_tolerance * std::fabs(entry.second));}
+        }
+        std::cerr << key << "\t" << entry.second << "\t" << ((current == results.end()) ? 0.0 : current->second)
+                  << "\t" << ratio << "\t" << (ok ? "OK" : "REGRESSION") << std::endl;
+        passed = passed and ok;
+    }
+    return passed;
+}
+
+
+/* #####################################################################################################################
+ * RUNTIME
+ * */
+
+
+void help() {
+    std::cout << "Please, use the correct input for the KCMC throughput benchmark:" << std::endl << std::endl;
+    std::cout << "./kcmc_throughput [--lines <n>] [--generations <n>] [--baseline <json>] [--tolerance <t>]"
+              << " [--quality-tolerance <q>] <corpus>+" << std::endl;
+    std::cout << "  where:" << std::endl << std::endl;
+    std::cout << "--lines (optional) is the number of instances read from each corpus file. Default 10" << std::endl;
+    std::cout << "--generations (optional) is the number of GA generations on each instance (population 50, selection"
+              << " 10, mutation 0.33, bias 0.75, weights 1.0, PRNG seeded by the position of the instance). Default 20" << std::endl;
+    std::cout << "--baseline (optional) is the JSON of a previous run (i.e. data/throughput_baseline.json) to compare with."
+              << " Exits with 1 on a regression" << std::endl;
+    std::cout << "--tolerance (optional) is the accepted loss of throughput (and of the median latency of each method),"
+              << " as a fraction. Default 0.25" << std::endl;
+    std::cout << "--quality-tolerance (optional) is the accepted relative change of the solution sizes. Default 0" << std::endl;
+    std::cout << "<corpus> is a file of instances, one per line, as KCMC;...;END | (K{k}M{m}) (i.e. data/instances.10.csv)"
+              << std::endl << std::endl;
+    std::cout << "Prints a flat JSON with the instances per second and, for each heuristic and the GA (genalg), the median"
+              << " and p95 latency (us), the total solution size (sensors) and the number of invalid solutions." << std::endl;
+    std::cout << "Baselines are only comparable on the same machine and build type" << std::endl;
+    std::cout << "--stats (optional, before anything else) prints the hot-path counters to STDERR at exit."
+              << " Counters are only compiled in builds configured with -DKCMC_STATS=ON" << std::endl;
+    std::cout << "--trace <file> (optional, before anything else) writes a timeline of the phases (parse, level graph,"
+              << " path searches, floods, GA steps...) to the file at exit, as Chrome trace-event JSON" << std::endl;
+    exit(0);
+}
+
+
+int main(int argc, char* const argv[]) {
+    {int skip = diagnostic_flags(argc, argv); argv += skip; argc -= skip;}  // --stats and --trace, at exit
+    if (argc < 2) { help(); }
+
+    // Optional leading flags
+    int num_lines = 10, num_generations = 20;
+    double tolerance = 0.25, quality_tolerance = 0.0;
+    std::string baseline_file;
+    while ((argc > 1) and (std::string(argv[1]).rfind("--", 0) == 0)) {
+        if (argc < 3) {help();}
+        if (std::string(argv[1]) == "--lines") {num_lines = std::stoi(argv[2]);}
+        else if (std::string(argv[1]) == "--generations") {num_generations = std::stoi(argv[2]);}
+        else if (std::string(argv[1]) == "--baseline") {baseline_file = argv[2];}
+        else if (std::string(argv[1]) == "--tolerance") {tolerance = std::stod(argv[2]);}
+        else if (std::string(argv[1]) == "--quality-tolerance") {quality_tolerance = std::stod(argv[2]);}
+        else {help();}
+        argv += 2; argc -= 2;
+    }
+    if (argc < 2) { help(); }
+
+    // Buffers
+    int num_instances = 0;
+    double total_time = 0.0;
+    std::unordered_set<int> emptyset, used_sensors, unused_sensors, inactive_sensors;
+    std::map<std::string, std::vector<double>> latencies;
+    std::map<std::string, double> results;
+
+    for (int arg=1; arg<argc; arg++) {
+        std::ifstream corpus(argv[arg]);
+        if (not corpus.is_open()) {throw std::runtime_error("UNABLE TO OPEN CORPUS " + std::string(argv[arg]) + "!");}
+        std::string line;
+        for (int i=0; (i < num_lines) and std::getline(corpus, line); i++) {
+
+            // Instance and pair of the line
+            size_t tag = line.find("(K");
+            if (tag == std::string::npos) {throw std::runtime_error("LINE WITHOUT (K{k}M{m}) TAG!");}
+            int k = std::stoi(line.substr(tag+2));
+            int m = std::stoi(line.substr(line.find('M', tag)+1));
+            std::string serialized = line.substr(0, line.find('|'));
+            serialized.erase(serialized.find_last_not_of(' ')+1);
+            auto *instance = new KCMC_Instance(serialized);
+            num_instances++;
+
+            // Heuristics of the optimizer
+            for (const std::string &name : HEURISTICS) {
+                used_sensors.clear();
+                auto start = std::chrono::high_resolution_clock::now();
+                try {instance->heuristic(name, k, m, emptyset, &used_sensors);}
+                catch (const std::exception &exc) {used_sensors.clear();}
+                auto end = std::chrono::high_resolution_clock::now();
+                double elapsed = (double)(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+                latencies[name].push_back(elapsed);
+                total_time += elapsed;
+
+                instance->invert_set(used_sensors, &inactive_sensors);
+                results[name + ".sensors"] += (double)(used_sensors.size());
+                results[name + ".invalid"] += instance->validate(false, k, m, inactive_sensors) ? 0.0 : 1.0;
+            }
+
+            // Generations of the GA, from a fixed seed
+            if (num_generations > 0) {
+                srand((unsigned int)num_instances);
+                auto start = std::chrono::high_resolution_clock::now();
+                genalg_binary(&unused_sensors, 0, num_generations, 50, 10, 0.33, 0.75,
+                              instance, k, m, 1.0, 1.0, nullptr, -1);
+                auto end = std::chrono::high_resolution_clock::now();
+                double elapsed = (double)(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+                latencies["genalg"].push_back(elapsed);
+                total_time += elapsed;
+
+                results["genalg.sensors"] += (double)(instance->num_sensors - (int)(unused_sensors.size()));
+                results["genalg.invalid"] += instance->validate(false, k, m, unused_sensors) ? 0.0 : 1.0;
+            }
+            delete instance;
+        }
+    }
+
+    // Summary
+    results["instances"] = num_instances;
+    results["instances_per_second"] = (total_time > 0.0) ? (num_instances / (total_time / 1e6)) : 0.0;
+    for (const auto &entry : latencies) {
+        results[entry.first + ".median_us"] = percentile(entry.second, 0.5);
+        results[entry.first + ".p95_us"] = percentile(entry.second, 0.95);
+    }
+    write_json(results, std::cout);
+
+    // Comparison with the baseline
+    if (not baseline_file.empty()) {
+        std::map<std::string, double> baseline;
+        read_json(baseline_file, &baseline);
+        if (not compare(baseline, results, tolerance, quality_tolerance)) {
+            std::cerr << "REGRESSION AGAINST " << baseline_file << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
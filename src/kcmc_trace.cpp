@@ -0,0 +1,138 @@
+/** KCMC_TRACE.cpp
+ * Per-thread timelines of the traced phases, and their trace-event JSON
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <chrono>     // steady_clock
+#include <cstdlib>    // atexit
+#include <fstream>    // ofstream
+#include <iomanip>    // setprecision
+#include <memory>     // unique_ptr
+#include <mutex>      // mutex, lock_guard
+#include <stdexcept>  // runtime_error
+#include <vector>     // vector
+
+// Dependencies from this package
+#include "kcmc_trace.h"  // KCMC Trace headers
+
+
+bool trace_enabled = false;
+
+
+/* TIMELINES
+ * Each thread appends to its own timeline, created (and numbered) at its first event. Timelines belong to the
+ *   registry, so they outlive their threads. The registry is never destroyed, as the timeline is written at exit
+ */
+struct TraceEvent {
+    const char *name, *arg_name;
+    int arg;
+    long long begin, duration;  // Nanosseconds
+};
+
+struct TraceTimeline {
+    int thread_id;
+    std::vector<TraceEvent> events;
+    long long num_dropped = 0;  // Events beyond TRACE_MAX_EVENTS
+};
+
+struct KCMC_Trace_Registry {
+    std::mutex lock;
+    std::vector<std::unique_ptr<TraceTimeline>> timelines;
+    std::chrono::steady_clock::time_point start;
+    std::string filename;
+};
+
+static KCMC_Trace_Registry &registry() {
+    static auto *the_registry = new KCMC_Trace_Registry();
+    return *the_registry;
+}
+
+static TraceTimeline *timeline() {
+    thread_local TraceTimeline *thread_timeline = nullptr;
+    if (thread_timeline == nullptr) {
+        std::lock_guard<std::mutex> guard(registry().lock);
+        registry().timelines.emplace_back(new TraceTimeline());
+        thread_timeline = registry().timelines.back().get();
+        thread_timeline->thread_id = (int)(registry().timelines.size());
+    }
+    return thread_timeline;
+}
+
+static long long now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()
+                                                                - registry().start).count();
+}
+
+
+/* TRACE SCOPE AND SUMMARY
+ * Summaries nest, so a detail scope is recorded only while the depth of its thread is 0
+ */
+static thread_local int summary_depth = 0;
+
+KCMC_Trace_Scope::KCMC_Trace_Scope(const char *name, const char *arg_name, const int arg, const bool detail) {
+    this->name = name;
+    this->arg_name = arg_name;
+    this->arg = arg;
+    this->begin = (trace_enabled and ((not detail) or (summary_depth == 0))) ? now() : -1;
+}
+
+KCMC_Trace_Scope::~KCMC_Trace_Scope() {
+    if (this->begin < 0) {return;}
+    TraceTimeline *a_timeline = timeline();
+    if (a_timeline->events.size() >= TRACE_MAX_EVENTS) {a_timeline->num_dropped++; return;}
+    a_timeline->events.push_back({this->name, this->arg_name, this->arg, this->begin, now() - this->begin});
+}
+
+KCMC_Trace_Summary::KCMC_Trace_Summary() {summary_depth++;}
+KCMC_Trace_Summary::~KCMC_Trace_Summary() {summary_depth--;}
+
+
+/* TRACE START AND WRITE
+ */
+static void trace_at_exit() {trace_write(registry().filename);}
+
+void trace_start(const std::string &filename) {
+    registry().start = std::chrono::steady_clock::now();
+    registry().filename = filename;
+    trace_enabled = true;
+    std::atexit(trace_at_exit);
+}
+
+void trace_write(const std::string &filename) {
+    std::ofstream out(filename);
+    if (not out.is_open()) {throw std::runtime_error("UNABLE TO WRITE TRACE " + filename + "!");}
+
+    std::lock_guard<std::mutex> guard(registry().lock);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << std::fixed << std::setprecision(3);
+    bool first = true;
+    for (const auto &a_timeline : registry().timelines) {
+        out << (first ? "" : ",") << std::endl << "{\"ph\": \"M\", \"pid\": 1, \"tid\": " << a_timeline->thread_id
+            << ", \"name\": \"thread_name\", \"args\": {\"name\": \"thread " << a_timeline->thread_id;
+        if (a_timeline->num_dropped > 0) {out << " (" << a_timeline->num_dropped << " events dropped)";}
+        out << "\"}}";
+        first = false;
+        for (const TraceEvent &event : a_timeline->events) {
+            out << "," << std::endl << "{\"ph\": \"X\", \"pid\": 1, \"tid\": " << a_timeline->thread_id
+                << ", \"name\": \"" << event.name << "\", \"ts\": " << ((double)event.begin / 1000.0)
+                << ", \"dur\": " << ((double)event.duration / 1000.0);
+            if (event.arg_name != nullptr) {out << ", \"args\": {\"" << event.arg_name << "\": " << event.arg << "}";}
+            out << "}";
+        }
+    }
+    out << std::endl << "]}" << std::endl;
+}
+
+
+/* DIAGNOSTIC FLAGS
+ */
+int diagnostic_flags(const int argc, char* const argv[]) {
+    int arg = 1;
+    while (arg < argc) {
+        if (stats_flag(argc - arg + 1, argv + arg - 1)) {arg++;}
+        else if ((std::string(argv[arg]) == "--trace") and (arg+1 < argc)) {trace_start(argv[arg+1]); arg += 2;}
+        else {break;}
+    }
+    return arg - 1;
+}
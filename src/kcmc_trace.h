@@ -0,0 +1,72 @@
+/** KCMC_TRACE.h
+ * Scoped phase tracing of the KCMC_Module, written as a Chrome trace-event timeline (also read by Perfetto)
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <string>  // string
+
+// Dependencies from this package
+#include "kcmc_stats.h"  // Hot-path counters (--stats)
+
+
+#ifndef KCMC_TRACE_H
+#define KCMC_TRACE_H
+
+
+/* TRACE SCOPE
+ * Records a complete event, from its construction to its destruction, in the timeline of the current thread.
+ * Names (and argument names) must be string literals. An optional integer argument is shown with the event.
+ * While tracing is disabled, a scope costs a single check of a flag.
+ * Each timeline keeps at most TRACE_MAX_EVENTS events. Later ones are dropped, and counted in the trace
+ */
+extern bool trace_enabled;
+
+const size_t TRACE_MAX_EVENTS = 1 << 20;
+
+class KCMC_Trace_Scope {
+    public:
+        explicit KCMC_Trace_Scope(const char *name, const char *arg_name = nullptr, int arg = 0, bool detail = false);
+        ~KCMC_Trace_Scope();
+
+    private:
+        const char *name, *arg_name;
+        int arg;
+        long long begin;
+};
+
+#define KCMC_TRACE_CONCAT(a, b) a##b
+#define KCMC_TRACE_NAME(line) KCMC_TRACE_CONCAT(kcmc_trace_scope_, line)
+#define KCMC_TRACE(...) KCMC_Trace_Scope KCMC_TRACE_NAME(__LINE__)(__VA_ARGS__)
+
+
+/* TRACE DETAIL
+ * Detail scopes (one per POI, and such) are only recorded outside the summaries of their thread. Repeated
+ *   evaluations (the fitness and validations of every generation of the GA) open a summary, so their own scopes are
+ *   recorded but not one event per POI of each evaluation. One-shot heuristics keep every detail
+ */
+#define KCMC_TRACE_DETAIL(name, arg_name, arg) KCMC_Trace_Scope KCMC_TRACE_NAME(__LINE__)(name, arg_name, arg, true)
+
+class KCMC_Trace_Summary {
+    public:
+        KCMC_Trace_Summary();
+        ~KCMC_Trace_Summary();
+};
+
+
+/* TRACE START AND WRITE
+ * START: Enables tracing, with timestamps relative to now. The timeline is written to the file at exit
+ * WRITE: Writes the events of every thread (so far) as a trace-event JSON. Threads are numbered by their first event
+ */
+void trace_start(const std::string &filename);
+void trace_write(const std::string &filename);
+
+
+/* DIAGNOSTIC FLAGS
+ * Parses the leading --stats and --trace <file> flags of a binary, in any order, and returns how many arguments they
+ *   took (the caller skips them)
+ */
+int diagnostic_flags(int argc, char* const argv[]);
+
+#endif
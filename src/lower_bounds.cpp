@@ -0,0 +1,125 @@
+/** LOWER_BOUNDS.cpp
+ * Combinatorial lower bounds on the number of sensors of any KCMC solution
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <algorithm>  // sort
+
+// Dependencies from this package
+#include "lower_bounds.h"  // KCMC Lower Bounds headers
+
+
+/** PACKING BOUND
+ * Demands are the deficits of covering sensors of each POI, and of sink-adjacent sensors (only with POIs: without
+ *   them, no sensor is needed). Installed sensors reduce the deficits, and only the undecided ones are candidates. A
+ *   demand is packed if its candidates are disjoint from those of the demands already packed
+ */
+int packing_bound(const KCMC_Graph *graph, const int k, const int m, const std::vector<char> &state) {
+    const int required = (k > m) ? k : m;
+    std::vector<std::pair<int, int>> demands;  // (deficit, demand), demand -1 being the sinks
+    int a_poi, a_sensor, i, installed, deficit, bound = 0;
+
+    for (a_poi=0; a_poi<graph->num_pois; a_poi++) {
+        installed = 0;
+        for (i=graph->poi_sensor.offsets[a_poi]; i<graph->poi_sensor.offsets[a_poi+1]; i++) {
+            if (state[graph->poi_sensor.targets[i]] == INSTALLED) {installed++;}
+        }
+        if ((deficit = required - installed) > 0) {demands.emplace_back(deficit, a_poi);}
+    }
+    installed = 0;
+    for (a_sensor=0; a_sensor<graph->num_sensors; a_sensor++) {
+        if ((state[a_sensor] == INSTALLED) and (graph->sensor_sink.offsets[a_sensor+1] > graph->sensor_sink.offsets[a_sensor])) {
+            installed++;
+        }
+    }
+    if ((graph->num_pois > 0) and ((deficit = m - installed) > 0)) {demands.emplace_back(deficit, -1);}
+    std::sort(demands.begin(), demands.end(), [](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+        return (a.first > b.first) or ((a.first == b.first) and (a.second < b.second));
+    });
+
+    // Greedy packing of demands with disjoint candidates
+    std::vector<char> taken(state.size(), 0);
+    std::vector<int> candidates;
+    for (const auto &demand : demands) {
+        candidates.clear();
+        if (demand.second == -1) {
+            for (a_sensor=0; a_sensor<graph->num_sensors; a_sensor++) {
+                if ((state[a_sensor] == UNDECIDED)
+                    and (graph->sensor_sink.offsets[a_sensor+1] > graph->sensor_sink.offsets[a_sensor])) {
+                    candidates.push_back(a_sensor);
+                }
+            }
+        } else {
+            for (i=graph->poi_sensor.offsets[demand.second]; i<graph->poi_sensor.offsets[demand.second+1]; i++) {
+                if (state[graph->poi_sensor.targets[i]] == UNDECIDED) {candidates.push_back(graph->poi_sensor.targets[i]);}
+            }
+        }
+        bool disjoint = true;
+        for (const int &candidate : candidates) {if (taken[candidate]) {disjoint = false; break;}}
+        if (not disjoint) {continue;}
+        for (const int &candidate : candidates) {taken[candidate] = 1;}
+        bound += demand.first;
+    }
+    return bound;
+}
+
+
+/** HOP DISTANCES
+ * Breadth-first search from the sink-adjacent sensors (1 sensor to the sink) over the non-excluded sensors.
+ * The distance of a POI is the least distance among its covering sensors
+ */
+void hop_distances(const KCMC_Graph *graph, const std::vector<char> &state, std::vector<int> *distances) {
+    std::vector<int> sensor_distance((size_t)graph->num_sensors, 0), queue;
+    int a_sensor, i;
+    for (a_sensor=0; a_sensor<graph->num_sensors; a_sensor++) {
+        if ((state[a_sensor] != EXCLUDED) and (graph->sensor_sink.offsets[a_sensor+1] > graph->sensor_sink.offsets[a_sensor])) {
+            sensor_distance[a_sensor] = 1;
+            queue.push_back(a_sensor);
+        }
+    }
+    for (size_t head=0; head<queue.size(); head++) {
+        a_sensor = queue[head];
+        for (i=graph->sensor_sensor.offsets[a_sensor]; i<graph->sensor_sensor.offsets[a_sensor+1]; i++) {
+            const int neighbor = graph->sensor_sensor.targets[i];
+            if ((state[neighbor] != EXCLUDED) and (sensor_distance[neighbor] == 0)) {
+                sensor_distance[neighbor] = sensor_distance[a_sensor] + 1;
+                queue.push_back(neighbor);
+            }
+        }
+    }
+
+    distances->assign((size_t)graph->num_pois, 0);
+    for (int a_poi=0; a_poi<graph->num_pois; a_poi++) {
+        for (i=graph->poi_sensor.offsets[a_poi]; i<graph->poi_sensor.offsets[a_poi+1]; i++) {
+            const int distance = sensor_distance[graph->poi_sensor.targets[i]];
+            if ((distance > 0) and (((*distances)[a_poi] == 0) or (distance < (*distances)[a_poi]))) {(*distances)[a_poi] = distance;}
+        }
+    }
+}
+
+
+void lower_bounds(const KCMC_Graph *graph, const int k, const int m, KCMC_Bounds *bounds) {
+    std::vector<char> state((size_t)graph->num_sensors, UNDECIDED);
+    std::vector<int> distances;
+
+    bounds->coverage = (graph->num_pois > 0) ? ((k > m) ? k : m) : 0;
+    bounds->packing = packing_bound(graph, k, m, state);
+    hop_distances(graph, state, &distances);
+    bounds->hops = 0;
+    for (const int &distance : distances) {if (m*distance > bounds->hops) {bounds->hops = m*distance;}}
+
+    bounds->best = bounds->coverage;
+    if (bounds->packing > bounds->best) {bounds->best = bounds->packing;}
+    if (bounds->hops > bounds->best) {bounds->best = bounds->hops;}
+}
+
+
+/** OPTIMALITY GAP
+ * Relative distance of the objective to the lower bound, as the MIP solvers report it
+ */
+double optimality_gap(const int objective, const int lower_bound) {
+    if (objective <= 0) {return 0.0;}
+    return (objective > lower_bound) ? (double)(objective - lower_bound) / (double)objective : 0.0;
+}
@@ -0,0 +1,44 @@
+/** LOWER_BOUNDS.h
+ * Combinatorial lower bounds on the number of sensors of any KCMC solution
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <vector>  // vector
+
+// Dependencies from this package
+#include "kcmc_graph.h"  // KCMC Graph (CSR) headers
+
+
+#ifndef LOWER_BOUNDS_H
+#define LOWER_BOUNDS_H
+
+// State of each sensor in a partial solution
+#define UNDECIDED 0
+#define INSTALLED 1
+#define EXCLUDED 2
+
+
+/* LOWER BOUNDS
+ * coverage: each POI needs max(K, M) covering sensors (K for coverage, and one for the start of each disjoint path)
+ * packing:  POIs (and the sinks, that need M adjacent sensors) with pairwise disjoint candidate sensors need their
+ *             demands summed. Demands are packed greedily, largest first
+ * hops:     the M disjoint paths of a POI have at least as many sensors as its shortest path, each
+ * best:     the largest of them
+ */
+struct KCMC_Bounds {
+    int coverage, packing, hops, best;
+};
+
+void lower_bounds(const KCMC_Graph *graph, int k, int m, KCMC_Bounds *bounds);
+double optimality_gap(int objective, int lower_bound);
+
+/* Bounds of partial solutions
+ * Additional sensors needed by the packing bound, given the installed and excluded sensors
+ * Sensors of the shortest path of each POI, among the non-excluded sensors (0 if there is none)
+ */
+int packing_bound(const KCMC_Graph *graph, int k, int m, const std::vector<char> &state);
+void hop_distances(const KCMC_Graph *graph, const std::vector<char> &state, std::vector<int> *distances);
+
+#endif
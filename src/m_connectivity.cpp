@@ -14,6 +14,7 @@
 int KCMC_Instance::level_graph(int level_graph[], std::unordered_set<int> &inactive_sensors) {
     /* Sets the lowest distance in hops from each active sensor to the nearest sink using only active sensors
      */
+    KCMC_TRACE("level_graph");
 
     // Reused buffers
     int level = 0;
@@ -36,6 +37,8 @@ int KCMC_Instance::level_graph(int level_graph[], std::unordered_set<int> &inact
     while (!work_set.empty()) {
         // advance the level
         level++;
+        KCMC_COUNT(STAT_BFS_LEVEL, 1);
+        KCMC_COUNT(STAT_BFS_VISIT, work_set.size());
 
         // update the next set and the levels of the sensors in the work set
         next_set.clear();
@@ -66,12 +69,15 @@ int KCMC_Instance::find_path(const int poi_number, std::unordered_set<int> &used
     // Local buffers
     int i_sensor;
     std::priority_queue<LevelNode, std::vector<LevelNode>, CompareLevelNode> queue;
+    KCMC_COUNT(STAT_FIND_PATH, 1);
 
     // Prepare a queue with each active unused sensor that covers the POI
     // Add each of those sensors to the predecessors map having "-1" as the predecessor, meaning "the POI is the predecessor"
-    for (const int &a_sensor : this->poi_sensor[poi_number]) {
+    // Adjacencies are read with "at" (never inserts), so many threads may search paths in the same instance
+    for (const int &a_sensor : this->poi_sensor.at(poi_number)) {
         if (not isin(used_sensors, a_sensor)) {
             queue.push({a_sensor, level_graph[a_sensor]});
+            KCMC_COUNT(STAT_QUEUE_PUSH, 1);
             predecessors[a_sensor] = -1;
         }
     }
@@ -81,15 +87,17 @@ int KCMC_Instance::find_path(const int poi_number, std::unordered_set<int> &used
         // Get the top sensor in the queue (lowest level) and visit it
         i_sensor = queue.top().index;
         queue.pop();
+        KCMC_COUNT(STAT_QUEUE_POP, 1);
 
         // If the sensor is neighbor of a sink, return the sensor as the beginning of the path
         if (isin(this->sensor_sink, i_sensor)) {return i_sensor;}
 
         // For each neighbor of the top sensor, if the neighbor has not been used or visited yet,
         // Add the unvisited active neighbor to the queue and the top sensor as its predecessor
-        for (const int &neighbor : this->sensor_sensor[i_sensor]) {
+        for (const int &neighbor : this->sensor_sensor.at(i_sensor)) {
             if ((not isin(used_sensors, neighbor)) and (predecessors[neighbor] == -2)){
                 queue.push({neighbor, level_graph[neighbor]});
+                KCMC_COUNT(STAT_QUEUE_PUSH, 1);
                 predecessors[neighbor] = i_sensor;
                 // If the neighbor is sink-adjacent, we can return it directly
                 if (isin(this->sensor_sink, neighbor)) {return neighbor;}
@@ -114,6 +122,8 @@ int KCMC_Instance::fast_m_connectivity(const int m, std::unordered_set<int> &ina
     /** Verify if every POI has at least M different disjoint paths to all SINKs
      */
      int total_paths_found = 0;
+    KCMC_TRACE("m_connectivity");
+
     // Clear the set of active sensors
     all_used_sensors->clear();
 
@@ -121,26 +131,28 @@ int KCMC_Instance::fast_m_connectivity(const int m, std::unordered_set<int> &ina
     if (m < 1){return -1;}
 
     // Create the level graph
-    int level_graph[this->num_sensors];
-    this->level_graph(level_graph, inactive_sensors);
+    std::vector<int> level_graph((size_t)this->num_sensors);
+    this->level_graph(level_graph.data(), inactive_sensors);
 
     // Prepare the set of "used" sensors
     std::unordered_set<int> used_sensors;
 
     // Create a loop control flag and pointer buffers
-    int paths_found, path_end, a_poi, predecessors[this->num_sensors];
+    int paths_found, path_end, a_poi;
+    std::vector<int> predecessors((size_t)this->num_sensors);
 
     // Run for each POI, returning at the first failure
     for (a_poi=0; a_poi < this->num_pois; a_poi++) {
+        KCMC_TRACE_DETAIL("path_search", "poi", a_poi);
         paths_found = 0;  // Clear the number of paths found for the POI
         used_sensors = inactive_sensors;  // Reset the set of used sensors for each POI
 
         // While there are still paths to be found
         while (paths_found < m) {
-            std::fill(predecessors, predecessors+this->num_sensors, -2);  // Reset the predecessors buffer
+            std::fill(predecessors.begin(), predecessors.end(), -2);  // Reset the predecessors buffer
 
             // Find a path
-            path_end = this->find_path(a_poi, used_sensors, level_graph, predecessors);
+            path_end = this->find_path(a_poi, used_sensors, level_graph.data(), predecessors.data());
 
             // If the path ends in an invalid sensor, return the failure.
             if (path_end == -1) {
@@ -202,14 +214,15 @@ int KCMC_Instance::get_connectivity(int buffer[], std::unordered_set<int> &inact
     // This method is a targeted variance to allow for a LARGE speedup in finding a smaller target
 
     // Create the level graph
-    int level_graph[this->num_sensors];
-    this->level_graph(level_graph, inactive_sensors);
+    std::vector<int> level_graph((size_t)this->num_sensors);
+    this->level_graph(level_graph.data(), inactive_sensors);
 
     // Prepare the buffer set of "used" sensors
     std::unordered_set<int> used_sensors;
 
     // Create a loop control flag and pointer buffers, and a counter for the number of connected POIs
-    int paths_found, path_end, a_poi, predecessors[this->num_sensors], has_connection = 0;
+    int paths_found, path_end, a_poi, has_connection = 0;
+    std::vector<int> predecessors((size_t)this->num_sensors);
 
     // Run for each POI, returning at the first failure
     for (a_poi=0; a_poi < this->num_pois; a_poi++) {
@@ -218,10 +231,10 @@ int KCMC_Instance::get_connectivity(int buffer[], std::unordered_set<int> &inact
 
         // While there are still paths to be found
         while (paths_found < target) {
-            std::fill(predecessors, predecessors+this->num_sensors, -2);  // Reset the predecessors buffer
+            std::fill(predecessors.begin(), predecessors.end(), -2);  // Reset the predecessors buffer
 
             // Find a path
-            path_end = this->find_path(a_poi, used_sensors, level_graph, predecessors);
+            path_end = this->find_path(a_poi, used_sensors, level_graph.data(), predecessors.data());
 
             // If the path ends in an invalid sensor, stop the WHILE loop
             if (path_end == -1) {
@@ -0,0 +1,261 @@
+/** MULTILEVEL.cpp
+ * Coarsening of the sensor graph, solution of the coarsest level and its refinement up to the instance
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <algorithm>  // min, sort, unique, stable_sort, set_intersection
+#include <iterator>   // back_inserter
+#include <stdexcept>  // runtime_error
+
+// Dependencies from this package
+#include "multilevel.h"                   // KCMC Multilevel headers
+#include "genetic_algorithm_operators.h"  // genalg_binary, exit_requested
+
+
+/* GA OF THE COARSEST LEVEL
+ * Same population, selection, mutation, bias and weights of the reference runs of optimizer_genalg_binary
+ */
+#define MULTILEVEL_GA_POPULATION 50
+#define MULTILEVEL_GA_SELECTION 10
+#define MULTILEVEL_GA_MUTATION 0.33
+#define MULTILEVEL_GA_ONE_BIAS 0.75
+
+
+/** MULTILEVEL CONSTRUCTOR
+ * Levels are coarsened until the coarsest size (or until the matchings stall, or an exit signal)
+ */
+KCMC_Multilevel::KCMC_Multilevel(KCMC_Instance *instance, const int k, const int m, const int coarsest_sensors) {
+    if (coarsest_sensors < 1) {throw std::runtime_error("THE COARSEST LEVEL NEEDS AT LEAST ONE SENSOR!");}
+    this->k = k;
+    this->m = m;
+    this->num_refined = 0;
+    this->levels.push_back(instance);
+    this->graphs.push_back(new KCMC_Graph(instance));
+
+    // Coverage of each POI in the current level, and the smallest coverage merges must keep
+    std::vector<int> coverage((size_t)instance->num_pois), min_coverage((size_t)instance->num_pois);
+    for (int poi=0; poi<instance->num_pois; poi++) {
+        coverage[poi] = this->graphs[0]->poi_sensor.offsets[poi+1] - this->graphs[0]->poi_sensor.offsets[poi];
+        min_coverage[poi] = std::min(k, coverage[poi]);
+    }
+
+    while ((this->levels.back()->num_sensors > coarsest_sensors) and (not exit_requested())) {
+        KCMC_TRACE("coarsen", "level", (long long)(this->levels.size()));
+        KCMC_Instance *coarse = this->coarsen((int)(this->levels.size()) - 1, &coverage, min_coverage);
+        if (coarse == nullptr) {break;}
+        this->levels.push_back(coarse);
+        this->graphs.push_back(new KCMC_Graph(coarse));
+    }
+    for (const KCMC_Instance *level : this->levels) {this->level_sensors.push_back(level->num_sensors);}
+    this->level_active.assign(this->levels.size(), 0);
+}
+
+KCMC_Multilevel::~KCMC_Multilevel() {
+    for (size_t level=1; level<this->levels.size(); level++) {delete this->levels[level];}
+    for (KCMC_Graph *graph : this->graphs) {delete graph;}
+}
+
+
+/** COARSEN
+ * Greedy matching, in the order of the sensors. Null if it merges less than a tenth of the sensors. Coarse levels are
+ *   derived from the finer one (KCMC_Instance::derive)
+ */
+KCMC_Instance *KCMC_Multilevel::coarsen(const int level, std::vector<int> *coverage, const std::vector<int> &min_coverage) {
+    const KCMC_Graph &g = *this->graphs[level];
+    const KCMC_Instance *fine = this->levels[level];
+
+    // POIs covered by each sensor, in increasing order
+    std::vector<std::vector<int>> covered((size_t)g.num_sensors);
+    for (int poi=0; poi<g.num_pois; poi++) {
+        for (int i=g.poi_sensor.offsets[poi]; i<g.poi_sensor.offsets[poi+1]; i++) {
+            covered[g.poi_sensor.targets[i]].push_back(poi);
+        }
+    }
+    std::vector<int> shared;
+    auto intersect = [&](const int a_sensor, const int other) {
+        shared.clear();
+        std::set_intersection(covered[a_sensor].begin(), covered[a_sensor].end(),
+                              covered[other].begin(), covered[other].end(), std::back_inserter(shared));
+    };
+    auto mergeable = [&]() {
+        for (const int &poi : shared) {if ((*coverage)[poi] - 1 < min_coverage[poi]) {return false;}}
+        return true;
+    };
+
+    // Matching: the neighbor sharing the most POIs, among those the merge keeps covered enough
+    std::vector<int> coarse((size_t)g.num_sensors, -1);
+    int num_coarse = 0;
+    for (int a_sensor=0; a_sensor<g.num_sensors; a_sensor++) {
+        if (coarse[a_sensor] != -1) {continue;}
+        int best = -1, best_shared = -1;
+        for (int i=g.sensor_sensor.offsets[a_sensor]; i<g.sensor_sensor.offsets[a_sensor+1]; i++) {
+            const int neighbor = g.sensor_sensor.targets[i];
+            if (coarse[neighbor] != -1) {continue;}
+            intersect(a_sensor, neighbor);
+            if (((int)(shared.size()) > best_shared) and mergeable()) {best = neighbor; best_shared = (int)(shared.size());}
+        }
+        coarse[a_sensor] = num_coarse;
+        if (best != -1) {
+            intersect(a_sensor, best);
+            for (const int &poi : shared) {(*coverage)[poi]--;}
+            coarse[best] = num_coarse;
+        }
+        num_coarse++;
+    }
+    if (10 * (g.num_sensors - num_coarse) < g.num_sensors) {return nullptr;}
+    this->coarse_maps.push_back(coarse);
+
+    // Unions of the POIs, neighbors and sinks of the members
+    std::vector<std::pair<int, int>> poi_sensor, sensor_sensor, sensor_sink;
+    for (int poi=0; poi<g.num_pois; poi++) {
+        for (int i=g.poi_sensor.offsets[poi]; i<g.poi_sensor.offsets[poi+1]; i++) {
+            poi_sensor.emplace_back(poi, coarse[g.poi_sensor.targets[i]]);
+        }
+    }
+    for (int a_sensor=0; a_sensor<g.num_sensors; a_sensor++) {
+        for (int i=g.sensor_sensor.offsets[a_sensor]; i<g.sensor_sensor.offsets[a_sensor+1]; i++) {
+            const int source = coarse[a_sensor], target = coarse[g.sensor_sensor.targets[i]];
+            if (source < target) {sensor_sensor.emplace_back(source, target);}
+        }
+        for (int i=g.sensor_sink.offsets[a_sensor]; i<g.sensor_sink.offsets[a_sensor+1]; i++) {
+            sensor_sink.emplace_back(coarse[a_sensor], g.sensor_sink.targets[i]);
+        }
+    }
+
+    for (auto *edges : {&poi_sensor, &sensor_sensor, &sensor_sink}) {
+        std::sort(edges->begin(), edges->end());
+        edges->erase(std::unique(edges->begin(), edges->end()), edges->end());
+    }
+    return fine->derive(g.num_pois, num_coarse, g.num_sinks, poi_sensor, sensor_sensor, sensor_sink);
+}
+
+
+/** REFINE
+ * Each POI keeps its exact paths (among the active sensors). Deactivating a sensor breaks the paths through it, that
+ *   are augmented again from the remaining ones: the sensor stays off if every POI keeps its number of paths and
+ *   min(K, coverage)
+ */
+void KCMC_Multilevel::refine(const int level, std::vector<char> *active) {
+    const KCMC_Graph &g = *this->graphs[level];
+    g.repair(this->k, this->m, active);
+
+    // POIs covered by each sensor, paths of each POI, and POIs with a path through each sensor
+    std::vector<std::vector<int>> covered((size_t)g.num_sensors), users((size_t)g.num_sensors);
+    std::vector<std::vector<std::vector<int>>> paths((size_t)g.num_pois);
+    for (int poi=0; poi<g.num_pois; poi++) {
+        for (int i=g.poi_sensor.offsets[poi]; i<g.poi_sensor.offsets[poi+1]; i++) {
+            covered[g.poi_sensor.targets[i]].push_back(poi);
+        }
+    }
+    parallel_chunks(g.num_pois, [&](const int begin, const int end) {
+        for (int poi=begin; poi<end; poi++) {g.disjoint_paths(poi, this->m, *active, &paths[poi]);}
+    });
+    for (int poi=0; poi<g.num_pois; poi++) {
+        for (const auto &path : paths[poi]) {for (const int &a_sensor : path) {users[a_sensor].push_back(poi);}}
+    }
+
+    // Candidates, fewest POIs depending on them first
+    std::vector<int> candidates;
+    for (int a_sensor=0; a_sensor<g.num_sensors; a_sensor++) {if ((*active)[a_sensor]) {candidates.push_back(a_sensor);}}
+    std::stable_sort(candidates.begin(), candidates.end(), [&](const int a, const int b) {
+        return covered[a].size() + users[a].size() < covered[b].size() + users[b].size();
+    });
+
+    // Users are only appended, so they may list POIs whose paths moved away (skipped by their paths)
+    std::vector<int> checked((size_t)g.num_pois, -1), changed;
+    std::vector<std::vector<std::vector<int>>> repaired;
+    for (const int &candidate : candidates) {
+        if (exit_requested()) {break;}  // The remaining candidates stay active
+        (*active)[candidate] = 0;
+        bool removable = true;
+        for (const int &poi : covered[candidate]) {
+            if (g.coverage(poi, *active) < this->k) {removable = false; break;}
+        }
+
+        changed.clear();
+        repaired.clear();
+        for (size_t i=0; (i<users[candidate].size()) and removable; i++) {
+            const int poi = users[candidate][i];
+            if (checked[poi] == candidate) {continue;}
+            checked[poi] = candidate;
+            std::vector<std::vector<int>> kept;
+            for (const auto &path : paths[poi]) {
+                if (std::find(path.begin(), path.end(), candidate) == path.end()) {kept.push_back(path);}
+            }
+            if (kept.size() == paths[poi].size()) {continue;}
+            if (g.disjoint_paths(poi, this->m, *active, &kept) < (int)(paths[poi].size())) {removable = false; break;}
+            changed.push_back(poi);
+            repaired.push_back(kept);
+        }
+
+        if (not removable) {(*active)[candidate] = 1; continue;}
+        this->num_refined++;
+        for (size_t i=0; i<changed.size(); i++) {
+            paths[changed[i]] = repaired[i];
+            for (const auto &path : paths[changed[i]]) {
+                for (const int &a_sensor : path) {users[a_sensor].push_back(changed[i]);}
+            }
+        }
+    }
+    this->level_active[level] = (int)std::count(active->begin(), active->end(), 1);
+}
+
+
+/** SOLVE
+ * Heuristics that fail on the coarsest level (or GA individuals that are invalid) are completed by its repair.
+ * After an exit signal, the remaining levels are only projected, and the instance repaired
+ */
+int KCMC_Multilevel::solve(const std::string &solver, const int generations, std::unordered_set<int> *used_sensors) {
+    const int coarsest = (int)(this->levels.size()) - 1;
+    KCMC_Instance *instance = this->levels[coarsest];
+    std::vector<char> active((size_t)instance->num_sensors, 1);
+    std::unordered_set<int> emptyset, solution;
+    this->num_refined = 0;
+
+    // K and M the coarsest level supports
+    int k_max, m_max;
+    this->graphs[coarsest]->limits(active, &k_max, &m_max);
+    const int k = std::min(this->k, k_max), m = std::min(this->m, m_max);
+
+    if ((k > 0) and (m > 0)) {
+        KCMC_TRACE("coarsest", "sensors", (long long)(instance->num_sensors));
+        try {
+            if (solver == "genalg") {
+                genalg_binary(&solution, 0, generations, MULTILEVEL_GA_POPULATION, MULTILEVEL_GA_SELECTION,
+                              (float)MULTILEVEL_GA_MUTATION, (float)MULTILEVEL_GA_ONE_BIAS,
+                              instance, k, m, 1.0, 1.0, nullptr, -1);
+                for (const int &a_sensor : solution) {active[a_sensor] = 0;}  // Unused sensors
+            } else {
+                instance->heuristic(solver, k, m, emptyset, &solution);
+                std::fill(active.begin(), active.end(), 0);
+                for (const int &a_sensor : solution) {active[a_sensor] = 1;}
+            }
+        } catch (const std::runtime_error &exc) {
+            if (std::string(exc.what()).rfind("UNKNOWN HEURISTIC", 0) == 0) {throw;}
+        }
+    }
+
+    // Refine each level, and project it to the finer one
+    for (int level=coarsest; level>=0; level--) {
+        if (not exit_requested()) {
+            KCMC_TRACE("refine", "level", (long long)level);
+            this->refine(level, &active);
+        }
+        if (level == 0) {break;}
+        std::vector<char> finer((size_t)this->levels[level-1]->num_sensors, 0);
+        for (size_t a_sensor=0; a_sensor<finer.size(); a_sensor++) {
+            finer[a_sensor] = active[this->coarse_maps[level-1][a_sensor]];
+        }
+        active.swap(finer);
+    }
+    this->levels[0]->repair_deficits(this->k, this->m, &active);
+    this->level_active[0] = (int)std::count(active.begin(), active.end(), 1);
+
+    used_sensors->clear();
+    for (int a_sensor=0; a_sensor<this->levels[0]->num_sensors; a_sensor++) {
+        if (active[a_sensor]) {used_sensors->insert(a_sensor);}
+    }
+    return coarsest + 1;
+}
@@ -0,0 +1,65 @@
+/** MULTILEVEL.h
+ * Multilevel (coarsen, solve, refine) optimizer of large KCMC instances
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <string>         // string
+#include <vector>         // vector object
+#include <unordered_set>  // unordered_set object
+
+// Dependencies from this package
+#include "kcmc_instance.h"  // KCMC Instance class headers
+#include "kcmc_graph.h"     // Exact connectivity of each level
+
+
+#ifndef MULTILEVEL_H
+#define MULTILEVEL_H
+
+
+/** KCMC Multilevel Object
+ * Coarsening: each level matches every sensor with at most one neighbor (sensor-sensor edge), preferring the one
+ *   sharing the most POIs (twins), and merges each pair in a sensor of the next level, with the union of their POIs,
+ *   neighbors and sinks. A pair is only merged if every shared POI keeps the coverage min(K, its original coverage).
+ *   Coarsening stops at the coarsest size, or when a matching merges less than a tenth of the sensors.
+ * A solution of a level, with every member of its sensors activated, is a solution of the finer level (members of a
+ *   merged sensor are neighbors, and cover at least the same POIs), so uncoarsening never loses feasibility.
+ * Solving: the coarsest level runs a heuristic (by its name, as in KCMC_Instance) or the GA ("genalg"), with K and M
+ *   capped by what the level supports (merges may lower the connectivity).
+ * Refinement: at each level, the projected solution is repaired (exact augmenting paths) and then every active
+ *   sensor, fewest POIs depending on it first, is deactivated if no POI gets worse (up to K and M). Validation is
+ *   incremental: only the POIs it covers and those with a path through it are checked, and their paths repaired.
+ *   The finest level also repairs the paths of the greedy validators (repair_deficits).
+ */
+class KCMC_Multilevel {
+
+    public:
+        int k, m;
+
+        /* Statistics
+         * Sensors of each level (the first is the instance), active sensors after the refinement of each level (the
+         *   first is the final solution), and sensors deactivated by the refinements of the last solution
+         */
+        std::vector<int> level_sensors, level_active;
+        int num_refined;
+
+        KCMC_Multilevel(KCMC_Instance *instance, int k, int m, int coarsest_sensors);
+        ~KCMC_Multilevel();
+
+        /* Solve
+         * Runs the solver on the coarsest level and refines its solution up to the instance.
+         * GA generations are only used by "genalg". Returns the number of levels
+         */
+        int solve(const std::string &solver, int generations, std::unordered_set<int> *used_sensors);
+
+    private:
+        std::vector<KCMC_Instance*> levels;          // The first is the instance (not owned)
+        std::vector<KCMC_Graph*> graphs;
+        std::vector<std::vector<int>> coarse_maps;   // Sensor i of level l is sensor coarse_maps[l][i] of level l+1
+
+        KCMC_Instance *coarsen(int level, std::vector<int> *coverage, const std::vector<int> &min_coverage);
+        void refine(int level, std::vector<char> *active);
+};
+
+#endif
@@ -46,15 +46,17 @@ int KCMC_Instance::flood(int k, int m, bool full,
 
     // Base case
     if (m < 1){return -1;}
+    KCMC_TRACE("flood");
 
     // Create the level graph, loop controls and buffers
     bool break_loop;
-    int level_graph[this->num_sensors], predecessors[this->num_sensors],
-        paths_found, path_end, a_poi, path_length, longest_required_path_length, previous, next_i,
+    std::vector<int> level_graph((size_t)this->num_sensors), predecessors((size_t)this->num_sensors);
+    int paths_found, path_end, a_poi, path_length, longest_required_path_length,
         total_paths_found = 0;
+    std::vector<int> path;
 
     // Update the level graph
-    this->level_graph(level_graph, inactive_sensors);
+    this->level_graph(level_graph.data(), inactive_sensors);
 
     // Prepare the set of "used" sensors for each POI
     std::unordered_set<int> used_sensors;
@@ -76,6 +78,7 @@ int KCMC_Instance::flood(int k, int m, bool full,
 
     // Run for each POI, returning at the first failure
     for (a_poi=0; a_poi < this->num_pois; a_poi++) {
+        KCMC_TRACE_DETAIL("path_search", "poi", a_poi);
         break_loop = false;  // Mark the loop for processing
         paths_found = 0;  // Clear the number of paths found for the POI
         longest_required_path_length = 0; // reset the stored length of the last found path
@@ -83,10 +86,10 @@ int KCMC_Instance::flood(int k, int m, bool full,
 
         // While the stopping criteria was not found
         while (not break_loop) {
-            std::fill(predecessors, predecessors+this->num_sensors, -2);  // Reset the predecessors buffer
+            std::fill(predecessors.begin(), predecessors.end(), -2);  // Reset the predecessors buffer
 
             // Find a path
-            path_end = this->find_path(a_poi, used_sensors, level_graph, predecessors);
+            path_end = this->find_path(a_poi, used_sensors, level_graph.data(), predecessors.data());
 
             // If the path ends in an invalid sensor, mark the loop to end. If we do not have enough paths, throw error
             if (path_end == -1) {
@@ -97,69 +100,20 @@ int KCMC_Instance::flood(int k, int m, bool full,
             // If it is a sucessful path
             else {
 
-                // Reset the control buffers
-                next_i = -1;
-                path_length = 0;
-
                 // Increase the counters with the newly found path
                 paths_found += 1;
                 total_paths_found += 1;
 
-                // Unravel the path, marking each sensor in it as used and flooding it
+                // Unravel the path, marking each sensor in it as used, then flood it
+                path.clear();
                 while (path_end != -1) {
                     used_sensors.insert(path_end);
-                    path_length += 1;
-
-                    // Get the previous sensor in the path
-                    previous = predecessors[path_end];
-                    if (previous == -2) { throw std::runtime_error("FORBIDDEN ADDRESS!"); }
-
-                    /* If the previous sensor is a POI and the next is a SINK
-                     * Add all active sensors that connect both to the POI and the SINK to the result buffer
-                     */
-                    if ((previous == -1) and (next_i == -1)) {
-                        for (const int &bridge: this->poi_sensor[a_poi]) {
-                            if (isin(this->sensor_sink, bridge) and (not isin(inactive_sensors, bridge))) {
-                                vote(*visited_sensors, bridge);
-                            }
-                        }
-                    } else {
-                        /* If the previous sensor is a POI (and the next cannot be a SINK)
-                         * Add all active sensors that cover the POI and connect to the path_end sensor to the result
-                         */
-                        if (previous == -1) {
-                            for (const int &cover: this->poi_sensor[a_poi]) {
-                                if (isin(this->sensor_sensor[cover], path_end) and (not isin(inactive_sensors, cover))) {
-                                    vote(*visited_sensors, cover);
-                                }
-                            }
-                        } else {
-                            /* If the previous sensor is NOT a POI and the next IS a SINK
-                             * Add all active sensors that connect to both the previous sensor and the sink
-                             */
-                            if (next_i == -1) {
-                                for (const int &conn: this->sensor_sensor[previous]) {
-                                    if (isin(this->sensor_sink, conn) and (not isin(inactive_sensors, conn))) {
-                                        vote(*visited_sensors, conn);
-                                    }
-                                }
-                            } else {
-                                /* If the previous sensor is NOT a POI ant the next is NOT a sink
-                                 * Add all active sensors that connect to both the previous and the next to the result
-                                 */
-                                for (const int &conn: this->sensor_sensor[previous]) {
-                                    if (isin(this->sensor_sensor[conn], next_i) and (not isin(inactive_sensors, conn))) {
-                                        vote(*visited_sensors, conn);
-                                    }
-                                }
-                            }
-                        }
-                    }
-
-                    // Mark that the next in the path is not a sink and advance the path
-                    next_i = path_end;
-                    path_end = previous;
+                    path.push_back(path_end);
+                    path_end = predecessors[path_end];
+                    if (path_end == -2) { throw std::runtime_error("FORBIDDEN ADDRESS!"); }
                 }
+                path_length = (int)(path.size());
+                this->flood_path(a_poi, path, inactive_sensors, visited_sensors);
 
                 /* FULL version:
                  * If we have enough paths, but the current is no larger than the last, continue the loop.
@@ -184,6 +138,63 @@ int KCMC_Instance::flood(int k, int m, bool full,
 }
 
 
+/** PATH FLOODING
+ * Votes the flood of a single path, given from the sink-adjacent sensor back to the sensor covering the POI.
+ */
+void KCMC_Instance::flood_path(const int poi_number, const std::vector<int> &path,
+                               std::unordered_set<int> &inactive_sensors, std::unordered_map<int, int> *visited_sensors) {
+    int previous, next_i, sensor;
+
+    for (size_t i=0; i<path.size(); i++) {
+        sensor = path[i];
+        previous = (i+1 < path.size()) ? path[i+1] : -1;  // -1 is the POI
+        next_i = (i > 0) ? path[i-1] : -1;                 // -1 is the SINK
+
+        /* If the previous sensor is a POI and the next is a SINK
+         * Add all active sensors that connect both to the POI and the SINK to the result buffer
+         */
+        if ((previous == -1) and (next_i == -1)) {
+            for (const int &bridge: this->poi_sensor[poi_number]) {
+                if (isin(this->sensor_sink, bridge) and (not isin(inactive_sensors, bridge))) {
+                    vote(*visited_sensors, bridge);
+                }
+            }
+        } else {
+            /* If the previous sensor is a POI (and the next cannot be a SINK)
+             * Add all active sensors that cover the POI and connect to the current sensor to the result
+             */
+            if (previous == -1) {
+                for (const int &cover: this->poi_sensor[poi_number]) {
+                    if (isin(this->sensor_sensor[cover], sensor) and (not isin(inactive_sensors, cover))) {
+                        vote(*visited_sensors, cover);
+                    }
+                }
+            } else {
+                /* If the previous sensor is NOT a POI and the next IS a SINK
+                 * Add all active sensors that connect to both the previous sensor and the sink
+                 */
+                if (next_i == -1) {
+                    for (const int &conn: this->sensor_sensor[previous]) {
+                        if (isin(this->sensor_sink, conn) and (not isin(inactive_sensors, conn))) {
+                            vote(*visited_sensors, conn);
+                        }
+                    }
+                } else {
+                    /* If the previous sensor is NOT a POI ant the next is NOT a sink
+                     * Add all active sensors that connect to both the previous and the next to the result
+                     */
+                    for (const int &conn: this->sensor_sensor[previous]) {
+                        if (isin(this->sensor_sensor[conn], next_i) and (not isin(inactive_sensors, conn))) {
+                            vote(*visited_sensors, conn);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+
 /** MAX-REUSE
  * To minimize the number of sensors, we try to maximize reuse of sensors (i.e. the same sensor is used in multiple
  * connection paths, each from a different POI).
@@ -198,10 +209,7 @@ int KCMC_Instance::reuse(int k, int m, int flood_level,
                          std::unordered_set<int> &inactive_sensors, std::unordered_map<int, int> *visited_sensors) {
 
     // Local buffers
-    int num_paths, inv_frequency_array[this->num_sensors],
-        paths_found, path_end, a_poi, predecessors[this->num_sensors],
-        active_covering_sensors, add_sensor, pre_k_cov_sensors;
-    std::priority_queue<LevelNode, std::vector<LevelNode>, CompareLevelNode> queue;
+    int num_paths;
 
     // First we clear out the output buffer
     visited_sensors->clear();
@@ -215,13 +223,32 @@ int KCMC_Instance::reuse(int k, int m, int flood_level,
     else {num_paths = this->flood(k, m, (flood_level < 0), inactive_sensors, visited_sensors);}
     if (num_paths >= 1000000) {throw std::runtime_error("INVALID NUMBER OF PATHS!");}
 
-    /* Then format the frequency graph as a vector for minimization, similar to the level-graph
+    // Then we find new paths over the votes
+    return this->reuse_votes(k, m, num_paths, inactive_sensors, visited_sensors);
+}
+
+
+/** REUSE VOTES
+ * Second stage of the reuse methods: paths preferring the most voted sensors, then the sensors for K-coverage.
+ * The buffer holds the votes of the flood (of num_paths paths) on input, and the used sensors on output
+ */
+int KCMC_Instance::reuse_votes(int k, int m, int num_paths,
+                               std::unordered_set<int> &inactive_sensors, std::unordered_map<int, int> *visited_sensors) {
+
+    // Local buffers
+    KCMC_TRACE("reuse_votes");
+    std::vector<int> inv_frequency_array((size_t)this->num_sensors), predecessors((size_t)this->num_sensors);
+    int paths_found, path_end, a_poi,
+        active_covering_sensors, add_sensor, pre_k_cov_sensors;
+    std::priority_queue<LevelNode, std::vector<LevelNode>, CompareLevelNode> queue;
+
+    /* Format the frequency graph as a vector for minimization, similar to the level-graph
      * This is called the *inverse frequency array* (IFA). It holds no values smaller than 1.
      * In the IFA, sensors that were not found by the flood method have frequency num_paths
      * In the IFA, sensors that were found by the flood method have freqeuency num_paths-(orig. frequency)
      * This inversion is done so the minimization loop can still be used
      */
-    std::fill(inv_frequency_array, inv_frequency_array + this->num_sensors, num_paths);
+    std::fill(inv_frequency_array.begin(), inv_frequency_array.end(), num_paths);
     for (const auto &i : *visited_sensors) {inv_frequency_array[i.first] = num_paths - i.second;}
 
     // Prepare the set of "used" sensors and clear the map of visited sensors
@@ -230,15 +257,16 @@ int KCMC_Instance::reuse(int k, int m, int flood_level,
 
     // Run for each POI, returning at the first failure
     for (a_poi=0; a_poi < this->num_pois; a_poi++) {
+        KCMC_TRACE_DETAIL("path_search", "poi", a_poi);
         paths_found = 0;  // Clear the number of paths found for the POI
         used_sensors = inactive_sensors;  // Reset the set of used sensors for each POI
 
         // While there are still paths to be found
         while (paths_found < m) {
-            std::fill(predecessors, predecessors+this->num_sensors, -2);  // Reset the predecessors buffer
+            std::fill(predecessors.begin(), predecessors.end(), -2);  // Reset the predecessors buffer
 
             // Find a path
-            path_end = this->find_path(a_poi, used_sensors, inv_frequency_array, predecessors);
+            path_end = this->find_path(a_poi, used_sensors, inv_frequency_array.data(), predecessors.data());
 
             // If the path ends in an invalid sensor, break the loop. Other POIs will fix it
             if (path_end == -1) {break;}
@@ -260,7 +288,7 @@ int KCMC_Instance::reuse(int k, int m, int flood_level,
      * Update the frequencies to the IFA
      * Increase (thus, subtract from) the frequency of each sensor the number of POIs it covers
      */
-    std::fill(inv_frequency_array, inv_frequency_array + this->num_sensors, num_paths);
+    std::fill(inv_frequency_array.begin(), inv_frequency_array.end(), num_paths);
     for (const auto &i : *visited_sensors) {inv_frequency_array[i.first] = num_paths - i.second;}
     for (const auto &i : this->sensor_poi) {inv_frequency_array[i.first] -= (int)(i.second.size());}
 
@@ -273,13 +301,17 @@ int KCMC_Instance::reuse(int k, int m, int flood_level,
      *     For each added sensor, decrease its value in the IFA (thus givving it more priority).
      *     For each added sensor, increase its frequency in the final frequency map of each sensor.
      */
+    KCMC_TRACE("k_coverage_fixup");
     for (a_poi=0; a_poi < this->num_pois; a_poi++) {
-        while (not queue.empty()) {queue.pop();}  // Empty the queue
+        while (not queue.empty()) {queue.pop(); KCMC_COUNT(STAT_QUEUE_POP, 1);}  // Empty the queue
         // Count and enqueue the covering sensors
         active_covering_sensors = 0;
         for (const int a_sensor : this->poi_sensor[a_poi]) {
             if (isin(*visited_sensors, a_sensor)) {active_covering_sensors++;}  // Count the active covering sensors
-            else {queue.push({a_sensor, inv_frequency_array[a_sensor]});}  // Add to the queue the inactive sensors
+            else {  // Add to the queue the inactive sensors
+                queue.push({a_sensor, inv_frequency_array[a_sensor]});
+                KCMC_COUNT(STAT_QUEUE_PUSH, 1);
+            }
             if (active_covering_sensors >= k) {break;}  // Stop prematurely if we have enough covering sensors
         }
         // Add the first sensors in the queue until we have enough sensors
@@ -287,6 +319,7 @@ int KCMC_Instance::reuse(int k, int m, int flood_level,
             vote(*visited_sensors, queue.top().index);  // Increase the usage of this sensor
             inv_frequency_array[queue.top().index] -= 1;  // Decrease the frequency of this sensor in the IFA
             queue.pop();  // Remove the sensor from the queue
+            KCMC_COUNT(STAT_QUEUE_POP, 1);
         }
     }
 
@@ -301,21 +334,26 @@ int KCMC_Instance::reuse(int k, int m, int flood_level,
     // Return the number of otherwise inactive sensors that were added only to guarantee k-coverage
     return ((int)(visited_sensors->size()))-pre_k_cov_sensors;
 }
-int KCMC_Instance::reuse(int k, int m,
-                         std::unordered_set<int> &inactive_sensors, std::unordered_map<int, int> *visited_sensors) {
+
+
+/** BEST REUSE
+ * Keeps the reuse variant with fewest sensors. Ties prefer the max-flood, then the no-flood variant
+ */
+int best_reuse(const std::function<int(int, std::unordered_map<int, int>*)> &variant,
+               std::unordered_map<int, int> *visited_sensors) {
     int added_min_r, min_r,  // Buffer for the number of nodes added for K-coverage and the resulting number of nodes
         added_no_r,  no_r,   // for each pair of buffers, we use one of the reuse variations
         added_max_r, max_r;
     std::unordered_map<int, int> min_visited, no_visited, max_visited;
     std::unordered_set<int> set_used_installation_spots;
 
-    added_min_r = this->reuse(k, m, -1, inactive_sensors, &min_visited);
+    added_min_r = variant(-1, &min_visited);
     setify(set_used_installation_spots, &min_visited);
     min_r = (int)(set_used_installation_spots.size());
-    added_no_r  = this->reuse(k, m,  0, inactive_sensors, &no_visited);
+    added_no_r  = variant( 0, &no_visited);
     setify(set_used_installation_spots, &no_visited);
     no_r = (int)(set_used_installation_spots.size());
-    added_max_r = this->reuse(k, m,  1, inactive_sensors, &max_visited);
+    added_max_r = variant( 1, &max_visited);
     setify(set_used_installation_spots, &max_visited);
     max_r = (int)(set_used_installation_spots.size());
 
@@ -338,3 +376,34 @@ int KCMC_Instance::reuse(int k, int m,
         }
     }
 }
+
+
+int KCMC_Instance::reuse(int k, int m,
+                         std::unordered_set<int> &inactive_sensors, std::unordered_map<int, int> *visited_sensors) {
+    return best_reuse([&](const int flood_level, std::unordered_map<int, int> *variant_visited) {
+        return this->reuse(k, m, flood_level, inactive_sensors, variant_visited);
+    }, visited_sensors);
+}
+
+
+/** HEURISTIC BY NAME
+ * Runs one of the preprocessors by the name used in the optimizer output, storing the set of used sensors.
+ * Returns the number of paths found (flood), of sensors added for k-coverage (reuse) or 0 (dinic)
+ */
+int KCMC_Instance::heuristic(const std::string &name, int k, int m,
+                             std::unordered_set<int> &inactive_sensors, std::unordered_set<int> *used_sensors) {
+    std::unordered_map<int, int> visited_sensors;
+    int result = 0;
+
+    if (name == "dinic") {this->local_optima(k, m, inactive_sensors, used_sensors); return 0;}
+    else if (name == "min_flood")  {result = this->flood(k, m, false, inactive_sensors, &visited_sensors);}
+    else if (name == "max_flood")  {result = this->flood(k, m, true, inactive_sensors, &visited_sensors);}
+    else if (name == "no_reuse")   {result = this->reuse(k, m, 0, inactive_sensors, &visited_sensors);}
+    else if (name == "min_reuse")  {result = this->reuse(k, m, 1, inactive_sensors, &visited_sensors);}
+    else if (name == "max_reuse")  {result = this->reuse(k, m, -1, inactive_sensors, &visited_sensors);}
+    else if (name == "best_reuse") {result = this->reuse(k, m, inactive_sensors, &visited_sensors);}
+    else {throw std::runtime_error("UNKNOWN HEURISTIC " + name);}
+
+    setify(*used_sensors, &visited_sensors);
+    return result;
+}
@@ -0,0 +1,97 @@
+/*
+ * KCMC Instance exact optimizer
+ * Certifies the minimal number of sensors of an instance by branch-and-bound, without external solvers
+ */
+
+
+// STDLib Dependencies
+#include <csignal>   // SIGINT and other signals
+#include <iostream>  // cin, cout, endl
+#include <chrono>    // time functions
+#include <iomanip>   // setprecision
+
+// Dependencies from this package
+#include "kcmc_instance.h"
+#include "branch_and_bound.h"
+#include "genetic_algorithm_operators.h"  // exit_signal_handler
+
+
+/* #####################################################################################################################
+ * RUNTIME
+ * */
+
+
+void help() {
+    std::cout << "Please, use the correct input for the KCMC exact (branch-and-bound) optimizer:" << std::endl << std::endl;
+    std::cout << "./optimizer_bnb <instance> <k> <m> [<time limit>] [<threads>]" << std::endl;
+    std::cout << "  where:" << std::endl << std::endl;
+    std::cout << "<instance> is the serialized KCMC instance" << std::endl;
+    std::cout << "K > 0 is the desired K coverage" << std::endl;
+    std::cout << "M > 0 is the desired M connectivity" << std::endl;
+    std::cout << "<time limit> (optional) is the limit of the search, in seconds. Default 0 (no limit)" << std::endl;
+    std::cout << "<threads> (optional) is the number of search threads. Default 0 (one per core)" << std::endl;
+    std::cout << "Prints a line in the format of the optimizer (gap to the root bound), with operation bnb_optimal, bnb_timeout or"
+              << " bnb_infeasible. Validity is checked with exact connectivity (maximum flow)" << std::endl;
+    std::cout << "Prints the root lower bound, the number of nodes and the origin of the solution to STDERR" << std::endl;
+    std::cout << "--stats (optional, before anything else) prints the hot-path counters to STDERR at exit."
+              << " Counters are only compiled in builds configured with -DKCMC_STATS=ON" << std::endl;
+    std::cout << "--trace <file> (optional, before anything else) writes a timeline of the phases (parse, level graph,"
+              << " path searches, floods, GA steps...) to the file at exit, as Chrome trace-event JSON" << std::endl;
+    exit(0);
+}
+
+
+int main(int argc, char* const argv[]) {
+    {int skip = diagnostic_flags(argc, argv); argv += skip; argc -= skip;}  // --stats and --trace, at exit
+    if (argc < 4) { help(); }
+
+    // Registers the signal handlers
+    signal(SIGINT, exit_signal_handler);
+    signal(SIGALRM, exit_signal_handler);
+    signal(SIGABRT, exit_signal_handler);
+    signal(SIGTERM, exit_signal_handler);
+
+    // Parse arguments
+    auto *instance = new KCMC_Instance(argv[1]);
+    int k = std::stoi(argv[2]), m = std::stoi(argv[3]);
+    double time_limit = (argc > 4) ? std::stod(argv[4]) : 0.0;
+    int num_threads = (argc > 5) ? std::stoi(argv[5]) : 0;
+    std::unordered_set<int> emptyset, solution;
+    std::unordered_map<int, int> visited_sensors;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    KCMC_BranchAndBound solver(instance, k, m);
+
+    // Incumbents from the heuristics
+    instance->local_optima(k, m, emptyset, &solution);
+    solver.add_incumbent(solution, "dinic");
+    instance->reuse(k, m, emptyset, &visited_sensors);
+    solution.clear();
+    setify(solution, &visited_sensors);
+    solver.add_incumbent(solution, "best_reuse");
+
+    // Search
+    solver.solve(time_limit, num_threads);
+    auto end = std::chrono::high_resolution_clock::now();
+    long duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    // Print a line in the format of the optimizer
+    std::string status = solver.infeasible ? "bnb_infeasible" : (solver.optimal ? "bnb_optimal" : "bnb_timeout");
+    bool valid = (not solver.infeasible) and solver.feasible(solver.incumbent);
+    int objective = solver.infeasible ? instance->num_sensors : solver.incumbent_size();
+    std::ostringstream out;
+    out << instance->key() << "\t" << k << "\t" << m
+        << "\t" << status
+        << "\t" << duration
+        << "\t" << (valid ? "OK" : "INVALID")
+        << "\t" << objective
+        << "\t" << std::fixed << std::setprecision(5)
+        << (double)(instance->num_sensors - objective) / (double)(instance->num_sensors)
+        << "\t";
+    for (const char &installed : solver.incumbent) {out << (int)installed;}
+    out << "\t" << (solver.optimal ? 0.0 : optimality_gap(objective, solver.root_bound));
+    std::cout << out.str() << std::endl;
+    std::cerr << "ROOT BOUND " << solver.root_bound << " NODES " << solver.num_nodes
+              << " SOLUTION FROM " << solver.incumbent_source << std::endl;
+    return 0;
+}
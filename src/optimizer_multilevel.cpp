@@ -0,0 +1,119 @@
+/*
+ * KCMC Instance multilevel optimizer
+ * Optimizes large instances by coarsening their sensor graph, solving the coarsest level and refining it back
+ */
+
+
+// STDLib Dependencies
+#include <csignal>   // SIGINT and other signals
+#include <iostream>  // cin, cout, endl
+#include <chrono>    // time functions
+
+// Dependencies from this package
+#include "kcmc_instance.h"
+#include "multilevel.h"
+#include "lower_bounds.h"
+#include "genetic_algorithm_operators.h"  // exit_signal_handler
+#include "result_sink.h"
+
+
+/* #####################################################################################################################
+ * RUNTIME
+ * */
+
+
+void help() {
+    std::cout << "Please, use the correct input for the KCMC multilevel optimizer:" << std::endl << std::endl;
+    std::cout << "./optimizer_multilevel [--coarsest <sensors>] [--solver <name>] [--generations <g>] <instance> <k> <m>" << std::endl;
+    std::cout << "  where:" << std::endl << std::endl;
+    std::cout << "--coarsest <sensors> (optional) stops coarsening once a level has at most this many sensors."
+              << " Default 500" << std::endl;
+    std::cout << "--solver <name> (optional) solves the coarsest level: a heuristic of the optimizer (dinic, min_flood,"
+              << " max_flood, no_reuse, min_reuse, max_reuse, best_reuse) or genalg. Default best_reuse" << std::endl;
+    std::cout << "--generations <g> (optional) is the number of generations of genalg. Default 200" << std::endl;
+    std::cout << "<instance> is the serialized KCMC instance" << std::endl;
+    std::cout << "K > 0 is the desired K coverage" << std::endl;
+    std::cout << "M > 0 is the desired M connectivity" << std::endl;
+    std::cout << "Each level merges pairs of neighbor sensors (preferring those covering the same POIs) without lowering"
+              << " the coverage of any POI below K. The solution of the coarsest level is projected level by level,"
+              << " repaired with exact augmenting paths and refined by deactivating the sensors no POI needs" << std::endl;
+    std::cout << "Prints a line in the format of the optimizer, with operation multilevel_<solver>_<levels>, and the"
+              << " sensors and active sensors of each level to STDERR" << std::endl;
+    std::cout << "On SIGINT, SIGTERM or SIGALRM it stops coarsening and refining, and prints the solution so far (projected"
+              << " to the instance and repaired). A second signal exits at once" << std::endl;
+    std::cout << "--format <tsv|jsonl|binary> (optional, right after --stats and --trace) is the format of the results:"
+              << " TSV lines (default), JSON Lines, or the binary records described in result_sink.h" << std::endl;
+    std::cout << "--encoding <bits|delta|rle> (optional, with --format) is the encoding of the solutions in text results:"
+              << " 0/1 characters (default), or base64 of the gaps between active sensors or of the runs of the bits."
+              << " instance_evaluator --decode reads them back" << std::endl;
+    std::cout << "--stats (optional, before anything else) prints the hot-path counters to STDERR at exit."
+              << " Counters are only compiled in builds configured with -DKCMC_STATS=ON" << std::endl;
+    std::cout << "--trace <file> (optional, before anything else) writes a timeline of the phases (parse, level graph,"
+              << " path searches, floods, GA steps...) to the file at exit, as Chrome trace-event JSON" << std::endl;
+    exit(0);
+}
+
+
+int main(int argc, char* const argv[]) {
+    {int skip = diagnostic_flags(argc, argv); argv += skip; argc -= skip;}  // --stats and --trace, at exit
+    {int skip = result_flags(argc, argv); argv += skip; argc -= skip;}  // --format and --encoding of the results
+
+    // Optional leading flags
+    int coarsest_sensors = 500, generations = 200;
+    std::string solver = "best_reuse";
+    while ((argc > 1) and (std::string(argv[1]).rfind("--", 0) == 0)) {
+        if ((std::string(argv[1]) == "--coarsest") and (argc > 2)) {coarsest_sensors = std::stoi(argv[2]); argv++; argc--;}
+        else if ((std::string(argv[1]) == "--solver") and (argc > 2)) {solver = argv[2]; argv++; argc--;}
+        else if ((std::string(argv[1]) == "--generations") and (argc > 2)) {generations = std::stoi(argv[2]); argv++; argc--;}
+        else {help();}
+        argv++; argc--;
+    }
+    if ((argc < 4) or (coarsest_sensors < 1)) { help(); }
+
+    // Registers the signal handlers
+    signal(SIGINT, exit_signal_handler);
+    signal(SIGALRM, exit_signal_handler);
+    signal(SIGABRT, exit_signal_handler);
+    signal(SIGTERM, exit_signal_handler);
+
+    // Parse arguments
+    auto *instance = new KCMC_Instance(argv[1]);
+    int k = std::stoi(argv[2]), m = std::stoi(argv[3]);
+    std::unordered_set<int> used_sensors, inactive_sensors;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    KCMC_Multilevel multilevel(instance, k, m, coarsest_sensors);
+    int num_levels = multilevel.solve(solver, generations, &used_sensors);
+    auto end = std::chrono::high_resolution_clock::now();
+    long duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    // Print a record in the format of the optimizer
+    KCMC_Graph graph(instance);
+    KCMC_Bounds bounds;
+    lower_bounds(&graph, k, m, &bounds);
+    instance->invert_set(used_sensors, &inactive_sensors);
+    bool valid = instance->validate(false, k, m, inactive_sensors);
+    std::vector<char> individual((size_t)instance->num_sensors, 0);
+    for (const int &a_sensor : used_sensors) {individual[a_sensor] = 1;}
+
+    KCMC_Record record;
+    record.text("instance", instance->key())
+          .integer("k", k)
+          .integer("m", m)
+          .text("operation", "multilevel_" + solver + "_" + std::to_string(num_levels))
+          .integer("runtime_us", duration)
+          .text("valid", valid ? "OK" : "INVALID")
+          .integer("used", (long long)used_sensors.size())
+          .real("compression", (double)(inactive_sensors.size()) / (double)(instance->num_sensors), 5)
+          .bits("solution", std::move(individual))
+          .real("gap", optimality_gap((int)(used_sensors.size()), bounds.best), 5);
+    results().write(std::move(record));
+
+    std::cerr << "LEVELS";
+    for (int level=0; level<num_levels; level++) {
+        std::cerr << " " << multilevel.level_sensors[level] << ":" << multilevel.level_active[level];
+    }
+    std::cerr << " (SENSORS:ACTIVE) REFINED " << multilevel.num_refined << std::endl;
+    delete instance;
+    return 0;
+}
@@ -5,12 +5,78 @@
 #include <queue>      // queue
 #include <iostream>   // cin, cout, endl
 #include <chrono>     // time functions
-#include <iomanip>    // setfill, setw
-#include <cstring>    // strcpy
+#include <fstream>    // ifstream, ofstream
+#include <sys/resource.h>  // getrusage
 
 // Dependencies from this package
 #include "kcmc_instance.h"  // KCMC Instance class headers
-#include "genetic_algorithm_operators.h"  // exit_signal_handler
+#include "genetic_algorithm_operators.h"  // exit_signal_handler, exit_requested
+#include "presolve.h"  // KCMC Presolve
+#include "ilp_writer.h"  // KCMC ILP (MIP starts)
+#include "lower_bounds.h"  // Optimality gaps
+#include "sweep.h"  // KCMC Sweep (many pairs)
+#include "tiling.h"  // KCMC Tiling (very large areas)
+#include "components.h"  // KCMC Components (sparse instances)
+#include "reorder.h"  // KCMC Reorder (locality)
+#include "result_sink.h"  // Asynchronous output
+#include "allocation_hook.h"  // Allocation counters (--resources)
+
+
+// Heuristics of the optimizer, in the order of its output
+static const std::vector<std::string> HEURISTICS = {"dinic", "min_flood", "max_flood", "no_reuse", "min_reuse",
+                                                    "max_reuse", "best_reuse"};
+
+
+/* #####################################################################################################################
+ * RESOURCE ACCOUNTING
+ * */
+
+
+/* PEAK RESIDENT SET
+ * VmHWM of the process, in KB. Resetting it (Linux 4.0 and later) makes it the current resident set, so the peak read
+ *   after some work is the peak of that work alone. Without /proc, the peak of the process since its start
+ */
+static void reset_peak_rss() {
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    if (clear_refs.is_open()) {clear_refs << "5" << std::flush;}
+}
+
+static long long peak_rss_kb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {return std::stoll(line.substr(6));}
+    }
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return (long long)usage.ru_maxrss;
+}
+
+
+/* RESOURCE USAGE
+ * CPU time (user and system, of every thread) and peak resident set of the process, and its allocations so far (counted
+ *   only with --resources). Resetting the peak first makes it the current resident set.
+ * The difference of two usages is the cost of what ran between them. Its peak is the one of the later usage: with the
+ *   peak reset at the earlier one, the largest resident set of the process while that work ran
+ */
+struct ResourceUsage {
+    long long cpu_us, peak_rss_kb, allocations, allocated_bytes;
+};
+
+ResourceUsage resource_usage(const bool reset_peak = false) {
+    if (reset_peak) {reset_peak_rss();}
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    const AllocationCounts allocations = allocation_counts();
+    return {(long long)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000
+            + (long long)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec),
+            peak_rss_kb(), allocations.allocations, allocations.bytes};
+}
+
+ResourceUsage operator-(const ResourceUsage &end, const ResourceUsage &start) {
+    return {end.cpu_us - start.cpu_us, end.peak_rss_kb,
+            end.allocations - start.allocations, end.allocated_bytes - start.allocated_bytes};
+}
 
 
 /* #####################################################################################################################
@@ -18,57 +84,219 @@
  * */
 
 
-void printout_short(KCMC_Instance *instance, int k, int m,
+void printout_short(KCMC_Instance *instance, KCMC_Presolve *presolve, KCMC_Reorder *reorder,
+                    int k, int m, const int lower_bound,
                     const int num_sensors, const std::string operation,
-                    const long duration, std::unordered_set<int> &used_installation_spots) {
+                    const long duration, std::unordered_set<int> &used_installation_spots,
+                    const ResourceUsage *resources, const long long footprint) {
+
+    // If the heuristic ran on the presolved instance, map its sensors back to the original instance
+    if (presolve != nullptr) {
+        std::unordered_set<int> reduced_installation_spots = used_installation_spots;
+        presolve->expand(reduced_installation_spots, &used_installation_spots);
+    }
 
-    // Validate the instance
+    // Validate the instance. A reordered instance is validated in its own indexes (the greedy validator breaks ties by
+    // index, as the heuristics do), and its sensors then mapped back to the original instance
     std::unordered_set<int> inactive_sensors;
-    instance->invert_set(used_installation_spots, &inactive_sensors);
-    bool valid = instance->validate(false, k, m, inactive_sensors);
+    KCMC_Instance *validated = (reorder != nullptr) ? reorder->reordered : instance;
+    validated->invert_set(used_installation_spots, &inactive_sensors);
+    bool valid = validated->validate(false, k, m, inactive_sensors);
+    if (reorder != nullptr) {
+        std::unordered_set<int> reordered_installation_spots = used_installation_spots;
+        reorder->expand(reordered_installation_spots, &used_installation_spots);
+    }
 
     // Reformat the used installation spots as an array of 0/1
-    int individual[num_sensors];
-    std::fill(individual, individual+num_sensors, 0);
+    std::vector<char> individual((size_t)num_sensors, 0);
     for (const int &used_spot : used_installation_spots) { individual[used_spot] = 1; }
 
-    // Prepare the output buffer
-    std::ostringstream out;
-
-    // Print a line with:
+    // Write a record with:
     // - The key of the instance
     // - The name of the current operation
     // - The amount of microsseconds the method needed to run
     // - The number of used installation spots
     // - The resulting map of the instance, as a binary of num_sensors bits
-    out << instance->key() << "\t" << k << "\t" << m
-        << "\t" << operation
-        << "\t" << duration
-        << "\t" << (valid ? "OK" : "INVALID")
-        << "\t" << used_installation_spots.size()
-        << "\t" << std::fixed << std::setprecision(5) << (double)(inactive_sensors.size()) / (double)num_sensors
-        << "\t";
-    for (int i=0; i<num_sensors; i++) {out << individual[i];}
-    // Flush
-    std::cout << out.str() << std::endl;
+    // - The optimality gap of the number of used installation spots to the lower bound
+    // - If required, the resources of the method (CPU microsseconds, peak RSS while it ran in KB, allocations and
+    //   allocated bytes) and the memory footprint of the instance, in bytes
+    KCMC_Record record;
+    record.text("instance", instance->key())
+          .integer("k", k)
+          .integer("m", m)
+          .text("operation", operation)
+          .integer("runtime_us", duration)
+          .text("valid", valid ? "OK" : "INVALID")
+          .integer("used", (long long)used_installation_spots.size())
+          .real("compression", (double)(inactive_sensors.size()) / (double)num_sensors, 5)
+          .bits("solution", std::move(individual))
+          .real("gap", optimality_gap((int)(used_installation_spots.size()), lower_bound), 5);
+    if (resources != nullptr) {
+        record.integer("cpu_us", resources->cpu_us)
+              .integer("peak_rss_kb", resources->peak_rss_kb)
+              .integer("allocations", resources->allocations)
+              .integer("allocated_bytes", resources->allocated_bytes)
+              .integer("footprint_bytes", footprint);
+    }
+    results().write(std::move(record));
+}
+
+
+/** MIP STARTS
+ * Writes the MIP starts of the solution for each model, as <prefix>.<operation>.<model>.mst
+ */
+void write_mip_starts(std::vector<KCMC_ILP*> &models, const std::string &prefix, const std::string &operation,
+                      std::unordered_set<int> &used_installation_spots) {
+    for (KCMC_ILP *ilp : models) {
+        std::string filename = prefix + "." + operation + ((ilp->model == MULTI_FLOW) ? ".multi_flow" : ".single_flow") + ".mst";
+        int incomplete = ilp->write_start(filename, used_installation_spots);
+        if (incomplete > 0) {std::cerr << filename << " HAS " << incomplete << " POIS WITH INCOMPLETE FLOW" << std::endl;}
+    }
+}
+
+
+/** OPTIMIZE
+ * Runs every heuristic for a single (K, M) pair. With a sweep, the heuristics read its shared paths (and their
+ *   runtimes are only the work of this pair); otherwise each one runs from scratch on the target instance.
+ * With a tiling, each heuristic runs on its tiles, and the number after its name is the sensors added by the repair.
+ * With components, each heuristic runs on every independent group, in parallel.
+ * With a reorder, the heuristics (and the presolve) run on the reordered instance, and solutions are mapped back.
+ * With a footprint (not negative), each line also has the resources of its heuristic
+ */
+void optimize(KCMC_Instance *instance, KCMC_Graph *graph, KCMC_Sweep *sweep, KCMC_Tiling *tiling,
+              KCMC_Components *components, KCMC_Reorder *reorder, const int k, const int m, const bool use_presolve, const std::string &mip_start_prefix, const long long footprint) {
+    int result;
+    std::unordered_set<int> emptyset, set_used_installation_spots;
+    ResourceUsage usage {};
+
+    // Prepare the clock buffers
+    auto start = std::chrono::high_resolution_clock::now();
+    auto end = std::chrono::high_resolution_clock::now();
+    long duration, presolve_duration = 0;
+
+    // Lower bounds of the instance, for the optimality gaps
+    KCMC_Bounds bounds;
+    lower_bounds(graph, k, m, &bounds);
+
+    // Models of the MIP starts, if required
+    std::vector<KCMC_ILP*> models;
+    if (not mip_start_prefix.empty()) {
+        models.push_back(new KCMC_ILP(instance, k, m, SINGLE_FLOW, false, emptyset));
+        models.push_back(new KCMC_ILP(instance, k, m, MULTI_FLOW, false, emptyset));
+    }
+
+    // Presolve the instance, if required. The heuristics run on the TARGET instance
+    KCMC_Instance *target = (reorder != nullptr) ? reorder->reordered : instance;
+    KCMC_Presolve *presolve = nullptr;
+    if (use_presolve) {
+        start = std::chrono::high_resolution_clock::now();
+        presolve = new KCMC_Presolve(target, k, m, false);
+        end = std::chrono::high_resolution_clock::now();
+        presolve_duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        target = presolve->reduced;
+        std::cerr << "PRESOLVE " << presolve_duration << "us REMOVED " << presolve->removed_sensors.size()
+                  << " (UNREACHABLE " << presolve->num_unreachable << " DEAD-ENDS " << presolve->num_dead_ends
+                  << ") FORCED " << presolve->forced_sensors.size() << std::endl;
+    }
+
+    // Each heuristic, in the order of the output. All but dinic print their result with the name
+    for (const std::string &name : HEURISTICS) {
+        if (exit_requested()) {break;}
+        set_used_installation_spots.clear();
+        usage = resource_usage(footprint >= 0);
+        start = std::chrono::high_resolution_clock::now();
+        if (tiling != nullptr) {result = tiling->heuristic(name, k, m, &set_used_installation_spots);}
+        else if (components != nullptr) {result = components->heuristic(name, k, m, &set_used_installation_spots);}
+        else if (sweep != nullptr) {result = sweep->heuristic(name, k, m, &set_used_installation_spots);}
+        else {result = target->heuristic(name, k, m, emptyset, &set_used_installation_spots);}
+        end = std::chrono::high_resolution_clock::now();
+        usage = resource_usage() - usage;
+        duration = presolve_duration + std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        printout_short(instance, presolve, reorder, k, m, bounds.best, instance->num_sensors,
+                       ((name == "dinic") and (tiling == nullptr)) ? name : name + "_" + std::to_string(result),
+                       duration, set_used_installation_spots, (footprint >= 0) ? &usage : nullptr, footprint);
+        write_mip_starts(models, mip_start_prefix, name, set_used_installation_spots);
+    }
+
+    delete presolve;
+    for (KCMC_ILP *ilp : models) {delete ilp;}
 }
 
 
 void help() {
     std::cout << "Please, use the correct input for the KCMC instance heuristic optimizer:" << std::endl << std::endl;
-    std::cout << "./optimizer_dinic <instance> <k> <m>" << std::endl;
+    std::cout << "./optimizer [--presolve] [--tiles <n> | --components | --reorder <ordering>] [--resources] [--mip-start <prefix>] <instance> <k> <m>" << std::endl;
+    std::cout << "./optimizer [--presolve] [--tiles <n> | --components | --reorder <ordering>] [--resources] [--mip-start <prefix>] <instance> <pairs>" << std::endl;
     std::cout << "  where:" << std::endl << std::endl;
+    std::cout << "--presolve (optional) runs the heuristics on the presolved instance, without useless sensors."
+              << " Solutions are mapped back and validated on the original instance."
+              << " The presolve time is added to the time of each heuristic" << std::endl;
+    std::cout << "--tiles <n> (optional) splits the area in n x n overlapping tiles (the margin is the communication radius,"
+              << " or the coverage radius if larger), runs each heuristic on every tile in parallel, with the"
+              << " sensors toward the sink as a virtual sink, and repairs the union of their solutions with exact"
+              << " augmenting paths. The number after each heuristic name is then the number of sensors added by the"
+              << " repair. Needs an instance regenerated from its key. Pairs are solved one by one" << std::endl;
+    std::cout << "--components (optional) drops the sensors in connected components without a sink from every path"
+              << " search, and runs each heuristic on the independent groups of components (sharing no POI) in parallel."
+              << " Fails before any heuristic, listing them, if some POI is covered only by such sensors."
+              << " Pairs are solved one by one" << std::endl;
+    std::cout << "--reorder <hilbert|rcm> (optional) relabels the sensors and POIs so that neighbors have close indexes"
+              << " (by a Hilbert curve over the placements, or by reverse Cuthill-McKee over the sensor graph), and runs"
+              << " the heuristics on the relabeled instance. Solutions are printed with the original indexes. hilbert"
+              << " needs an instance regenerated from its key" << std::endl;
+    std::cout << "--mip-start (optional) writes the MIP start of each heuristic solution for the single-flow and"
+              << " multi-flow ILPs (as written by ilp_exporter, on every sensor), as <prefix>.<heuristic>.<model>.mst"
+              << std::endl;
     std::cout << "<instance> is the serialized KCMC instance" << std::endl;
     std::cout << "Integer 0 < K < 10 is the desired K coverage" << std::endl;
     std::cout << "Integer 0 < M < 10 is the desired M connectivity" << std::endl;
     std::cout << "K migth be the pair K,M in the format (K{k}M{m}). In this case M is ignored" << std::endl;
+    std::cout << "<pairs> is a list of pairs in the same format, as (K1M1)(K2M1)(K3M3), with one result block per pair."
+              << " The level graph, the coverage and the greedy paths are shared by all pairs (without --presolve),"
+              << " and paths are extended as M grows: each runtime is the work of its own pair only."
+              << " Pairs that fail are reported in the standard error" << std::endl;
+    std::cout << "The last column of each line is the optimality gap to the lower bound of the instance" << std::endl;
+    std::cout << "--resources (optional) adds the columns CPU time (us, all threads), peak RSS (KB, the"
+              << " largest resident set while it ran, as the peak is reset before each heuristic), allocations and"
+              << " allocated bytes of each heuristic (presolve excluded), and the estimated memory footprint of the"
+              << " instance (bytes). The footprint of each adjacency structure is written to the standard error" << std::endl;
+    std::cout << "--format <tsv|jsonl|binary> (optional, right after --stats and --trace) is the format of the results:"
+              << " TSV lines (default), JSON Lines, or the binary records described in result_sink.h" << std::endl;
+    std::cout << "--encoding <bits|delta|rle> (optional, with --format) is the encoding of the solutions in text results:"
+              << " 0/1 characters (default), or base64 of the gaps between active sensors or of the runs of the bits."
+              << " instance_evaluator --decode reads them back" << std::endl;
+    std::cout << "--stats (optional, before anything else) prints the hot-path counters to STDERR at exit."
+              << " Counters are only compiled in builds configured with -DKCMC_STATS=ON" << std::endl;
+    std::cout << "--trace <file> (optional, before anything else) writes a timeline of the phases (parse, level graph,"
+              << " path searches, floods, GA steps...) to the file at exit, as Chrome trace-event JSON" << std::endl;
     exit(0);
 }
 
 
 int main(int argc, char* const argv[]) {
+    {int skip = diagnostic_flags(argc, argv); argv += skip; argc -= skip;}  // --stats and --trace, at exit
+    {int skip = result_flags(argc, argv); argv += skip; argc -= skip;}  // --format and --encoding of the results
     if (argc < 3) { help(); }
 
+    // Optional leading flags
+    bool use_presolve = false, resources = false;
+    bool use_components = false;
+    std::string ordering;
+    int tiles_per_side = 0;
+    std::string mip_start_prefix;
+    while ((argc > 1) and (std::string(argv[1]).rfind("--", 0) == 0)) {
+        if (std::string(argv[1]) == "--presolve") {use_presolve = true;}
+        else if (std::string(argv[1]) == "--resources") {resources = true;}
+        else if ((std::string(argv[1]) == "--mip-start") and (argc > 2)) {mip_start_prefix = argv[2]; argv++; argc--;}
+        else if ((std::string(argv[1]) == "--tiles") and (argc > 2)) {tiles_per_side = std::stoi(argv[2]); argv++; argc--;}
+        else if (std::string(argv[1]) == "--components") {use_components = true;}
+        else if ((std::string(argv[1]) == "--reorder") and (argc > 2)) {ordering = argv[2]; argv++; argc--;}
+        else {help();}
+        argv++; argc--;
+    }
+    if ((argc < 3) or ((use_presolve + (tiles_per_side > 0) + use_components) > 1)
+        or ((not ordering.empty()) and ((tiles_per_side > 0) or use_components))) { help(); }
+
     // Registers the signal handlers
     signal(SIGINT, exit_signal_handler);
     signal(SIGALRM, exit_signal_handler);
@@ -78,117 +306,113 @@ int main(int argc, char* const argv[]) {
     signal(SIGKILL, exit_signal_handler);
 
     // Buffers
-    int k, m, num_paths;
-    std::string serialized_instance, alt_k;
-    std::unordered_set<int> emptyset, seed_sensors, set_used_installation_spots;
-    std::unordered_map<int, int> used_installation_spots;
+    int k, m;
+    std::string alt_k;
+    std::unordered_set<int> emptyset;
+    std::vector<std::pair<int, int>> pairs;
 
     /* Parse base Arguments
      * Serialized KCMC Instance (will be immediately de-serialized)
-     * KCMC K and M parameters
+     * KCMC K and M parameters, or a list of (K{k}M{m}) pairs
      * */
     auto *instance = new KCMC_Instance(argv[1]);
     alt_k = argv[2];
     std::transform(alt_k.begin(), alt_k.end(),alt_k.begin(), ::toupper);
-    char p[alt_k.size()];
-    strcpy(p, alt_k.c_str());
     if (alt_k.find('K') != std::string::npos) {
-        k = ((int)p[2]) - ((int)'0');  // ONLY FOR K,M < 10!!!
-        m = ((int)p[4]) - ((int)'0');  // ONLY FOR K,M < 10!!!
+        for (size_t pos = alt_k.find('K'); pos != std::string::npos; pos = alt_k.find('K', pos+1)) {
+            size_t m_pos = alt_k.find('M', pos);
+            if (m_pos == std::string::npos) {help();}
+            pairs.emplace_back(std::stoi(alt_k.substr(pos+1, m_pos-pos-1)), std::stoi(alt_k.substr(m_pos+1)));
+        }
     } else {
-        k = std::stoi(argv[2]);
-        m = std::stoi(argv[3]);
+        if (argc < 4) { help(); }
+        pairs.emplace_back(std::stoi(argv[2]), std::stoi(argv[3]));
     }
+    const bool sweep = (pairs.size() > 1);
 
-    // Prepare the clock buffers
-    auto start = std::chrono::high_resolution_clock::now();
-    auto end = std::chrono::high_resolution_clock::now();
-    long duration;
+    // Allocation counters and memory footprint of the instance, if required
+    long long footprint = -1;
+    if (resources) {
+        allocation_counting(true);
+        std::vector<std::pair<std::string, size_t>> structures;
+        footprint = (long long)(instance->footprint(&structures));
+        std::cerr << "FOOTPRINT " << footprint;
+        for (const auto &structure : structures) {std::cerr << "\t" << structure.first << " " << structure.second;}
+        std::cerr << std::endl;
+    }
+
+    // Compact graph of the instance, for the lower bounds of each pair
+    KCMC_Graph graph(instance);
+
+    // Relabeled instance, where the heuristics run
+    KCMC_Reorder *reorder = nullptr;
+    if (not ordering.empty()) {
+        auto start = std::chrono::high_resolution_clock::now();
+        reorder = new KCMC_Reorder(instance, parse_ordering(ordering));
+        std::cerr << "REORDER " << ordering << " BUILT IN "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now()
+                                                                           - start).count()
+                  << "us, MEAN EDGE SPAN " << KCMC_Reorder::mean_edge_span(instance) << " TO "
+                  << KCMC_Reorder::mean_edge_span(reorder->reordered) << std::endl;
+    }
+
+    // Shared paths of the sweep
+    KCMC_Sweep *shared = nullptr;
+    if (sweep and (not use_presolve) and (tiles_per_side < 1) and (not use_components)) {
+        shared = new KCMC_Sweep((reorder != nullptr) ? reorder->reordered : instance, emptyset);
+    }
+
+    // Tiles of the instance
+    KCMC_Tiling *tiling = nullptr;
+    if (tiles_per_side > 0) {
+        auto start = std::chrono::high_resolution_clock::now();
+        tiling = new KCMC_Tiling(instance, &graph, tiles_per_side,
+                                 std::max(instance->sensor_coverage_radius, instance->sensor_communication_radius));
+        std::cerr << "TILING " << tiles_per_side << "x" << tiles_per_side << " BUILT IN "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now()
+                                                                           - start).count()
+                  << "us, " << tiling->num_solved_tiles << " TILES WITH POIS AND SINKS" << std::endl;
+    }
+
+    // Components of the instance. Stranded POIs fail every pair
+    KCMC_Components *components = nullptr;
+    if (use_components) {
+        auto start = std::chrono::high_resolution_clock::now();
+        components = new KCMC_Components(instance, &graph);
+        std::cerr << "COMPONENTS BUILT IN "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now()
+                                                                           - start).count()
+                  << "us, " << components->num_groups << " GROUPS WITH SINKS, " << components->num_dead_components
+                  << " COMPONENTS WITHOUT SINKS (" << components->dead_sensors.size() << " SENSORS)" << std::endl;
+        if (not components->stranded_pois.empty()) {
+            std::cerr << components->report() << std::endl;
+            throw std::runtime_error("INVALID INSTANCE! (STRANDED POIS)");
+        }
+    }
 
     // Print the header
-    // printf("Key\tK\tM\tOperation\tRuntime\tValid\tObjective\tCompression\tSolution\n");
-
-    // Validate the whole instance, getting the first local optima using DINIC Algorithm
-    set_used_installation_spots.clear();
-    start = std::chrono::high_resolution_clock::now();
-    instance->local_optima(k, m, emptyset, &set_used_installation_spots);
-    end = std::chrono::high_resolution_clock::now();
-    duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-    printout_short(instance, k, m, instance->num_sensors,
-                   "dinic",
-                   duration, set_used_installation_spots);
-
-    // Process the Minimal-Flood mapping of the instance
-    used_installation_spots.clear();
-    start = std::chrono::high_resolution_clock::now();
-    num_paths = instance->flood(k, m, false, emptyset, &used_installation_spots);
-    end = std::chrono::high_resolution_clock::now();
-    duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-    set_used_installation_spots.clear();
-    setify(set_used_installation_spots, &used_installation_spots);
-    printout_short(instance, k, m, instance->num_sensors,
-                   "min_flood_" + std::to_string(num_paths),  // Add the number of paths found
-                   duration, set_used_installation_spots);
-
-    // Process the Max-Flood mapping of the instance
-    used_installation_spots.clear();
-    start = std::chrono::high_resolution_clock::now();
-    num_paths = instance->flood(k, m, true, emptyset, &used_installation_spots);
-    end = std::chrono::high_resolution_clock::now();
-    duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-    set_used_installation_spots.clear();
-    setify(set_used_installation_spots, &used_installation_spots);
-    printout_short(instance, k, m, instance->num_sensors,
-                   "max_flood_" + std::to_string(num_paths),  // Add the number of paths found
-                   duration, set_used_installation_spots);
-
-    // Process the No-Flood Reuse mapping of the instance
-    used_installation_spots.clear();
-    start = std::chrono::high_resolution_clock::now();
-    num_paths = instance->reuse(k, m, 0,emptyset, &used_installation_spots);
-    end = std::chrono::high_resolution_clock::now();
-    duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-    set_used_installation_spots.clear();
-    setify(set_used_installation_spots, &used_installation_spots);
-    printout_short(instance, k, m, instance->num_sensors,
-                   "no_reuse_" + std::to_string(num_paths),  // Add the number of added sensors for k-coverage
-                   duration, set_used_installation_spots);
-
-    // Process the Min-Flood Reuse mapping of the instance
-    used_installation_spots.clear();
-    start = std::chrono::high_resolution_clock::now();
-    num_paths = instance->reuse(k, m, 1,emptyset, &used_installation_spots);
-    end = std::chrono::high_resolution_clock::now();
-    duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-    set_used_installation_spots.clear();
-    setify(set_used_installation_spots, &used_installation_spots);
-    printout_short(instance, k, m, instance->num_sensors,
-                   "min_reuse_" + std::to_string(num_paths),  // Add the number of added sensors for k-coverage
-                   duration, set_used_installation_spots);
-
-    // Process the Max-Flood Reuse mapping of the instance
-    used_installation_spots.clear();
-    start = std::chrono::high_resolution_clock::now();
-    num_paths = instance->reuse(k, m, -1,emptyset, &used_installation_spots);
-    end = std::chrono::high_resolution_clock::now();
-    duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-    set_used_installation_spots.clear();
-    setify(set_used_installation_spots, &used_installation_spots);
-    printout_short(instance, k, m, instance->num_sensors,
-                   "max_reuse_" + std::to_string(num_paths),  // Add the number of added sensors for k-coverage
-                   duration, set_used_installation_spots);
-
-    // Process the Best-Reuse mapping of the instance
-    used_installation_spots.clear();
-    start = std::chrono::high_resolution_clock::now();
-    num_paths = instance->reuse(k, m,emptyset, &used_installation_spots);
-    end = std::chrono::high_resolution_clock::now();
-    duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-    set_used_installation_spots.clear();
-    setify(set_used_installation_spots, &used_installation_spots);
-    printout_short(instance, k, m, instance->num_sensors,
-                   "best_reuse_" + std::to_string(num_paths),  // Add the number of added sensors for k-coverage
-                   duration, set_used_installation_spots);
+    // printf("Key\tK\tM\tOperation\tRuntime\tValid\tObjective\tCompression\tSolution\tGap\n");
+
+    for (const auto &pair : pairs) {
+        if (exit_requested()) {break;}
+        k = pair.first;
+        m = pair.second;
+        try {
+            optimize(instance, &graph, shared, tiling, components, reorder, k, m, use_presolve,
+                     sweep ? (mip_start_prefix.empty() ? "" : mip_start_prefix + ".K" + std::to_string(k) + "M" + std::to_string(m))
+                           : mip_start_prefix, footprint);
+        } catch (const std::exception &exc) {
+            if (not sweep) {throw;}
+            std::cerr << instance->key() << "\t" << k << "\t" << m << "\t" << exc.what() << std::endl;
+        }
+    }
+    if (shared != nullptr) {
+        std::cerr << "SWEEP SEARCHED " << shared->num_searched << " PATHS, REUSED " << shared->num_reused << std::endl;
+    }
 
+    delete shared;
+    delete tiling;
+    delete components;
+    delete reorder;
     return 0;
 }
@@ -0,0 +1,159 @@
+/** PATH_POOL.cpp
+ * Pools of short candidate POI-to-sink paths of a KCMC instance, for path-based formulations
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <set>        // set
+#include <queue>      // queue
+#include <algorithm>  // find, equal, reverse
+
+// Dependencies from this package
+#include "path_pool.h"  // KCMC Path Pool headers
+
+
+/* Virtual nodes of the searches: the POI is node num_sensors, and any sink is node num_sensors+1 */
+#define SOURCE(graph) ((graph)->num_sensors)
+#define TARGET(graph) ((graph)->num_sensors + 1)
+
+
+/** PATH POOL CONSTRUCTOR
+ * Enumerates the paths of every POI in parallel. Each thread has its own buffers, and writes only its POIs
+ */
+KCMC_PathPool::KCMC_PathPool(KCMC_Graph *graph, const int pool_size, const int num_disjoint,
+                             std::unordered_set<int> &inactive_sensors) {
+    this->graph = graph;
+    this->pool_size = pool_size;
+    this->num_disjoint = num_disjoint;
+    this->paths.resize((size_t)graph->num_pois);
+    this->inactive.assign((size_t)graph->num_sensors + 2, 0);
+    for (const int &a_sensor : inactive_sensors) {this->inactive[a_sensor] = 1;}
+
+    parallel_chunks(graph->num_pois, [&](const int begin, const int end) {
+        std::vector<char> blocked;
+        std::vector<int> parent;
+        for (int a_poi=begin; a_poi<end; a_poi++) {this->enumerate(a_poi, blocked, parent, &(this->paths[a_poi]));}
+    });
+}
+
+
+long long KCMC_PathPool::num_paths() const {
+    long long total = 0;
+    for (const auto &poi_paths : this->paths) {total += (long long)(poi_paths.size());}
+    return total;
+}
+
+
+/** SHORTEST PATH (BFS)
+ * Shortest path from the spur node to any sink, avoiding blocked nodes and the removed successors of the spur node.
+ * The result has the spur node and the virtual sink node at its ends
+ */
+bool KCMC_PathPool::shortest(const int poi, const int spur, std::vector<char> &blocked, std::vector<int> &removed,
+                             std::vector<int> &parent, std::vector<int> *result) {
+    KCMC_Graph *g = this->graph;
+    const int target = TARGET(g);
+    int node, begin, end;
+    std::queue<int> queue;
+    parent.assign((size_t)g->num_sensors + 2, -1);
+    parent[spur] = spur;
+    queue.push(spur);
+
+    auto visit = [&](const int from, const int to) {
+        if (blocked[to] or (parent[to] != -1)) {return;}
+        if ((from == spur) and (std::find(removed.begin(), removed.end(), to) != removed.end())) {return;}
+        parent[to] = from;
+        queue.push(to);
+    };
+
+    while ((not queue.empty()) and (parent[target] == -1)) {
+        node = queue.front();
+        queue.pop();
+        if (node == SOURCE(g)) {
+            begin = g->poi_sensor.offsets[poi];
+            end = g->poi_sensor.offsets[poi+1];
+        } else {
+            begin = g->sensor_sensor.offsets[node];
+            end = g->sensor_sensor.offsets[node+1];
+            if (g->sensor_sink.offsets[node+1] > g->sensor_sink.offsets[node]) {visit(node, target);}
+        }
+        for (int i=begin; i<end; i++) {
+            visit(node, (node == SOURCE(g)) ? g->poi_sensor.targets[i] : g->sensor_sensor.targets[i]);
+        }
+    }
+    if (parent[target] == -1) {return false;}
+
+    result->clear();
+    for (node=target; node!=spur; node=parent[node]) {result->push_back(node);}
+    result->push_back(spur);
+    std::reverse(result->begin(), result->end());
+    return true;
+}
+
+
+/** YEN'S K-SHORTEST SIMPLE PATHS
+ * The pool starts with up to num_disjoint vertex-disjoint seeds, found greedily (as in the heuristics).
+ * Each new path deviates from a previous one at a spur node: the root (prefix) is kept, its nodes are blocked, and the
+ *   next hops of the paths with the same root are removed. The shortest candidate becomes the next path.
+ */
+void KCMC_PathPool::enumerate(const int poi, std::vector<char> &blocked, std::vector<int> &parent,
+                              std::vector<std::vector<int>> *result) {
+    KCMC_Graph *g = this->graph;
+    std::vector<std::vector<int>> found;  // With the virtual source and target nodes
+    std::set<std::pair<size_t, std::vector<int>>> candidates;
+    std::vector<int> spur_path, removed, candidate;
+
+    result->clear();
+    blocked = this->inactive;
+    if (this->pool_size < 1) {return;}
+    if (not this->shortest(poi, SOURCE(g), blocked, removed, parent, &spur_path)) {return;}
+    found.push_back(spur_path);
+
+    // Seeds: shortest paths, each avoiding the sensors of the previous ones (so the pool has disjoint paths)
+    while (((int)(found.size()) < this->num_disjoint) and ((int)(found.size()) < this->pool_size)) {
+        for (size_t j=1; j+1<found.back().size(); j++) {blocked[found.back()[j]] = 1;}
+        if (not this->shortest(poi, SOURCE(g), blocked, removed, parent, &spur_path)) {break;}
+        found.push_back(spur_path);
+    }
+
+    size_t spurred = 0;
+    while ((int)(found.size()) < this->pool_size) {
+        for (; spurred<found.size(); spurred++) {
+            const std::vector<int> &previous = found[spurred];
+            for (size_t i=0; i+1<previous.size(); i++) {
+                const int spur = previous[i];
+
+                // Remove the next hops of the found paths with the same root, and block the root
+                removed.clear();
+                for (const auto &path : found) {
+                    if ((path.size() > i+1) and std::equal(previous.begin(), previous.begin()+i+1, path.begin())) {
+                        removed.push_back(path[i+1]);
+                    }
+                }
+                blocked = this->inactive;
+                for (size_t j=0; j<i; j++) {blocked[previous[j]] = 1;}
+
+                // Root + spur path is a candidate
+                if (not this->shortest(poi, spur, blocked, removed, parent, &spur_path)) {continue;}
+                candidate.assign(previous.begin(), previous.begin()+i);
+                candidate.insert(candidate.end(), spur_path.begin(), spur_path.end());
+                candidates.emplace(candidate.size(), candidate);
+            }
+        }
+
+        // The shortest candidate not yet found is the next path
+        bool added = false;
+        while ((not candidates.empty()) and (not added)) {
+            candidate = candidates.begin()->second;
+            candidates.erase(candidates.begin());
+            if (std::find(found.begin(), found.end(), candidate) == found.end()) {
+                found.push_back(candidate);
+                added = true;
+            }
+        }
+        if (not added) {break;}
+    }
+
+    // Only the sensors of each path
+    for (const auto &path : found) {result->emplace_back(path.begin()+1, path.end()-1);}
+}
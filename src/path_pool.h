@@ -0,0 +1,47 @@
+/** PATH_POOL.h
+ * Pools of short candidate POI-to-sink paths of a KCMC instance, for path-based formulations
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <vector>  // vector
+
+// Dependencies from this package
+#include "kcmc_graph.h"  // KCMC Graph (CSR) headers
+
+
+#ifndef PATH_POOL_H
+#define PATH_POOL_H
+
+
+/** KCMC Path Pool Object
+ * For each POI, (up to) pool_size short simple paths from the POI to any sink: first num_disjoint vertex-disjoint
+ *   seeds (greedy, each the shortest avoiding the previous ones), then the shortest paths by Yen's algorithm over the
+ *   CSR graph (breadth-first, as every hop costs the same). Ties are broken by the lexicographic order of the sensors.
+ * Each path is the sequence of its sensors, from the one covering the POI to the one adjacent to a sink.
+ * POIs are processed in parallel. Inactive sensors are in no path.
+ * The pool is NOT complete: paths longer than the pool_size-th are left out, thus models built on it may lose
+ *   optimality (or feasibility, if a POI has less than M disjoint paths in its pool).
+ */
+class KCMC_PathPool {
+
+    public:
+        int pool_size, num_disjoint;
+        std::vector<std::vector<std::vector<int>>> paths;  // Paths of each POI
+
+        KCMC_PathPool(KCMC_Graph *graph, int pool_size, int num_disjoint, std::unordered_set<int> &inactive_sensors);
+
+        long long num_paths() const;
+
+    private:
+        KCMC_Graph *graph;
+        std::vector<char> inactive;
+
+        void enumerate(int poi, std::vector<char> &blocked, std::vector<int> &parent,
+                       std::vector<std::vector<int>> *result);
+        bool shortest(int poi, int spur, std::vector<char> &blocked, std::vector<int> &removed,
+                      std::vector<int> &parent, std::vector<int> *result);
+};
+
+#endif
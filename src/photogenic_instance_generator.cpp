@@ -33,11 +33,16 @@ void help(int argc, char* const argv[]) {
     std::cout << "com_r > 0.0 is the int radius around a Sensor where it can communicate with other Sensors or Sinks" << std::endl << std::endl;
     std::cout << "kcmc_k > 0 is the K parameter of the KCMC problem" << std::endl;
     std::cout << "kcmc_m > 0 is the M parameter of the KCMC problem" << std::endl << std::endl;
+    std::cout << "--stats (optional, before anything else) prints the hot-path counters to STDERR at exit."
+              << " Counters are only compiled in builds configured with -DKCMC_STATS=ON" << std::endl;
+    std::cout << "--trace <file> (optional, before anything else) writes a timeline of the phases (parse, level graph,"
+              << " path searches, floods, GA steps...) to the file at exit, as Chrome trace-event JSON" << std::endl;
     exit(0);
 }
 
 
 int main(int argc, char* const argv[]) {
+    {int skip = diagnostic_flags(argc, argv); argv += skip; argc -= skip;}  // --stats and --trace, at exit
     if (argc < 7) {help(argc, argv);}
 
     /* ======================== *
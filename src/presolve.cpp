@@ -0,0 +1,259 @@
+/** PRESOLVE.cpp
+ * Presolve (reduction) of KCMC instances: removal of useless sensors and fixing of forced ones
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <queue>      // queue
+#include <algorithm>  // fill
+
+// Dependencies from this package
+#include "presolve.h"  // KCMC Presolve headers
+
+
+/** PRESOLVE CONSTRUCTOR
+ * Runs the reductions until no more sensors are removed, then finds the forced sensors and builds the reduced instance
+ */
+KCMC_Presolve::KCMC_Presolve(KCMC_Instance *instance, const int k, const int m, const bool dominance) {
+    this->original = instance;
+    this->k = k;
+    this->m = m;
+    this->num_unreachable = 0;
+    this->num_dead_ends = 0;
+    this->num_dominated = 0;
+
+    // Removals may enable other removals, so repeat until nothing changes
+    int removed;
+    do {
+        removed  = this->remove_unreachable();
+        removed += this->remove_dead_ends();
+    } while (removed > 0);
+    if (dominance) {this->remove_dominated();}
+    this->find_forced();
+
+    // Build the reduced instance with the kept sensors, in increasing order
+    for (int a_sensor=0; a_sensor<instance->num_sensors; a_sensor++) {
+        if (not isin(this->removed_sensors, a_sensor)) {
+            this->reduced_index[a_sensor] = (int)(this->sensor_map.size());
+            this->sensor_map.push_back(a_sensor);
+        }
+    }
+    this->reduced = instance->subinstance(this->sensor_map);
+}
+
+KCMC_Presolve::~KCMC_Presolve() {delete this->reduced;}
+
+
+/* #####################################################################################################################
+ * REDUCTIONS
+ */
+
+
+/** Degree of a sensor among the sensors not removed */
+int KCMC_Presolve::degree(const int a_sensor) {
+    int result = 0;
+    for (const int &neighbor : this->original->sensor_sensor.at(a_sensor)) {
+        if (not isin(this->removed_sensors, neighbor)) {result++;}
+    }
+    return result;
+}
+
+
+/** UNREACHABLE SENSORS
+ * Finds the connected components of the kept sensors. Components with no POI-covering or no sink-adjacent sensor
+ * cannot hold a POI-to-sink path, so their sensors that cover no POI are useless
+ */
+int KCMC_Presolve::remove_unreachable() {
+    int a_sensor, current, removed = 0;
+    bool has_cover, has_sink;
+    std::vector<int> component;
+    std::vector<bool> visited((size_t)this->original->num_sensors, false);
+    std::queue<int> queue;
+
+    for (a_sensor=0; a_sensor<this->original->num_sensors; a_sensor++) {
+        if (visited[a_sensor] or isin(this->removed_sensors, a_sensor)) {continue;}
+
+        // Breadth-first search of the component of the sensor
+        component.clear();
+        has_cover = false;
+        has_sink = false;
+        visited[a_sensor] = true;
+        queue.push(a_sensor);
+        while (not queue.empty()) {
+            current = queue.front();
+            queue.pop();
+            component.push_back(current);
+            has_cover = has_cover or (not this->original->sensor_poi.at(current).empty());
+            has_sink = has_sink or isin(this->original->sensor_sink, current);
+            for (const int &neighbor : this->original->sensor_sensor.at(current)) {
+                if ((not visited[neighbor]) and (not isin(this->removed_sensors, neighbor))) {
+                    visited[neighbor] = true;
+                    queue.push(neighbor);
+                }
+            }
+        }
+
+        // Remove the useless sensors of the component
+        if (has_cover and has_sink) {continue;}
+        for (const int &member : component) {
+            if (this->original->sensor_poi.at(member).empty()) {
+                this->removed_sensors.insert(member);
+                removed++;
+            }
+        }
+    }
+    this->num_unreachable += removed;
+    return removed;
+}
+
+
+/** DEAD-END SENSORS
+ * A sensor that covers no POI is only useful inside a path. A path enters and leaves it, unless it is the last sensor
+ * before the sink. So sensors that cover no POI with no neighbors, or with a single neighbor and no sink, are useless
+ */
+int KCMC_Presolve::remove_dead_ends() {
+    int current, removed = 0;
+    std::queue<int> queue;
+    for (int a_sensor=0; a_sensor<this->original->num_sensors; a_sensor++) {queue.push(a_sensor);}
+
+    while (not queue.empty()) {
+        current = queue.front();
+        queue.pop();
+        if (isin(this->removed_sensors, current) or (not this->original->sensor_poi.at(current).empty())) {continue;}
+
+        int current_degree = this->degree(current);
+        if ((current_degree == 0) or ((current_degree == 1) and (not isin(this->original->sensor_sink, current)))) {
+            this->removed_sensors.insert(current);
+            removed++;
+            // The neighbor might have become a dead-end
+            for (const int &neighbor : this->original->sensor_sensor.at(current)) {
+                if (not isin(this->removed_sensors, neighbor)) {queue.push(neighbor);}
+            }
+        }
+    }
+    this->num_dead_ends += removed;
+    return removed;
+}
+
+
+/** DOMINANCE
+ * The sensor is dominated by the other if the other covers all its POIs, neighbors all its neighbors (but the
+ * other itself) and connects to all its sinks
+ */
+bool KCMC_Presolve::dominates(const int other, const int a_sensor) {
+    KCMC_Instance *instance = this->original;
+    for (const int &a_poi : instance->sensor_poi.at(a_sensor)) {
+        if (not isin(instance->sensor_poi.at(other), a_poi)) {return false;}
+    }
+    for (const int &neighbor : instance->sensor_sensor.at(a_sensor)) {
+        if ((neighbor != other) and (not isin(this->removed_sensors, neighbor))
+            and (not isin(instance->sensor_sensor.at(other), neighbor))) {return false;}
+    }
+    if (isin(instance->sensor_sink, a_sensor)) {
+        if (not isin(instance->sensor_sink, other)) {return false;}
+        for (const int &a_sink : instance->sensor_sink[a_sensor]) {
+            if (not isin(instance->sensor_sink[other], a_sink)) {return false;}
+        }
+    }
+    return true;
+}
+
+
+/** DOMINATED SENSORS (HEURISTIC)
+ * Removes each sensor dominated by a kept sensor. Of twin sensors, the first is kept.
+ * Candidates to dominate a sensor cover its first POI or neighbor its first neighbor.
+ * If the instance was valid but the removals make it invalid, all of them are undone.
+ */
+int KCMC_Presolve::remove_dominated() {
+    KCMC_Instance *instance = this->original;
+    bool was_valid = instance->validate(false, this->k, this->m, this->removed_sensors);
+    if (not was_valid) {return 0;}
+
+    std::unordered_set<int> dominated, candidates;
+    for (int a_sensor=0; a_sensor<instance->num_sensors; a_sensor++) {
+        if (isin(this->removed_sensors, a_sensor)) {continue;}
+
+        // Collect the candidates
+        candidates.clear();
+        if (not instance->sensor_poi.at(a_sensor).empty()) {
+            candidates = instance->poi_sensor.at(*(instance->sensor_poi.at(a_sensor).begin()));
+        } else {
+            for (const int &neighbor : instance->sensor_sensor.at(a_sensor)) {
+                if (isin(this->removed_sensors, neighbor)) {continue;}
+                candidates = instance->sensor_sensor.at(neighbor);
+                candidates.insert(neighbor);
+                break;
+            }
+        }
+
+        // Remove the sensor if any kept candidate dominates it
+        for (const int &other : candidates) {
+            if ((other == a_sensor) or isin(this->removed_sensors, other)) {continue;}
+            if (this->dominates(other, a_sensor)) {
+                this->removed_sensors.insert(a_sensor);
+                dominated.insert(a_sensor);
+                break;
+            }
+        }
+    }
+
+    // Undo, if the removals broke the instance
+    if (not instance->validate(false, this->k, this->m, this->removed_sensors)) {
+        for (const int &a_sensor : dominated) {this->removed_sensors.erase(a_sensor);}
+        dominated.clear();
+    }
+    this->num_dominated = (int)(dominated.size());
+    return this->num_dominated;
+}
+
+
+/** FORCED SENSORS
+ * Each path of a POI starts at a different covering sensor and ends at a different sink-adjacent sensor. So a POI
+ * with exactly max(K, M) covering sensors needs all of them, and if there are exactly M sink-adjacent sensors, every
+ * path-ending sensor is needed
+ */
+void KCMC_Presolve::find_forced() {
+    KCMC_Instance *instance = this->original;
+    int required = (this->k > this->m) ? this->k : this->m, a_poi;
+    std::vector<int> kept;
+
+    for (a_poi=0; a_poi<instance->num_pois; a_poi++) {
+        kept.clear();
+        for (const int &a_sensor : instance->poi_sensor.at(a_poi)) {
+            if (not isin(this->removed_sensors, a_sensor)) {kept.push_back(a_sensor);}
+        }
+        if ((int)(kept.size()) == required) {this->forced_sensors.insert(kept.begin(), kept.end());}
+    }
+
+    kept.clear();
+    for (const auto &a_sensor : instance->sensor_sink) {
+        if (not isin(this->removed_sensors, a_sensor.first)) {kept.push_back(a_sensor.first);}
+    }
+    if ((this->m > 0) and ((int)(kept.size()) == this->m)) {this->forced_sensors.insert(kept.begin(), kept.end());}
+}
+
+
+/* #####################################################################################################################
+ * MAPPINGS
+ */
+
+
+void KCMC_Presolve::expand(std::unordered_set<int> &reduced_sensors, std::unordered_set<int> *original_sensors) {
+    original_sensors->clear();
+    for (const int &a_sensor : reduced_sensors) {original_sensors->insert(this->sensor_map[a_sensor]);}
+}
+
+
+void KCMC_Presolve::expand(const int *reduced_individual, int *original_individual) {
+    std::fill(original_individual, original_individual+this->original->num_sensors, 0);
+    for (size_t i=0; i<this->sensor_map.size(); i++) {original_individual[this->sensor_map[i]] = reduced_individual[i];}
+}
+
+
+void KCMC_Presolve::reduce(std::unordered_set<int> &original_sensors, std::unordered_set<int> *reduced_sensors) {
+    reduced_sensors->clear();
+    for (const int &a_sensor : original_sensors) {
+        if (isin(this->reduced_index, a_sensor)) {reduced_sensors->insert(this->reduced_index[a_sensor]);}
+    }
+}
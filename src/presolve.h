@@ -0,0 +1,64 @@
+/** PRESOLVE.h
+ * Presolve (reduction) of KCMC instances: removal of useless sensors and fixing of forced ones
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <vector>  // vector
+
+// Dependencies from this package
+#include "kcmc_instance.h"  // KCMC Instance class headers
+
+
+#ifndef PRESOLVE_H
+#define PRESOLVE_H
+
+
+/** KCMC Presolve Object
+ * Reduces a KCMC instance for a given K and M, removing sensors that cannot be in any minimal solution:
+ * - UNREACHABLE sensors, that cover no POI and are in a connected component without POI-covering or sink-adjacent
+ *     sensors (thus lie on no POI-to-sink path)
+ * - DEAD-END sensors, that cover no POI, are not sink-adjacent and have at most one neighbor. Removing one may turn
+ *     its neighbor into a dead-end, so whole dead-end chains are removed
+ * - DOMINATED sensors (only if asked for), whose covered POIs, neighbors and sinks are a subset of another sensor's.
+ *     This reduction is HEURISTIC: K-coverage or M-connectivity may need both sensors. It is undone if the reduced
+ *     instance becomes invalid, but the optimum of the reduced instance may still be worse.
+ * Sensors that every solution must have are FORCED: all covering sensors of a POI with exactly max(K, M) of them,
+ *   and all sink-adjacent sensors if there are exactly M of them.
+ * The reduced instance has every POI and sink, and only the kept sensors. Solutions of the reduced instance are
+ *   mapped back with expand (and original sets of sensors mapped forward with reduce).
+ */
+class KCMC_Presolve {
+
+    public:
+        int k, m, num_unreachable, num_dead_ends, num_dominated;
+        KCMC_Instance *reduced;
+
+        /* Mappings
+         * Sensor i of the reduced instance is sensor sensor_map[i] of the original instance
+         * Removed and forced sensors, by their ORIGINAL indexes
+         */
+        std::vector<int> sensor_map;
+        std::unordered_set<int> removed_sensors, forced_sensors;
+
+        KCMC_Presolve(KCMC_Instance *instance, int k, int m, bool dominance);
+        ~KCMC_Presolve();
+
+        void expand(std::unordered_set<int> &reduced_sensors, std::unordered_set<int> *original_sensors);
+        void reduce(std::unordered_set<int> &original_sensors, std::unordered_set<int> *reduced_sensors);
+        void expand(const int *reduced_individual, int *original_individual);  // 0/1 arrays, removed sensors are 0
+
+    private:
+        KCMC_Instance *original;
+        std::unordered_map<int, int> reduced_index;
+
+        int remove_unreachable();
+        int remove_dead_ends();
+        int remove_dominated();
+        void find_forced();
+        bool dominates(int other, int a_sensor);
+        int degree(int a_sensor);
+};
+
+#endif
@@ -0,0 +1,180 @@
+/** REORDER.cpp
+ * Hilbert and reverse Cuthill-McKee orderings of a KCMC instance, and the mappings of its solutions
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <algorithm>  // sort, stable_sort, reverse, swap
+#include <cstdlib>    // abs
+#include <numeric>    // iota
+#include <utility>    // pair
+#include <stdexcept>  // runtime_error
+
+// Dependencies from this package
+#include "reorder.h"     // KCMC Reorder headers
+#include "kcmc_graph.h"  // Sorted adjacencies
+
+
+KCMC_Ordering parse_ordering(const std::string &name) {
+    if (name == "hilbert") {return ORDERING_HILBERT;}
+    if (name == "rcm") {return ORDERING_RCM;}
+    throw std::runtime_error("UNKNOWN ORDERING " + name + "!");
+}
+
+
+/** HILBERT INDEX
+ * Position of the point along the Hilbert curve of a square of the given side (a power of 2)
+ */
+static long long hilbert_index(const int side, int x, int y) {
+    long long index = 0;
+    for (int s=side/2; s>0; s/=2) {
+        const int rx = ((x & s) > 0) ? 1 : 0, ry = ((y & s) > 0) ? 1 : 0;
+        index += (long long)s * s * ((3 * rx) ^ ry);
+        if (ry == 0) {  // Rotate the quadrant
+            if (rx == 1) {x = side - 1 - x; y = side - 1 - y;}
+            std::swap(x, y);
+        }
+    }
+    return index;
+}
+
+
+/** REORDER CONSTRUCTOR
+ * Computes the maps of the ordering, and derives the instance relabeled by them
+ */
+KCMC_Reorder::KCMC_Reorder(KCMC_Instance *instance, const KCMC_Ordering ordering) {
+    this->ordering = ordering;
+    if (ordering == ORDERING_HILBERT) {this->hilbert(instance);}
+    else {this->rcm(instance);}
+
+    this->sensor_index.assign((size_t)instance->num_sensors, 0);
+    for (int i=0; i<instance->num_sensors; i++) {this->sensor_index[this->sensor_map[i]] = i;}
+
+    // Edges of each relabeled node, in increasing order of the new indexes
+    KCMC_Graph graph(instance);
+    std::vector<int> targets;
+    auto relabeled = [&](const CSRAdjacency &adjacency, const int source, const std::vector<int> &labels) {
+        targets.clear();
+        for (int j=adjacency.offsets[source]; j<adjacency.offsets[source+1]; j++) {
+            targets.push_back(labels[adjacency.targets[j]]);
+        }
+        std::sort(targets.begin(), targets.end());
+    };
+    std::vector<int> sink_labels((size_t)instance->num_sinks);
+    std::iota(sink_labels.begin(), sink_labels.end(), 0);
+
+    std::vector<std::pair<int, int>> poi_sensor, sensor_sensor, sensor_sink;
+    for (int p=0; p<instance->num_pois; p++) {
+        relabeled(graph.poi_sensor, this->poi_map[p], this->sensor_index);
+        for (const int &target : targets) {poi_sensor.emplace_back(p, target);}
+    }
+    for (int i=0; i<instance->num_sensors; i++) {
+        relabeled(graph.sensor_sensor, this->sensor_map[i], this->sensor_index);
+        for (const int &target : targets) {if (target > i) {sensor_sensor.emplace_back(i, target);}}
+    }
+    for (int i=0; i<instance->num_sensors; i++) {
+        relabeled(graph.sensor_sink, this->sensor_map[i], sink_labels);
+        for (const int &target : targets) {sensor_sink.emplace_back(i, target);}
+    }
+    this->reordered = instance->derive(instance->num_pois, instance->num_sensors, instance->num_sinks,
+                                       poi_sensor, sensor_sensor, sensor_sink);
+}
+
+KCMC_Reorder::~KCMC_Reorder() {delete this->reordered;}
+
+
+/** HILBERT
+ * Ties (same point of the curve) keep the original order
+ */
+void KCMC_Reorder::hilbert(KCMC_Instance *instance) {
+    std::vector<Placement> pl_pois((size_t)instance->num_pois), pl_sensors((size_t)instance->num_sensors),
+                           pl_sinks((size_t)instance->num_sinks);
+    instance->get_placements(pl_pois.data(), pl_sensors.data(), pl_sinks.data());
+    int side = 1;
+    while (side <= instance->area_side) {side *= 2;}
+
+    auto curve_order = [&](const std::vector<Placement> &placements, std::vector<int> *order) {
+        std::vector<long long> position(placements.size());
+        for (size_t i=0; i<placements.size(); i++) {
+            position[i] = hilbert_index(side, placements[i].x, placements[i].y);
+        }
+        order->resize(placements.size());
+        std::iota(order->begin(), order->end(), 0);
+        std::stable_sort(order->begin(), order->end(), [&](const int a, const int b) {return position[a] < position[b];});
+    };
+    curve_order(pl_sensors, &(this->sensor_map));
+    curve_order(pl_pois, &(this->poi_map));
+}
+
+
+/** REVERSE CUTHILL-MCKEE
+ * Components are started in increasing order of the degree of their sensors. POIs without covering sensors go last
+ */
+void KCMC_Reorder::rcm(KCMC_Instance *instance) {
+    KCMC_Graph graph(instance);
+    const CSRAdjacency &adjacency = graph.sensor_sensor;
+    auto degree = [&](const int a_sensor) {return adjacency.offsets[a_sensor+1] - adjacency.offsets[a_sensor];};
+    auto by_degree = [&](const int a, const int b) {return degree(a) < degree(b);};
+
+    std::vector<int> starts((size_t)instance->num_sensors), neighbors;
+    std::iota(starts.begin(), starts.end(), 0);
+    std::stable_sort(starts.begin(), starts.end(), by_degree);
+
+    std::vector<char> visited((size_t)instance->num_sensors, 0);
+    this->sensor_map.clear();
+    for (const int &start : starts) {
+        if (visited[start]) {continue;}
+        visited[start] = 1;
+        size_t head = this->sensor_map.size();
+        this->sensor_map.push_back(start);
+        for (; head<this->sensor_map.size(); head++) {
+            const int a_sensor = this->sensor_map[head];
+            neighbors.clear();
+            for (int j=adjacency.offsets[a_sensor]; j<adjacency.offsets[a_sensor+1]; j++) {
+                if (not visited[adjacency.targets[j]]) {visited[adjacency.targets[j]] = 1; neighbors.push_back(adjacency.targets[j]);}
+            }
+            std::stable_sort(neighbors.begin(), neighbors.end(), by_degree);
+            this->sensor_map.insert(this->sensor_map.end(), neighbors.begin(), neighbors.end());
+        }
+    }
+    std::reverse(this->sensor_map.begin(), this->sensor_map.end());
+
+    // POIs by their first covering sensor in the new order
+    std::vector<int> new_index((size_t)instance->num_sensors), first((size_t)instance->num_pois, instance->num_sensors);
+    for (int i=0; i<instance->num_sensors; i++) {new_index[this->sensor_map[i]] = i;}
+    for (int poi=0; poi<instance->num_pois; poi++) {
+        for (int j=graph.poi_sensor.offsets[poi]; j<graph.poi_sensor.offsets[poi+1]; j++) {
+            first[poi] = std::min(first[poi], new_index[graph.poi_sensor.targets[j]]);
+        }
+    }
+    this->poi_map.resize((size_t)instance->num_pois);
+    std::iota(this->poi_map.begin(), this->poi_map.end(), 0);
+    std::stable_sort(this->poi_map.begin(), this->poi_map.end(), [&](const int a, const int b) {return first[a] < first[b];});
+}
+
+
+/* #####################################################################################################################
+ * MAPPINGS AND LOCALITY
+ */
+
+
+void KCMC_Reorder::expand(std::unordered_set<int> &reordered_sensors, std::unordered_set<int> *original_sensors) {
+    original_sensors->clear();
+    for (const int &a_sensor : reordered_sensors) {original_sensors->insert(this->sensor_map[a_sensor]);}
+}
+
+
+void KCMC_Reorder::reduce(std::unordered_set<int> &original_sensors, std::unordered_set<int> *reordered_sensors) {
+    reordered_sensors->clear();
+    for (const int &a_sensor : original_sensors) {reordered_sensors->insert(this->sensor_index[a_sensor]);}
+}
+
+
+double KCMC_Reorder::mean_edge_span(KCMC_Instance *instance) {
+    long long span = 0, num_edges = 0;
+    for (const auto &a_sensor : instance->sensor_sensor) {
+        for (const int &neighbor : a_sensor.second) {span += std::abs(a_sensor.first - neighbor); num_edges++;}
+    }
+    return (num_edges > 0) ? (double)span / (double)num_edges : 0.0;
+}
@@ -0,0 +1,67 @@
+/** REORDER.h
+ * Locality-improving relabeling of the sensors and POIs of a KCMC instance (Hilbert curve or reverse Cuthill-McKee)
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <string>         // string
+#include <vector>         // vector
+#include <unordered_set>  // unordered_set
+
+// Dependencies from this package
+#include "kcmc_instance.h"  // KCMC Instance class headers
+
+
+#ifndef REORDER_H
+#define REORDER_H
+
+
+/* ORDERINGS
+ * HILBERT: Sensors and POIs by the position of their placements along a Hilbert curve of the area. Needs the
+ *          placements, so the instance must be regenerated from its key
+ * RCM:     Sensors by reverse Cuthill-McKee over the sensor-sensor edges (breadth-first from a sensor of smallest degree
+ *          of each component, neighbors by increasing degree, then reversed). POIs by their first covering sensor
+ */
+enum KCMC_Ordering {ORDERING_HILBERT, ORDERING_RCM};
+
+KCMC_Ordering parse_ordering(const std::string &name);
+
+
+/** KCMC Reorder Object
+ * Sensor indexes come from the order of the random draws, so neighbors are scattered in memory and every level graph
+ *   and path search touches random cache lines. The reordered instance has the same POIs, sensors and sinks (sinks
+ *   keep their indexes), relabeled so that neighbors have close indexes: its adjacencies are parsed, stored and
+ *   scanned in that order. Solutions of the reordered instance are mapped back with expand (and sets of the
+ *   original instance mapped forward with reduce), as with KCMC_Presolve.
+ */
+class KCMC_Reorder {
+
+    public:
+        KCMC_Ordering ordering;
+        KCMC_Instance *reordered;
+
+        /* Mappings
+         * Sensor (POI) i of the reordered instance is sensor (POI) sensor_map[i] (poi_map[i]) of the original instance
+         */
+        std::vector<int> sensor_map, poi_map;
+
+        KCMC_Reorder(KCMC_Instance *instance, KCMC_Ordering ordering);
+        ~KCMC_Reorder();
+
+        void expand(std::unordered_set<int> &reordered_sensors, std::unordered_set<int> *original_sensors);
+        void reduce(std::unordered_set<int> &original_sensors, std::unordered_set<int> *reordered_sensors);
+
+        /* Locality
+         * Mean distance between the indexes of neighbor sensors (each sensor-sensor edge), in an instance
+         */
+        static double mean_edge_span(KCMC_Instance *instance);
+
+    private:
+        std::vector<int> sensor_index;  // Inverse of the sensor map
+
+        void hilbert(KCMC_Instance *instance);
+        void rcm(KCMC_Instance *instance);
+};
+
+#endif
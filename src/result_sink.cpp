@@ -0,0 +1,260 @@
+/** RESULT_SINK.cpp
+ * Lock-free queue of records, and their writer thread
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <algorithm>  // min
+#include <chrono>     // microseconds
+#include <cmath>      // isfinite
+#include <cstring>    // memcpy
+#include <iomanip>    // setfill, setw, setprecision
+#include <iostream>   // cout
+#include <stdexcept>  // runtime_error
+
+// Dependencies from this package
+#include "result_sink.h"  // Result Sink headers
+
+
+/* #####################################################################################################################
+ * RECORDS
+ * */
+
+
+KCMC_Record &KCMC_Record::text(const char *name, const std::string &value, const char *prefix) {
+    this->fields.push_back({KCMC_Field::TEXT, name, prefix, value, 0, 0.0, {}, 0, 0, ' '});
+    return *this;
+}
+
+KCMC_Record &KCMC_Record::integer(const char *name, const long long value, const int width, const char fill,
+                                  const char *prefix) {
+    this->fields.push_back({KCMC_Field::INTEGER, name, prefix, "", value, 0.0, {}, width, 0, fill});
+    return *this;
+}
+
+KCMC_Record &KCMC_Record::real(const char *name, const double value, const int precision, const int width) {
+    this->fields.push_back({KCMC_Field::REAL, name, nullptr, "", 0, value, {}, width, precision, ' '});
+    return *this;
+}
+
+KCMC_Record &KCMC_Record::bits(const char *name, const int *values, const int size) {
+    return this->bits(name, std::vector<char>(values, values + size));
+}
+
+KCMC_Record &KCMC_Record::bits(const char *name, std::vector<char> values) {
+    this->fields.push_back({KCMC_Field::BITS, name, nullptr, "", 0, 0.0, std::move(values), 0, 0, ' '});
+    return *this;
+}
+
+
+/* #####################################################################################################################
+ * QUEUE
+ * Intrusive multi-producer, single-consumer queue (Vyukov). A push is a single exchange, so producers never wait.
+ * The writer always keeps the last written node, as the tail, until the next one is written
+ * */
+
+
+struct KCMC_Sink_Node {
+    std::atomic<KCMC_Sink_Node*> next;
+    bool is_header;
+    std::string header;
+    KCMC_Record record;
+};
+
+
+KCMC_Result_Sink::KCMC_Result_Sink(std::ostream *out, const KCMC_Sink_Format format, const KCMC_Encoding encoding) {
+    this->out = out;
+    this->sink_format = format;
+    this->encoding = encoding;
+    this->tail = new KCMC_Sink_Node();
+    this->tail->next.store(nullptr, std::memory_order_relaxed);
+    this->head.store(this->tail, std::memory_order_relaxed);
+    this->stopping.store(false, std::memory_order_relaxed);
+    if (format == SINK_BINARY) {*this->out << "KCMCREC1";}
+    this->writer_thread = std::thread(&KCMC_Result_Sink::writer, this);
+}
+
+KCMC_Result_Sink::~KCMC_Result_Sink() {
+    this->stopping.store(true, std::memory_order_release);
+    this->writer_thread.join();
+    delete this->tail;
+}
+
+
+void KCMC_Result_Sink::push(KCMC_Sink_Node *node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    KCMC_Sink_Node *previous = this->head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+}
+
+void KCMC_Result_Sink::write(KCMC_Record record) {
+    auto *node = new KCMC_Sink_Node();
+    node->is_header = false;
+    node->record = std::move(record);
+    this->push(node);
+}
+
+void KCMC_Result_Sink::header(const std::string &line) {
+    if (this->sink_format != SINK_TSV) {return;}
+    auto *node = new KCMC_Sink_Node();
+    node->is_header = true;
+    node->header = line;
+    this->push(node);
+}
+
+
+/* WRITER
+ * Writes until stopped and drained. While the queue is empty, it flushes the stream and backs off (up to 1 ms)
+ */
+void KCMC_Result_Sink::writer() {
+    int idle = 0;
+    while (true) {
+        KCMC_Sink_Node *next = this->tail->next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            if (next->is_header) {*this->out << next->header << "\n";}
+            else {this->format(next->record);}
+            delete this->tail;
+            this->tail = next;
+            idle = 0;
+            continue;
+        }
+        if (idle == 0) {this->out->flush();}
+        if (this->stopping.load(std::memory_order_acquire)
+            and (this->head.load(std::memory_order_acquire) == this->tail)) {break;}
+        std::this_thread::sleep_for(std::chrono::microseconds(std::min(1000, 10 << std::min(idle, 7))));
+        idle++;
+    }
+    this->out->flush();
+}
+
+
+/* #####################################################################################################################
+ * FORMATS
+ * */
+
+
+static void json_string(std::ostream &out, const std::string &text) {
+    out << '"';
+    for (const char &c : text) {
+        if ((c == '"') or (c == '\\')) {out << '\\' << c;}
+        else if (c == '\n') {out << "\\n";}
+        else if (c == '\t') {out << "\\t";}
+        else if ((unsigned char)c < 0x20) {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c << std::dec << std::setfill(' ');
+        }
+        else {out << c;}
+    }
+    out << '"';
+}
+
+static void put_bytes(std::string &buffer, const unsigned long long value, const int num_bytes) {
+    for (int i=0; i<num_bytes; i++) {buffer.push_back((char)((value >> (8*i)) & 0xFF));}
+}
+
+
+void KCMC_Result_Sink::format(const KCMC_Record &record) {
+    std::ostream &out = *this->out;
+
+    if (this->sink_format == SINK_TSV) {
+        bool first = true;
+        for (const KCMC_Field &field : record.fields) {
+            out << ((field.prefix != nullptr) ? field.prefix : (first ? "" : "\t"));
+            first = false;
+            switch (field.type) {
+                case KCMC_Field::TEXT: out << field.text; break;
+                case KCMC_Field::INTEGER:
+                    out << std::setfill(field.fill) << std::setw(field.width) << field.integer << std::setfill(' ');
+                    break;
+                case KCMC_Field::REAL:
+                    out << std::setw(field.width) << std::fixed << std::setprecision(field.precision) << field.real;
+                    break;
+                case KCMC_Field::BITS: out << encode_solution(field.bits, this->encoding); break;
+            }
+        }
+        out << "\n";
+
+    } else if (this->sink_format == SINK_JSONL) {
+        out << "{";
+        bool first = true;
+        for (const KCMC_Field &field : record.fields) {
+            out << (first ? "" : ", ") << "\"" << field.name << "\": ";
+            first = false;
+            switch (field.type) {
+                case KCMC_Field::TEXT: json_string(out, field.text); break;
+                case KCMC_Field::INTEGER: out << field.integer; break;
+                case KCMC_Field::REAL:
+                    if (std::isfinite(field.real)) {out << std::fixed << std::setprecision(field.precision) << field.real;}
+                    else {out << "null";}
+                    break;
+                case KCMC_Field::BITS: out << '"' << encode_solution(field.bits, this->encoding) << '"'; break;
+            }
+        }
+        out << "}\n";
+
+    } else {
+        std::string buffer;
+        put_bytes(buffer, record.fields.size(), 2);
+        for (const KCMC_Field &field : record.fields) {
+            std::string name(field.name);
+            put_bytes(buffer, (unsigned long long)field.type, 1);
+            put_bytes(buffer, name.size(), 1);
+            buffer += name;
+            switch (field.type) {
+                case KCMC_Field::TEXT: put_bytes(buffer, field.text.size(), 4); buffer += field.text; break;
+                case KCMC_Field::INTEGER: put_bytes(buffer, (unsigned long long)field.integer, 8); break;
+                case KCMC_Field::REAL: {
+                    unsigned long long raw;
+                    static_assert(sizeof(raw) == sizeof(field.real), "DOUBLES MUST HAVE 64 BITS!");
+                    std::memcpy(&raw, &field.real, sizeof(raw));
+                    put_bytes(buffer, raw, 8);
+                    break;
+                }
+                case KCMC_Field::BITS: {
+                    put_bytes(buffer, field.bits.size(), 4);
+                    std::string packed((field.bits.size() + 7) / 8, '\0');
+                    for (size_t i=0; i<field.bits.size(); i++) {
+                        if (field.bits[i]) {packed[i/8] = (char)(packed[i/8] | (1 << (i%8)));}
+                    }
+                    buffer += packed;
+                    break;
+                }
+            }
+        }
+        std::string length;
+        put_bytes(length, buffer.size(), 4);
+        out << length << buffer;
+    }
+}
+
+
+/* #####################################################################################################################
+ * RESULTS OF THE PROCESS
+ * */
+
+
+static KCMC_Sink_Format results_format = SINK_TSV;
+static KCMC_Encoding results_encoding = ENCODING_BITS;
+static bool results_started = false;
+
+KCMC_Result_Sink &results() {
+    static KCMC_Result_Sink the_results(&std::cout, results_format, results_encoding);
+    results_started = true;
+    return the_results;
+}
+
+int result_flags(const int argc, char* const argv[]) {
+    int arg = 1;
+    while (arg+1 < argc) {
+        std::string flag(argv[arg]), name(argv[arg+1]);
+        if ((flag != "--format") and (flag != "--encoding")) {break;}
+        if (results_started) {throw std::runtime_error("THE RESULTS MUST BE CONFIGURED BEFORE THE FIRST ONE!");}
+        if (flag == "--encoding") {results_encoding = parse_encoding(name);}
+        else if (name == "tsv") {results_format = SINK_TSV;}
+        else if (name == "jsonl") {results_format = SINK_JSONL;}
+        else if (name == "binary") {results_format = SINK_BINARY;}
+        else {throw std::runtime_error("UNKNOWN RESULT FORMAT " + name + "!");}
+        arg += 2;
+    }
+    return arg - 1;
+}
@@ -0,0 +1,104 @@
+/** RESULT_SINK.h
+ * Asynchronous output of the results of the binaries. Records are formatted and written by a background thread, so
+ *   the computation never waits for the output
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <atomic>   // atomic
+#include <ostream>  // ostream
+#include <string>   // string
+#include <thread>   // thread
+#include <vector>   // vector
+
+// Dependencies from this package
+#include "solution_encoding.h"  // Encodings of the solutions
+
+
+#ifndef RESULT_SINK_H
+#define RESULT_SINK_H
+
+
+/* FORMATS
+ * TSV:    One line per record, with the layout the binaries always had (the default)
+ * JSONL:  One JSON object per record, keyed by the names of the fields. Solutions are strings
+ * BINARY: The magic "KCMCREC1", then each record as its byte length (u32), number of fields (u16) and fields. A field
+ *         is its type (u8: 0 text, 1 integer, 2 real, 3 bits), name length (u8), name and value: text as length (u32)
+ *         and bytes, integers as i64, reals as f64, bits as count (u32) and packed bytes (first bit in the lowest).
+ *         Every number is little-endian
+ * In TSV and JSONL, solutions are written in the encoding of the sink (solution_encoding.h). Binary records always
+ *   pack their bits
+ */
+enum KCMC_Sink_Format {SINK_TSV, SINK_JSONL, SINK_BINARY};
+
+
+/* RECORD
+ * A result, as typed fields. Solutions are kept as bits and only formatted by the writer.
+ * Each field may have the text written before it in TSV (by default, a TAB between fields), and integers and reals
+ *   their TSV width and fill. Names must be string literals
+ */
+struct KCMC_Field {
+    enum {TEXT, INTEGER, REAL, BITS} type;
+    const char *name, *prefix;
+    std::string text;
+    long long integer;
+    double real;
+    std::vector<char> bits;
+    int width, precision;
+    char fill;
+};
+
+class KCMC_Record {
+    public:
+        KCMC_Record &text(const char *name, const std::string &value, const char *prefix = nullptr);
+        KCMC_Record &integer(const char *name, long long value, int width = 0, char fill = ' ',
+                             const char *prefix = nullptr);
+        KCMC_Record &real(const char *name, double value, int precision, int width = 0);
+        KCMC_Record &bits(const char *name, const int *values, int size);
+        KCMC_Record &bits(const char *name, std::vector<char> values);
+
+        std::vector<KCMC_Field> fields;
+};
+
+
+/* RESULT SINK
+ * Producers push records (and TSV-only header lines) to a lock-free queue, and never block.
+ * The writer thread formats them, and flushes the stream whenever the queue runs empty.
+ * The destructor writes every pending record before it returns
+ */
+struct KCMC_Sink_Node;
+
+class KCMC_Result_Sink {
+    public:
+        KCMC_Result_Sink(std::ostream *out, KCMC_Sink_Format format, KCMC_Encoding encoding = ENCODING_BITS);
+        ~KCMC_Result_Sink();
+
+        void write(KCMC_Record record);
+        void header(const std::string &line);
+
+    private:
+        void push(KCMC_Sink_Node *node);
+        void writer();
+        void format(const KCMC_Record &record);
+
+        std::ostream *out;
+        KCMC_Sink_Format sink_format;
+        KCMC_Encoding encoding;
+        std::atomic<KCMC_Sink_Node*> head;  // Last pushed, by the producers
+        KCMC_Sink_Node *tail;               // Last written, by the writer
+        std::atomic<bool> stopping;
+        std::thread writer_thread;
+};
+
+
+/* RESULTS AND RESULT FLAGS
+ * RESULTS: The sink of the process, writing to STDOUT, started at the first use. It is drained at exit
+ * FLAGS:   Parses the leading --format <tsv|jsonl|binary> and --encoding <bits|delta|rle> flags, in any order, which
+ *          configure the results (before their first use), and returns how many arguments they took (the caller skips
+ *          them)
+ */
+KCMC_Result_Sink &results();
+int result_flags(int argc, char* const argv[]);
+
+#endif
@@ -0,0 +1,157 @@
+/** SOLUTION_ENCODING.cpp
+ * Delta and run-length varints of solutions, wrapped in base64
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <stdexcept>  // runtime_error
+
+// Dependencies from this package
+#include "solution_encoding.h"  // Solution Encoding headers
+
+
+/* #####################################################################################################################
+ * VARINTS AND BASE64
+ * */
+
+
+static const char BASE64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+
+static void put_varint(std::string &buffer, unsigned long long value) {
+    while (value >= 0x80) {
+        buffer.push_back((char)((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back((char)value);
+}
+
+static unsigned long long get_varint(const std::string &buffer, size_t &position) {
+    unsigned long long value = 0;
+    for (int shift=0; shift<64; shift+=7) {
+        if (position >= buffer.size()) {throw std::runtime_error("TRUNCATED SOLUTION ENCODING!");}
+        auto byte = (unsigned char)buffer[position++];
+        value |= ((unsigned long long)(byte & 0x7F)) << shift;
+        if ((byte & 0x80) == 0) {return value;}
+    }
+    throw std::runtime_error("INVALID VARINT IN SOLUTION ENCODING!");
+}
+
+
+static std::string base64_encode(const std::string &bytes) {
+    std::string text;
+    text.reserve(((bytes.size() + 2) / 3) * 4);
+    for (size_t i=0; i<bytes.size(); i+=3) {
+        unsigned int chunk = ((unsigned int)(unsigned char)bytes[i]) << 16;
+        if (i+1 < bytes.size()) {chunk |= ((unsigned int)(unsigned char)bytes[i+1]) << 8;}
+        if (i+2 < bytes.size()) {chunk |= ((unsigned int)(unsigned char)bytes[i+2]);}
+        text.push_back(BASE64[(chunk >> 18) & 0x3F]);
+        text.push_back(BASE64[(chunk >> 12) & 0x3F]);
+        text.push_back((i+1 < bytes.size()) ? BASE64[(chunk >> 6) & 0x3F] : '=');
+        text.push_back((i+2 < bytes.size()) ? BASE64[chunk & 0x3F] : '=');
+    }
+    return text;
+}
+
+static std::string base64_decode(const std::string &text, const size_t start) {
+    std::string bytes;
+    unsigned int chunk = 0;
+    int num_bits = 0;
+    for (size_t i=start; i<text.size(); i++) {
+        char c = text[i];
+        if (c == '=') {break;}
+        int value;
+        if ((c >= 'A') and (c <= 'Z')) {value = c - 'A';}
+        else if ((c >= 'a') and (c <= 'z')) {value = c - 'a' + 26;}
+        else if ((c >= '0') and (c <= '9')) {value = c - '0' + 52;}
+        else if (c == '+') {value = 62;}
+        else if (c == '/') {value = 63;}
+        else {throw std::runtime_error("INVALID BASE64 IN SOLUTION ENCODING!");}
+        chunk = (chunk << 6) | (unsigned int)value;
+        num_bits += 6;
+        if (num_bits >= 8) {
+            num_bits -= 8;
+            bytes.push_back((char)((chunk >> num_bits) & 0xFF));
+        }
+    }
+    return bytes;
+}
+
+
+/* #####################################################################################################################
+ * ENCODINGS
+ * */
+
+
+std::string encode_solution(const std::vector<char> &solution, const KCMC_Encoding encoding) {
+    if (encoding == ENCODING_BITS) {
+        std::string text(solution.size(), '0');
+        for (size_t i=0; i<solution.size(); i++) {text[i] = (char)('0' + solution[i]);}
+        return text;
+    }
+
+    std::string bytes;
+    put_varint(bytes, solution.size());
+    if (encoding == ENCODING_DELTA) {
+        size_t next = 0;  // First sensor after the previous active one
+        for (size_t i=0; i<solution.size(); i++) {
+            if (solution[i]) {put_varint(bytes, i - next); next = i + 1;}
+        }
+        return "D" + base64_encode(bytes);
+    }
+
+    char current = 0;
+    size_t run = 0;
+    for (const char &sensor : solution) {
+        if ((sensor != 0) != (current != 0)) {put_varint(bytes, run); run = 0; current = (char)(not current);}
+        run++;
+    }
+    put_varint(bytes, run);
+    return "R" + base64_encode(bytes);
+}
+
+
+std::vector<char> decode_solution(const std::string &text) {
+    if (text.empty()) {return {};}
+
+    // Plain bits
+    if ((text[0] == '0') or (text[0] == '1')) {
+        std::vector<char> solution(text.size(), 0);
+        for (size_t i=0; i<text.size(); i++) {
+            if ((text[i] != '0') and (text[i] != '1')) {throw std::runtime_error("INVALID BIT IN SOLUTION!");}
+            solution[i] = (char)(text[i] - '0');
+        }
+        return solution;
+    }
+    if ((text[0] != 'D') and (text[0] != 'R')) {throw std::runtime_error("UNKNOWN SOLUTION ENCODING!");}
+
+    std::string bytes = base64_decode(text, 1);
+    size_t position = 0, size = get_varint(bytes, position), sensor = 0;
+    std::vector<char> solution(size, 0);
+    if (text[0] == 'D') {
+        while (position < bytes.size()) {
+            sensor += get_varint(bytes, position);
+            if (sensor >= size) {throw std::runtime_error("SENSOR OUT OF RANGE IN SOLUTION ENCODING!");}
+            solution[sensor++] = 1;
+        }
+    } else {
+        char current = 0;
+        while (position < bytes.size()) {
+            size_t run = get_varint(bytes, position);
+            if (run > size - sensor) {throw std::runtime_error("RUN OUT OF RANGE IN SOLUTION ENCODING!");}
+            for (size_t i=0; i<run; i++) {solution[sensor++] = current;}
+            current = (char)(not current);
+        }
+        if (sensor != size) {throw std::runtime_error("TRUNCATED SOLUTION ENCODING!");}
+    }
+    return solution;
+}
+
+
+KCMC_Encoding parse_encoding(const std::string &name) {
+    if (name == "bits") {return ENCODING_BITS;}
+    if (name == "delta") {return ENCODING_DELTA;}
+    if (name == "rle") {return ENCODING_RLE;}
+    throw std::runtime_error("UNKNOWN SOLUTION ENCODING " + name + "!");
+}
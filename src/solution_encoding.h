@@ -0,0 +1,36 @@
+/** SOLUTION_ENCODING.h
+ * Compact text encodings of solutions (which sensors are active), for the outputs of very large instances
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <string>  // string
+#include <vector>  // vector
+
+
+#ifndef SOLUTION_ENCODING_H
+#define SOLUTION_ENCODING_H
+
+
+/* ENCODINGS
+ * BITS:  A 0/1 character per sensor (the default, num_sensors characters)
+ * DELTA: "D" and the base64 of varints: the number of sensors, then the gaps between the sorted active sensors (the
+ *        index of the first, and then the inactive sensors since the previous one). Best for sparse solutions
+ * RLE:   "R" and the base64 of varints: the number of sensors, then the lengths of the alternating runs of inactive and
+ *        active sensors (starting with inactive, so the first run may be 0). Best for clustered solutions
+ * Varints have 7 bits per byte, lowest first, with the high bit set in every byte but the last
+ */
+enum KCMC_Encoding {ENCODING_BITS, ENCODING_DELTA, ENCODING_RLE};
+
+
+/* ENCODE AND DECODE
+ * ENCODE: The solution (a 0/1 per sensor) as text in the encoding
+ * DECODE: The solution of a text in any encoding, detected by its first character. Throws on malformed texts
+ * PARSE:  The encoding of its name (bits, delta or rle)
+ */
+std::string encode_solution(const std::vector<char> &solution, KCMC_Encoding encoding);
+std::vector<char> decode_solution(const std::string &text);
+KCMC_Encoding parse_encoding(const std::string &name);
+
+#endif
@@ -0,0 +1,184 @@
+/** SWEEP.cpp
+ * Heuristics of a KCMC instance over many (K, M) pairs, sharing the work that does not depend on the pair
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <climits>    // INT_MAX
+#include <algorithm>  // fill
+#include <stdexcept>  // runtime_error
+
+// Dependencies from this package
+#include "sweep.h"  // KCMC Sweep headers
+
+
+/** SWEEP CONSTRUCTOR
+ * Builds the level graph and the coverage structures. Paths are only found when a pair needs them
+ */
+KCMC_Sweep::KCMC_Sweep(KCMC_Instance *instance, std::unordered_set<int> &inactive_sensors) {
+    this->instance = instance;
+    this->inactive_sensors = inactive_sensors;
+    this->num_searched = 0;
+    this->num_reused = 0;
+
+    // Level graph. Sensors that cannot reach a sink are never part of a path
+    this->levels.assign((size_t)instance->num_sensors, instance->num_sensors);
+    this->predecessors.assign((size_t)instance->num_sensors, -2);
+    instance->level_graph(this->levels.data(), this->inactive_sensors);
+
+    // Coverage of each POI, and the initial votes of the flood (each covering sensor, as many POIs as it covers)
+    this->min_coverage = INT_MAX;
+    for (int a_poi=0; a_poi < instance->num_pois; a_poi++) {
+        int active_coverage = 0;
+        for (const int &a_sensor : instance->poi_sensor[a_poi]) {
+            vote(this->coverage_votes, a_sensor, (int)(instance->sensor_poi[a_sensor].size()));
+            if (isin(this->inactive_sensors, a_sensor)) {continue;}
+            this->covering_sensors.insert(a_sensor);
+            active_coverage++;
+        }
+        this->min_coverage = std::min(this->min_coverage, active_coverage);
+    }
+
+    this->paths.resize((size_t)instance->num_pois);
+    this->floods.resize((size_t)instance->num_pois);
+    this->used_sensors.assign((size_t)instance->num_pois, this->inactive_sensors);
+    this->exhausted.assign((size_t)instance->num_pois, 0);
+}
+
+
+/** CACHED PATH
+ * Makes sure the POI has its index-th greedy path, finding the missing ones. Returns false if there is no such path
+ */
+bool KCMC_Sweep::path(const int poi, const int index) {
+    int path_end;
+    if (index < (int)(this->paths[poi].size())) {this->num_reused++; return true;}
+
+    while ((int)(this->paths[poi].size()) <= index) {
+        if (this->exhausted[poi]) {return false;}
+
+        // Find a path, with the sensors of the previous paths as used
+        std::fill(this->predecessors.begin(), this->predecessors.end(), -2);
+        path_end = this->instance->find_path(poi, this->used_sensors[poi], this->levels.data(), this->predecessors.data());
+        if (path_end == -1) {this->exhausted[poi] = 1; return false;}
+        this->num_searched++;
+
+        // Unravel it, from the sink-adjacent sensor back to the covering one
+        std::vector<int> a_path;
+        while (path_end != -1) {
+            this->used_sensors[poi].insert(path_end);
+            a_path.push_back(path_end);
+            path_end = this->predecessors[path_end];
+            if (path_end == -2) {throw std::runtime_error("FORBIDDEN ADDRESS!");}
+        }
+
+        // Store it, with the votes of its flood
+        std::unordered_map<int, int> votes;
+        this->instance->flood_path(poi, a_path, this->inactive_sensors, &votes);
+        this->floods[poi].emplace_back(votes.begin(), votes.end());
+        this->paths[poi].push_back(a_path);
+    }
+    return true;
+}
+
+
+/* #####################################################################################################################
+ * HEURISTICS
+ * Each one follows the KCMC_Instance method of the same name, reading the cached paths
+ */
+
+
+int KCMC_Sweep::fast_m_connectivity(const int m, std::unordered_map<int, int> *all_used_sensors) {
+    int total_paths_found = 0;
+    all_used_sensors->clear();
+    if (m < 1){return -1;}
+
+    for (int a_poi=0; a_poi < this->instance->num_pois; a_poi++) {
+        for (int paths_found=0; paths_found < m; paths_found++) {
+            if (not this->path(a_poi, paths_found)) {return ((1+a_poi)*1000000)+paths_found;}
+            total_paths_found++;
+            for (const int &a_sensor : this->paths[a_poi][paths_found]) {vote(*all_used_sensors, a_sensor);}
+        }
+    }
+    return total_paths_found;
+}
+
+
+int KCMC_Sweep::local_optima(const int k, const int m, std::unordered_set<int> *all_used_sensors) {
+    std::unordered_map<int, int> m_used_sensors;
+
+    // Same checks (and errors) of the validation in safe mode
+    if ((k >= 1) and (this->min_coverage < k)) {throw std::runtime_error("INVALID INSTANCE! (INSUFFICIENT COVERAGE)");}
+    int valid = this->fast_m_connectivity(m, &m_used_sensors);
+    if (valid >= 1000000) {throw std::runtime_error("INVALID INSTANCE! (INSUFFICIENT CONNECTIVITY)");}
+
+    all_used_sensors->clear();
+    if (k >= 1) {*all_used_sensors = this->covering_sensors;}
+    for (const auto &i : m_used_sensors) {all_used_sensors->insert(i.first);}
+    return this->instance->num_sensors - ((int)all_used_sensors->size());
+}
+
+
+int KCMC_Sweep::flood(const int k, const int m, const bool full, std::unordered_map<int, int> *visited_sensors) {
+    int paths_found, path_length, longest_required_path_length, total_paths_found = 0;
+    if (m < 1){return -1;}
+    if ((k >= 1) and (this->min_coverage < k)) {throw std::runtime_error("INVALID INSTANCE! (INSUFFICIENT COVERAGE)");}
+
+    *visited_sensors = this->coverage_votes;
+    for (int a_poi=0; a_poi < this->instance->num_pois; a_poi++) {
+        longest_required_path_length = 0;
+        for (paths_found=0; ; paths_found++) {
+            if (not this->path(a_poi, paths_found)) {
+                if (paths_found < m) { throw std::runtime_error("INVALID INSTANCE! (INSUFFICIENT CONNECTIVITY)"); }
+                break;
+            }
+            total_paths_found++;
+            for (const auto &a_vote : this->floods[a_poi][paths_found]) {vote(*visited_sensors, a_vote.first, a_vote.second);}
+
+            // Same stopping criteria of the flood, with paths_found+1 paths
+            path_length = (int)(this->paths[a_poi][paths_found].size());
+            if (full) {
+                if (paths_found+1 <= m) {longest_required_path_length = std::max(longest_required_path_length, path_length);}
+                if (path_length > longest_required_path_length) {break;}
+            } else if (paths_found+1 == m) {break;}
+        }
+    }
+    return total_paths_found;
+}
+
+
+int KCMC_Sweep::reuse(const int k, const int m, const int flood_level, std::unordered_map<int, int> *visited_sensors) {
+    int num_paths;
+    visited_sensors->clear();
+    if (flood_level == 0) {num_paths = this->fast_m_connectivity(m, visited_sensors);}
+    else {num_paths = this->flood(k, m, (flood_level < 0), visited_sensors);}
+    if (num_paths >= 1000000) {throw std::runtime_error("INVALID NUMBER OF PATHS!");}
+
+    // The second stage depends on the votes, thus on the pair
+    return this->instance->reuse_votes(k, m, num_paths, this->inactive_sensors, visited_sensors);
+}
+
+
+int KCMC_Sweep::reuse(const int k, const int m, std::unordered_map<int, int> *visited_sensors) {
+    return best_reuse([&](const int flood_level, std::unordered_map<int, int> *variant_visited) {
+        return this->reuse(k, m, flood_level, variant_visited);
+    }, visited_sensors);
+}
+
+
+int KCMC_Sweep::heuristic(const std::string &name, const int k, const int m, std::unordered_set<int> *used_sensors) {
+    std::unordered_map<int, int> visited_sensors;
+    int result = 0;
+
+    if (name == "dinic") {this->local_optima(k, m, used_sensors); return 0;}
+    else if (name == "min_flood")  {result = this->flood(k, m, false, &visited_sensors);}
+    else if (name == "max_flood")  {result = this->flood(k, m, true, &visited_sensors);}
+    else if (name == "no_reuse")   {result = this->reuse(k, m, 0, &visited_sensors);}
+    else if (name == "min_reuse")  {result = this->reuse(k, m, 1, &visited_sensors);}
+    else if (name == "max_reuse")  {result = this->reuse(k, m, -1, &visited_sensors);}
+    else if (name == "best_reuse") {result = this->reuse(k, m, &visited_sensors);}
+    else {throw std::runtime_error("UNKNOWN HEURISTIC " + name);}
+
+    setify(*used_sensors, &visited_sensors);
+    return result;
+}
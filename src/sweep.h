@@ -0,0 +1,62 @@
+/** SWEEP.h
+ * Heuristics of a KCMC instance over many (K, M) pairs, sharing the work that does not depend on the pair
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <vector>         // vector object
+#include <unordered_set>  // unordered_set object
+#include <unordered_map>  // unordered_map HashMap object
+
+// Dependencies from this package
+#include "kcmc_instance.h"  // KCMC Instance class headers
+
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+
+/** KCMC Sweep Object
+ * The level graph, the coverage of the POIs and the greedy paths of each POI depend only on the inactive sensors. The
+ *   i-th path of a POI is found with the sensors of the previous i-1 paths as used, so the paths for M are a prefix of
+ *   the paths for M+1 (and the max-flood stops later for larger M). Paths, and their floods, are found once, on demand.
+ * Results are the same of the KCMC_Instance methods of the same names. Only the pair-dependent work is redone
+ */
+class KCMC_Sweep {
+
+    public:
+        KCMC_Instance *instance;
+        std::unordered_set<int> inactive_sensors;
+
+        /* Statistics
+         * Number of greedy paths found (all POIs), and of cached paths read instead of searched again
+         */
+        long long num_searched, num_reused;
+
+        KCMC_Sweep(KCMC_Instance *instance, std::unordered_set<int> &inactive_sensors);
+
+        /* Heuristics
+         * Same as in KCMC_Instance, on the inactive sensors of the sweep
+         */
+        int fast_m_connectivity(int m, std::unordered_map<int, int> *all_used_sensors);
+        int local_optima(int k, int m, std::unordered_set<int> *all_used_sensors);
+        int flood(int k, int m, bool full, std::unordered_map<int, int> *visited_sensors);
+        int reuse(int k, int m, int flood_level, std::unordered_map<int, int> *visited_sensors);
+        int reuse(int k, int m, std::unordered_map<int, int> *visited_sensors);
+        int heuristic(const std::string &name, int k, int m, std::unordered_set<int> *used_sensors);
+
+    private:
+        int min_coverage;
+        std::vector<int> levels, predecessors;
+        std::unordered_set<int> covering_sensors;        // Active sensors covering any POI
+        std::unordered_map<int, int> coverage_votes;     // Initial votes of the flood
+        std::vector<std::vector<std::vector<int>>> paths;                   // Paths of each POI, in order of discovery
+        std::vector<std::vector<std::vector<std::pair<int, int>>>> floods;  // Votes of the flood of each path
+        std::vector<std::unordered_set<int>> used_sensors;                  // Inactive sensors and paths of each POI
+        std::vector<char> exhausted;                                        // POIs without any further path
+
+        bool path(int poi, int index);
+};
+
+#endif
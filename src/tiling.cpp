@@ -0,0 +1,145 @@
+/** TILING.cpp
+ * Overlapping tiles of a KCMC instance, their heuristics and the repair of the stitched solution
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <algorithm>  // min, max
+#include <limits>     // numeric_limits
+#include <utility>    // pair
+#include <stdexcept>  // runtime_error
+
+// Dependencies from this package
+#include "tiling.h"  // KCMC Tiling headers
+
+
+/** TILING CONSTRUCTOR
+ * Placements are bucketed by tile (sensors in every tile whose extended area holds them), so building the tiles is
+ *   linear in the size of the instance. Tiles are built in parallel
+ */
+KCMC_Tiling::KCMC_Tiling(KCMC_Instance *instance, KCMC_Graph *graph, const int tiles_per_side, const int margin) {
+    if (tiles_per_side < 1) {throw std::runtime_error("TILINGS NEED AT LEAST ONE TILE PER SIDE!");}
+    this->instance = instance;
+    this->graph = graph;
+    this->tiles_per_side = tiles_per_side;
+    this->margin = margin;
+    const int n = tiles_per_side, num_tiles = n * n;
+
+    // Placements, and the distance of each sensor to its closest sink
+    std::vector<Placement> pl_pois((size_t)instance->num_pois), pl_sensors((size_t)instance->num_sensors),
+                           pl_sinks((size_t)instance->num_sinks);
+    instance->get_placements(pl_pois.data(), pl_sensors.data(), pl_sinks.data());
+    std::vector<double> sink_distance((size_t)instance->num_sensors, std::numeric_limits<double>::max());
+    for (int sensor=0; sensor<instance->num_sensors; sensor++) {
+        for (const Placement &a_sink : pl_sinks) {
+            sink_distance[sensor] = std::min(sink_distance[sensor], distance(pl_sensors[sensor], a_sink));
+        }
+    }
+
+    // Tile of a coordinate, and whether a sensor is in the extended area of a tile
+    auto cell = [&](const int coordinate) {
+        return std::min(std::max((int)(((long long)coordinate * n) / instance->area_side), 0), n - 1);
+    };
+    auto in_tile = [&](const int sensor, const int tile) {
+        const int x = tile % n, y = tile / n;
+        const Placement &place = pl_sensors[sensor];
+        return (cell(place.x - margin) <= x) and (x <= cell(place.x + margin))
+               and (cell(place.y - margin) <= y) and (y <= cell(place.y + margin));
+    };
+
+    std::vector<std::vector<int>> tile_pois((size_t)num_tiles), tile_sensors((size_t)num_tiles);
+    for (int poi=0; poi<instance->num_pois; poi++) {
+        tile_pois[(cell(pl_pois[poi].y) * n) + cell(pl_pois[poi].x)].push_back(poi);
+    }
+    for (int sensor=0; sensor<instance->num_sensors; sensor++) {
+        const Placement &place = pl_sensors[sensor];
+        for (int y=cell(place.y - margin); y<=cell(place.y + margin); y++) {
+            for (int x=cell(place.x - margin); x<=cell(place.x + margin); x++) {tile_sensors[(y * n) + x].push_back(sensor);}
+        }
+    }
+
+    // Sub-instance of each tile
+    this->tiles.assign((size_t)num_tiles, nullptr);
+    this->sensor_maps = tile_sensors;
+    parallel_chunks(num_tiles, [&](const int begin, const int end) {
+        for (int t=begin; t<end; t++) {
+            std::vector<char> gateways(tile_sensors[t].size(), 0);
+            for (size_t i=0; i<tile_sensors[t].size(); i++) {
+                const int sensor = tile_sensors[t][i];
+                for (int j=graph->sensor_sensor.offsets[sensor]; j<graph->sensor_sensor.offsets[sensor+1]; j++) {
+                    const int neighbor = graph->sensor_sensor.targets[j];
+                    if ((not in_tile(neighbor, t)) and (sink_distance[neighbor] < sink_distance[sensor])) {
+                        gateways[i] = 1;
+                        break;
+                    }
+                }
+            }
+            this->tiles[t] = this->tile(tile_pois[t], tile_sensors[t], gateways);
+        }
+    });
+
+    this->num_solved_tiles = 0;
+    for (const KCMC_Instance *a_tile : this->tiles) {if (a_tile != nullptr) {this->num_solved_tiles++;}}
+    this->num_repaired = 0;
+}
+
+KCMC_Tiling::~KCMC_Tiling() {
+    for (KCMC_Instance *a_tile : this->tiles) {delete a_tile;}
+}
+
+
+/** TILE
+ * Sub-instance of the POIs and sensors (renumbered by their position), with the sinks next to the sensors and the
+ *   virtual sink (the last one) next to the gateways. Null without POIs or sinks
+ */
+KCMC_Instance *KCMC_Tiling::tile(const std::vector<int> &pois, const std::vector<int> &sensors,
+                                 const std::vector<char> &gateways) {
+    const KCMC_Graph &g = *this->graph;
+    std::vector<int> sinks;
+    std::unordered_set<int> seen_sinks;
+    std::vector<std::pair<int, int>> gateway_edges;
+    for (int i=0; i<(int)(sensors.size()); i++) {
+        for (int j=g.sensor_sink.offsets[sensors[i]]; j<g.sensor_sink.offsets[sensors[i]+1]; j++) {
+            if (seen_sinks.insert(g.sensor_sink.targets[j]).second) {sinks.push_back(g.sensor_sink.targets[j]);}
+        }
+    }
+    const int virtual_sink = (int)(sinks.size());
+    for (int i=0; i<(int)(sensors.size()); i++) {if (gateways[i]) {gateway_edges.emplace_back(i, virtual_sink);}}
+    if (pois.empty() or (sinks.empty() and gateway_edges.empty())) {return nullptr;}
+    return this->instance->subinstance(pois, sensors, sinks, (int)(sensors.size()), gateway_edges);
+}
+
+
+/** HEURISTIC
+ * Each tile runs in a single thread, and only writes its own solution
+ */
+int KCMC_Tiling::heuristic(const std::string &name, const int k, const int m, std::unordered_set<int> *used_sensors) {
+    std::vector<std::unordered_set<int>> solutions(this->tiles.size());
+    parallel_chunks((int)(this->tiles.size()), [&](const int begin, const int end) {
+        std::unordered_set<int> emptyset;
+        for (int t=begin; t<end; t++) {
+            if (this->tiles[t] == nullptr) {continue;}
+            KCMC_TRACE("tile", "tile", t);
+            try {this->tiles[t]->heuristic(name, k, m, emptyset, &solutions[t]);}
+            catch (const std::exception &exc) {solutions[t].clear();}
+        }
+    });
+
+    // Stitch the solutions of the tiles, and repair what they miss
+    std::vector<char> active((size_t)this->instance->num_sensors, 0);
+    for (size_t t=0; t<this->tiles.size(); t++) {
+        for (const int &sensor : solutions[t]) {active[this->sensor_maps[t][sensor]] = 1;}
+    }
+    {
+        KCMC_TRACE("tiling_repair");
+        this->num_repaired = this->graph->repair(k, m, &active);
+        this->num_repaired += this->instance->repair_deficits(k, m, &active);
+    }
+
+    used_sensors->clear();
+    for (int sensor=0; sensor<this->instance->num_sensors; sensor++) {
+        if (active[sensor]) {used_sensors->insert(sensor);}
+    }
+    return this->num_repaired;
+}
@@ -0,0 +1,62 @@
+/** TILING.h
+ * Spatial decomposition of large KCMC instances in overlapping tiles, solved independently and stitched together
+ * Jose F. R. Fonseca
+ */
+
+
+// STDLib dependencies
+#include <string>         // string
+#include <vector>         // vector object
+#include <unordered_set>  // unordered_set object
+
+// Dependencies from this package
+#include "kcmc_instance.h"  // KCMC Instance class headers
+#include "kcmc_graph.h"     // Repair of the stitched solution
+
+
+#ifndef TILING_H
+#define TILING_H
+
+
+/** KCMC Tiling Object
+ * Coverage and short paths are local, so the area is split in a grid of tiles, each with the POIs placed in its core
+ *   and the sensors placed in its core extended by the margin (the tiles overlap). Each tile is a sub-instance with
+ *   the real sinks next to its sensors and, if it has GATEWAYS, a virtual sink: the sensors of the tile with a
+ *   neighbor outside of it that is closer to a sink. Paths to the virtual sink are the boundary link to the sink
+ *   region, continued by the tiles (or the repair) between the tile and the sink.
+ * Heuristics run on every tile in parallel. The solutions of the tiles are mapped back and stitched (their union),
+ *   the graph repair adds the sensors still missing for K-coverage and M-connectivity of every POI, and the deficit
+ *   repair the paths the validators need (their greedy paths may miss some of the exact ones).
+ * Tiles need the placements of the instance, so it must be regenerated from its key (NOT a sub-instance or presolved)
+ */
+class KCMC_Tiling {
+
+    public:
+        int tiles_per_side, margin;
+
+        /* Statistics
+         * Tiles with a sub-instance (with POIs and a sink), and sensors added by the repair of the last heuristic
+         */
+        int num_solved_tiles, num_repaired;
+
+        KCMC_Tiling(KCMC_Instance *instance, KCMC_Graph *graph, int tiles_per_side, int margin);
+        ~KCMC_Tiling();
+
+        /* Heuristic
+         * Runs the heuristic (by its name, as in KCMC_Instance) on every tile, and repairs the stitched solution.
+         * Tiles where the heuristic fails contribute no sensors (the repair covers their POIs).
+         * Returns the number of sensors added by the repair
+         */
+        int heuristic(const std::string &name, int k, int m, std::unordered_set<int> *used_sensors);
+
+    private:
+        KCMC_Instance *instance;
+        KCMC_Graph *graph;
+        std::vector<KCMC_Instance*> tiles;          // Null if the tile has no POIs or no sink
+        std::vector<std::vector<int>> sensor_maps;  // Sensor i of tile t is sensor sensor_maps[t][i] of the instance
+
+        KCMC_Instance *tile(const std::vector<int> &pois, const std::vector<int> &sensors,
+                            const std::vector<char> &gateways);
+};
+
+#endif